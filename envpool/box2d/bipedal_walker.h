@@ -70,6 +70,14 @@ class BipedalWalkerEnv : public Env<BipedalWalkerEnvSpec>,
     WriteState();
   }
 
+  void Serialize(ByteWriter* writer) override {
+    BipedalWalkerSerialize(writer);
+  }
+
+  void Deserialize(ByteReader* reader) override {
+    BipedalWalkerDeserialize(reader);
+  }
+
  private:
   void WriteState() {
     State state = Allocate();
@@ -15,6 +15,7 @@
 #include "envpool/box2d/bipedal_walker_env.h"
 
 #include <algorithm>
+#include <stdexcept>
 
 #include "envpool/box2d/utils.h"
 
@@ -419,4 +420,40 @@ void BipedalWalkerBox2dEnv::BipedalWalkerStep(std::mt19937* gen, float action0,
   StepBox2d(gen, action0, action1, action2, action3);
 }
 
+void BipedalWalkerBox2dEnv::BipedalWalkerSerialize(ByteWriter* writer) {
+  if (hull_ == nullptr) {
+    throw std::runtime_error("Env must be reset before snapshot/restore.");
+  }
+  writer->Write(ShapeFingerprint(terrain_));
+  writer->Write(elapsed_step_);
+  writer->Write(reward_);
+  writer->Write(prev_shaping_);
+  writer->Write(done_);
+  writer->Write(obs_);
+  writer->Write(scroll_);
+  writer->Write(ground_contact_);
+  SerializeBody(hull_, writer);
+  for (auto* l : legs_) {
+    SerializeBody(l, writer);
+  }
+}
+
+void BipedalWalkerBox2dEnv::BipedalWalkerDeserialize(ByteReader* reader) {
+  if (hull_ == nullptr) {
+    throw std::runtime_error("Env must be reset before snapshot/restore.");
+  }
+  CheckFingerprint(reader, ShapeFingerprint(terrain_));
+  reader->Read(&elapsed_step_);
+  reader->Read(&reward_);
+  reader->Read(&prev_shaping_);
+  reader->Read(&done_);
+  reader->Read(&obs_);
+  reader->Read(&scroll_);
+  reader->Read(&ground_contact_);
+  DeserializeBody(hull_, reader);
+  for (auto* l : legs_) {
+    DeserializeBody(l, reader);
+  }
+}
+
 }  // namespace box2d
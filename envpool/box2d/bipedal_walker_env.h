@@ -25,6 +25,8 @@
 #include <random>
 #include <vector>
 
+#include "envpool/core/serialization.h"
+
 namespace box2d {
 
 class BipedalWalkerContactDetector;
@@ -97,6 +99,10 @@ class BipedalWalkerBox2dEnv {
   void BipedalWalkerReset(std::mt19937* gen);
   void BipedalWalkerStep(std::mt19937* gen, float action0, float action1,
                          float action2, float action3);
+  // snapshots hold a fingerprint of the terrain instead of the terrain, and
+  // restoring one after a reset onto different terrain throws
+  void BipedalWalkerSerialize(ByteWriter* writer);
+  void BipedalWalkerDeserialize(ByteReader* reader);
 
  private:
   void ResetBox2d(std::mt19937* gen);
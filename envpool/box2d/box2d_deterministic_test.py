@@ -19,6 +19,7 @@ import numpy as np
 from absl.testing import absltest
 
 import envpool.box2d.registration  # noqa: F401
+from envpool.python.testing import check_snapshot_restore
 from envpool.registration import make_gym
 
 
@@ -42,6 +43,34 @@ class _Box2dEnvPoolDeterministicTest(absltest.TestCase):
       np.testing.assert_allclose(obs0, obs1)
       self.assertFalse(np.allclose(obs0, obs2))
 
+  def run_snapshot_check(
+    self,
+    task_id: str,
+    actions: np.ndarray,
+    atol: float = 0.0,
+    num_envs: int = 4,
+  ) -> None:
+    env = make_gym(task_id, num_envs=num_envs, seed=0)
+    env.reset()
+    env.step(actions[0])
+    check_snapshot_restore(env, actions, atol=atol)
+    # after a reset the terrain is a new one, which the snapshots refuse
+    short = make_gym(task_id, num_envs=num_envs, seed=0, max_episode_steps=3)
+    short.reset()
+    snapshots = short.snapshot()
+    for a in actions[:5]:
+      short.step(a)
+    with self.assertRaises(RuntimeError):
+      short.restore(snapshots)
+
+  def test_snapshot_restore(self) -> None:
+    # no engine fires, so the lander falls freely and no particle is made
+    self.run_snapshot_check("LunarLander-v2", np.zeros((10, 4), np.int32))
+    # the legs touch the ground, whose contacts are not part of a snapshot
+    self.run_snapshot_check(
+      "BipedalWalkerHardcore-v3", np.zeros((10, 4, 4)), atol=1e-3
+    )
+
   def test_car_racing(self) -> None:
     self.run_deterministic_check("CarRacing-v2")
     self.run_deterministic_check("CarRacing-v2", max_episode_steps=3)
@@ -49,10 +78,15 @@ class _Box2dEnvPoolDeterministicTest(absltest.TestCase):
   def test_bipedal_walker(self) -> None:
     self.run_deterministic_check("BipedalWalker-v3")
     self.run_deterministic_check("BipedalWalkerHardcore-v3")
+    # many resets, which reuse the bodies of the previous episodes
+    self.run_deterministic_check(
+      "BipedalWalkerHardcore-v3", max_episode_steps=3
+    )
 
   def test_lunar_lander(self) -> None:
     self.run_deterministic_check("LunarLanderContinuous-v2")
     self.run_deterministic_check("LunarLander-v2")
+    self.run_deterministic_check("LunarLander-v2", max_episode_steps=3)
 
 
 if __name__ == "__main__":
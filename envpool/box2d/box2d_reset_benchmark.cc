@@ -0,0 +1,65 @@
+// Copyright 2023 Garena Online Private Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures the time of one reset of every Box2D task, i.e. generating the
+// terrain or track, putting the bodies in place and the first step (which
+// renders the first frame for CarRacing), averaged over `num_resets` resets
+// of the same env.
+//
+// Usage: box2d_reset_benchmark [num_resets]
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "envpool/box2d/bipedal_walker_env.h"
+#include "envpool/box2d/car_racing_env.h"
+#include "envpool/box2d/lunar_lander_env.h"
+
+template <typename Reset>
+void Measure(const std::string& name, int num_resets, Reset reset) {
+  std::mt19937 gen(0);
+  // the first reset has no previous episode to clean up
+  reset(&gen);
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < num_resets; ++i) {
+    reset(&gen);
+  }
+  std::chrono::duration<double, std::micro> elapsed =
+      std::chrono::steady_clock::now() - start;
+  std::cout << std::left << std::setw(24) << name << std::right << std::fixed
+            << std::setprecision(1) << std::setw(12)
+            << elapsed.count() / num_resets << std::endl;
+}
+
+int main(int argc, char** argv) {
+  const int num_resets = argc > 1 ? std::stoi(argv[1]) : 1000;
+  std::cout << std::left << std::setw(24) << "task" << std::right
+            << std::setw(12) << "us/reset" << std::endl;
+  box2d::CarRacingBox2dEnv car_racing(1000, 0.95);
+  Measure("CarRacing", num_resets,
+          [&](std::mt19937* gen) { car_racing.CarRacingReset(gen); });
+  box2d::LunarLanderBox2dEnv lunar_lander(false, 1000);
+  Measure("LunarLander", num_resets,
+          [&](std::mt19937* gen) { lunar_lander.LunarLanderReset(gen); });
+  box2d::BipedalWalkerBox2dEnv bipedal_walker(false, 1600);
+  Measure("BipedalWalker", num_resets,
+          [&](std::mt19937* gen) { bipedal_walker.BipedalWalkerReset(gen); });
+  box2d::BipedalWalkerBox2dEnv hardcore(true, 2000);
+  Measure("BipedalWalkerHardcore", num_resets,
+          [&](std::mt19937* gen) { hardcore.BipedalWalkerReset(gen); });
+  return 0;
+}
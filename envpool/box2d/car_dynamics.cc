@@ -226,7 +226,7 @@ std::shared_ptr<Particle> Car::CreateParticle(b2Vec2 point1, b2Vec2 point2,
   return p;
 }
 
-void Car::Draw(const cv::Mat& surf, float zoom,
+void Car::Draw(Rasterizer* rasterizer, float zoom,
                const std::array<float, 2>& translation, float angle,
                bool draw_particles) {
   if (draw_particles) {
@@ -238,7 +238,7 @@ void Car::Draw(const cv::Mat& surf, float zoom,
         poly.emplace_back(cv::Point(v.x * zoom + translation[0],
                                     v.y * zoom + translation[1]));
       }
-      cv::polylines(surf, poly, false, p->color, 2);
+      rasterizer->Polylines(poly, 2, p->color);
     }
   }
   for (size_t i = 0; i < drawlist_.size(); i++) {
@@ -261,7 +261,7 @@ void Car::Draw(const cv::Mat& surf, float zoom,
         poly.emplace_back(cv::Point(v.x * zoom + translation[0],
                                     v.y * zoom + translation[1]));
       }
-      cv::fillPoly(surf, poly, color);
+      rasterizer->FillConvexPoly(poly, color);
 
       auto* user_data =
           reinterpret_cast<UserData*>(body->GetUserData().pointer);  // NOLINT
@@ -299,7 +299,7 @@ void Car::Draw(const cv::Mat& surf, float zoom,
         poly.emplace_back(cv::Point(v.x * zoom + translation[0],
                                     v.y * zoom + translation[1]));
       }
-      cv::fillPoly(surf, poly, kWheelWhite);
+      rasterizer->FillConvexPoly(poly, kWheelWhite);
     }
   }
 }
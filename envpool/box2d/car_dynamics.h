@@ -30,6 +30,7 @@
 #include <vector>
 
 #include "opencv2/opencv.hpp"
+#include "rasterizer.h"
 #include "utils.h"
 
 namespace box2d {
@@ -125,7 +126,7 @@ class Car {
   void Brake(float b);
   void Steer(float s);
   void Step(float dt);
-  void Draw(const cv::Mat& surf, float zoom,
+  void Draw(Rasterizer* rasterizer, float zoom,
             const std::array<float, 2>& translation, float angle,
             bool draw_particles = true);
   void Destroy();
@@ -75,8 +75,7 @@ class CarRacingEnv : public Env<CarRacingEnvSpec>, public CarRacingBox2dEnv {
   void WriteState() {
     State state = Allocate();
     state["reward"_] = step_reward_;
-    CreateImageArray();
-    state["obs"_].Assign(img_array_.data, 96 * 96 * 3);
+    WriteImage(static_cast<uint8_t*>(state["obs"_].Data()));
 #ifdef ENVPOOL_TEST
     state["info:tile_visited_count"_] = tile_visited_count_;
     state["info:car_fuel_spent"_] = car_->GetFuelSpent();
@@ -84,6 +84,8 @@ CarRacingBox2dEnv::CarRacingBox2dEnv(int max_episode_steps,
     : lap_complete_percent_(lap_complete_percent),
       max_episode_steps_(max_episode_steps),
       elapsed_step_(max_episode_steps + 1),
+      rasterizer_(kWindowW, kWindowH, kStateW, kStateH),
+      text_(kWindowH / 40 * 5, kWindowW / 40 * 5, CV_8UC3),
       world_(new b2World(b2Vec2(0.0, 0.0))) {
   b2PolygonShape shape;
   std::array<b2Vec2, 4> vertices = {b2Vec2(0, 0), b2Vec2(1, 0), b2Vec2(1, -1),
@@ -354,6 +356,7 @@ void CarRacingBox2dEnv::ResetBox2d(std::mt19937* gen) {
   while (!success) {
     success = CreateTrack(gen);
   }
+  CreateBackground();
   car_ =
       std::make_unique<Car>(world_, track_[0][1], track_[0][2], track_[0][3]);
 }
@@ -412,11 +415,8 @@ void CarRacingBox2dEnv::StepBox2d(std::mt19937* gen, float action0,
   Render();
 }
 
-void CarRacingBox2dEnv::CreateImageArray() {
-  // cv::resize(surf_, img_array_, cv::Size(kStateW, kStateH), 0, 0,
-  // cv::INTER_AREA);
-  cv::resize(surf_, img_array_, cv::Size(kStateW, kStateH));
-  cv::cvtColor(img_array_, img_array_, cv::COLOR_BGR2RGB);
+void CarRacingBox2dEnv::WriteImage(uint8_t* rgb) const {
+  rasterizer_.Resolve(rgb);
 }
 
 void CarRacingBox2dEnv::DrawColoredPolygon(
@@ -430,12 +430,12 @@ void CarRacingBox2dEnv::DrawColoredPolygon(
   // diagonal length of an environment object
 
   bool exist = false;
-  std::vector<cv::Point> poly;
-  for (const auto& f : field) {
-    auto f_roated = RotateRad(f, angle);
+  std::array<cv::Point, 4> poly;
+  for (std::size_t i = 0; i < field.size(); ++i) {
+    auto f_roated = RotateRad(field[i], angle);
     f_roated = {f_roated[0] * zoom + translation[0],
                 f_roated[1] * zoom + translation[1]};
-    poly.emplace_back(cv::Point(f_roated[0], f_roated[1]));
+    poly[i] = cv::Point(f_roated[0], f_roated[1]);
     if (-kMaxShapeDim <= f_roated[0] &&
         f_roated[0] <= static_cast<float>(kWindowW) + kMaxShapeDim &&
         -kMaxShapeDim <= f_roated[1] &&
@@ -445,24 +445,35 @@ void CarRacingBox2dEnv::DrawColoredPolygon(
   }
 
   if (!clip || exist) {
-    cv::fillPoly(surf_, poly, color);
+    rasterizer_.FillConvexPoly(poly.data(), poly.size(), color);
   }
 }
 
-void CarRacingBox2dEnv::RenderRoad(float zoom,
-                                   const std::array<float, 2>& translation,
-                                   float angle) {
+void CarRacingBox2dEnv::CreateBackground() {
+  background_.clear();
+  auto add = [this](const std::array<std::array<float, 2>, 4>& field,
+                    const cv::Scalar& color, bool clip) {
+    std::array<float, 2> center = {0, 0};
+    for (const auto& p : field) {
+      center = {center[0] + p[0] / 4, center[1] + p[1] / 4};
+    }
+    float radius = 0;
+    for (const auto& p : field) {
+      radius = std::max(radius, std::hypot(p[0] - center[0], p[1] - center[1]));
+    }
+    background_.push_back({field, color, center, radius, clip});
+  };
+
   std::array<std::array<float, 2>, 4> field;
   field[0] = {kPlayfiled, kPlayfiled};
   field[1] = {kPlayfiled, -kPlayfiled};
   field[2] = {-kPlayfiled, -kPlayfiled};
   field[3] = {-kPlayfiled, kPlayfiled};
 
-  // draw background
-  DrawColoredPolygon(field, kBgColor, zoom, translation, angle, false);
+  // background
+  add(field, kBgColor, false);
 
-  // draw grass patches
-  std::vector<std::array<std::array<float, 2>, 4>> grass;
+  // grass patches
   for (int x = -20; x < 20; x += 2) {
     auto fx = static_cast<float>(x);
     for (int y = -20; y < 20; y += 2) {
@@ -472,19 +483,46 @@ void CarRacingBox2dEnv::RenderRoad(float zoom,
       grass[1] = {kGrassDim * fx, kGrassDim * fy};
       grass[2] = {kGrassDim * fx, kGrassDim * fy + kGrassDim};
       grass[3] = {kGrassDim * fx + kGrassDim, kGrassDim * fy + kGrassDim};
-      DrawColoredPolygon(grass, kGrassColor, zoom, translation, angle);
+      add(grass, kGrassColor, true);
     }
   }
 
-  // draw road
-  for (auto& [poly, color] : roads_poly_) {
-    std::array<std::array<float, 2>, 4> field;
+  // road
+  for (const auto& [poly, color] : roads_poly_) {
     field[0] = {poly[0].x, poly[0].y};
     field[1] = {poly[1].x, poly[1].y};
     field[2] = {poly[2].x, poly[2].y};
     field[3] = {poly[3].x, poly[3].y};
+    add(field, color, true);
+  }
+}
 
-    DrawColoredPolygon(field, color, zoom, translation, angle);
+void CarRacingBox2dEnv::RenderRoad(float zoom,
+                                   const std::array<float, 2>& translation,
+                                   float angle) {
+  // Every point DrawColoredPolygon keeps, the window grown by kMaxShapeDim,
+  // comes from a world point within view_radius of view_center. Polygons whose
+  // circle does not reach that one are skipped, the others go through the
+  // same test as before, so the frame is unchanged.
+  float half_w = static_cast<float>(kWindowW) / 2 + kMaxShapeDim;
+  float half_h = static_cast<float>(kWindowH) / 2 + kMaxShapeDim;
+  // one world unit more against rounding
+  float view_radius = std::hypot(half_w, half_h) / zoom + 1;
+  std::array<float, 2> view_center = {
+      (static_cast<float>(kWindowW) / 2 - translation[0]) / zoom,
+      (static_cast<float>(kWindowH) / 2 - translation[1]) / zoom};
+  view_center = RotateRad(view_center, -angle);
+  for (const auto& poly : background_) {
+    if (poly.clip) {
+      float dx = poly.center[0] - view_center[0];
+      float dy = poly.center[1] - view_center[1];
+      float reach = view_radius + poly.radius;
+      if (dx * dx + dy * dy > reach * reach) {
+        continue;
+      }
+    }
+    DrawColoredPolygon(poly.field, poly.color, zoom, translation, angle,
+                       poly.clip);
   }
 }
 
@@ -515,7 +553,7 @@ void CarRacingBox2dEnv::RenderIfMin(float value,
                                     const std::vector<cv::Point>& points,
                                     const cv::Scalar& color) {
   if (abs(value) > 1e-4) {
-    cv::fillPoly(surf_, points, color);
+    rasterizer_.FillConvexPoly(points, color);
   }
 }
 
@@ -525,7 +563,7 @@ void CarRacingBox2dEnv::RenderIndicators() {
   std::vector<cv::Point> poly = {
       cv::Point(kWindowW, kWindowH), cv::Point(kWindowW, kWindowH - 5 * h),
       cv::Point(0, kWindowH - 5 * h), cv::Point(0, kWindowH)};
-  cv::fillPoly(surf_, poly, cv::Scalar(0, 0, 0));
+  rasterizer_.FillConvexPoly(poly, cv::Scalar(0, 0, 0));
 
   assert(car_ != nullptr);
 
@@ -561,7 +599,7 @@ void CarRacingBox2dEnv::RenderIndicators() {
 void CarRacingBox2dEnv::Render() {
   // render mode == "state_pixels"
   cv::Scalar black(0, 0, 0);
-  surf_ = cv::Mat(kWindowH, kWindowW, CV_8UC3, black);
+  rasterizer_.Clear(black);
 
   assert(car_ != nullptr);
   // computing transformations
@@ -577,16 +615,21 @@ void CarRacingBox2dEnv::Render() {
   trans = {static_cast<float>(kWindowW) / 2.0f + trans[0],
            static_cast<float>(kWindowH) / 4.0f + trans[1]};
 
+  // the scene is drawn upside down, then the window is flipped
+  rasterizer_.SetFlipY(true);
   RenderRoad(zoom, trans, angle);
-  car_->Draw(surf_, zoom, trans, angle);
+  car_->Draw(&rasterizer_, zoom, trans, angle);
+  rasterizer_.SetFlipY(false);
 
-  cv::flip(surf_, surf_, 0);
   RenderIndicators();
 
   auto reward = static_cast<int>(reward_);
-  cv::putText(surf_, cv::format("%04d", reward),
-              cv::Point(20, kWindowH - kWindowH * 2 / 40.0),
+  int text_y = kWindowH - text_.rows;
+  text_.setTo(black);
+  cv::putText(text_, cv::format("%04d", reward),
+              cv::Point(20, kWindowH - kWindowH * 2 / 40.0 - text_y),
               cv::FONT_HERSHEY_COMPLEX, 1, cv::Scalar(255, 255, 255), 2, 0);
+  rasterizer_.DrawImage(text_, 0, text_y);
 }
 
 }  // namespace box2d
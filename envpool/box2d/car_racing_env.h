@@ -21,7 +21,9 @@
 #include <box2d/box2d.h>
 
 #include <algorithm>
+#include <array>
 #include <cmath>
+#include <cstdint>
 #include <memory>
 #include <random>
 #include <unordered_set>
@@ -29,6 +31,7 @@
 #include <vector>
 
 #include "car_dynamics.h"
+#include "rasterizer.h"
 #include "utils.h"
 
 namespace box2d {
@@ -82,8 +85,10 @@ class CarRacingBox2dEnv {
   float step_reward_{0};
   bool done_{true};
 
-  cv::Mat surf_;
-  cv::Mat img_array_;
+  // frames are drawn at observation size; only the reward text is drawn with
+  // OpenCV, into `text_`, which covers the left of the indicator bar
+  Rasterizer rasterizer_;
+  cv::Mat text_;
 
   std::unique_ptr<CarRacingFrictionDetector> listener_;
   std::shared_ptr<b2World> world_;
@@ -97,6 +102,17 @@ class CarRacingBox2dEnv {
   std::vector<UserData*> roads_;
   // pair of position and color
   std::vector<std::pair<std::array<b2Vec2, 4>, cv::Scalar>> roads_poly_;
+  // field, grass patches and road in drawing order, built once per episode
+  // with the circle around each so that `RenderRoad` skips most of them
+  // before transforming their points
+  struct BackgroundPoly {
+    std::array<std::array<float, 2>, 4> field;
+    cv::Scalar color;
+    std::array<float, 2> center;
+    float radius;
+    bool clip;
+  };
+  std::vector<BackgroundPoly> background_;
 
  public:
   CarRacingBox2dEnv(int max_episode_steps, float lap_complete_percent);
@@ -112,7 +128,8 @@ class CarRacingBox2dEnv {
   void CarRacingReset(std::mt19937* gen);
   void CarRacingStep(std::mt19937* gen, float action0, float action1,
                      float action2);
-  void CreateImageArray();
+  // Writes the last rendered frame, 96 x 96 RGB.
+  void WriteImage(uint8_t* rgb) const;
 
  private:
   [[nodiscard]] std::vector<cv::Point> VerticalInd(int place, int s, int h,
@@ -122,6 +139,7 @@ class CarRacingBox2dEnv {
   void RenderIfMin(float value, const std::vector<cv::Point>& points,
                    const cv::Scalar& color);
   bool CreateTrack(std::mt19937* gen);
+  void CreateBackground();
   void ResetBox2d(std::mt19937* gen);
   void StepBox2d(std::mt19937* gen, float action0, float action1, float action2,
                  bool isAction);
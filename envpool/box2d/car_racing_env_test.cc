@@ -0,0 +1,119 @@
+// Copyright 2023 Garena Online Private Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "envpool/box2d/car_racing_env.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace {
+
+class CarRacingRenderEnv : public box2d::CarRacingBox2dEnv {
+ public:
+  CarRacingRenderEnv() : box2d::CarRacingBox2dEnv(1000, 0.95) {}
+
+  // The road layer alone, seen from world point (x, y) as `Render` would see
+  // it from a car there, drawn by `RenderRoad` or, if `per_frame`, by going
+  // through every polygon of the episode as `RenderRoad` did before they were
+  // kept with their bounding circles.
+  std::vector<uint8_t> RoadFrame(float x, float y, float car_angle, float zoom,
+                                 bool per_frame) {
+    float angle = -car_angle;
+    std::array<float, 2> scroll = {-x * zoom, -y * zoom};
+    std::array<float, 2> trans = box2d::RotateRad(scroll, angle);
+    trans = {1000 / 2.0f + trans[0], 800 / 4.0f + trans[1]};
+    rasterizer_.Clear(cv::Scalar(0, 0, 0));
+    rasterizer_.SetFlipY(true);
+    if (per_frame) {
+      RenderRoadPerFrame(zoom, trans, angle);
+    } else {
+      RenderRoad(zoom, trans, angle);
+    }
+    rasterizer_.SetFlipY(false);
+    std::vector<uint8_t> rgb(96 * 96 * 3);
+    WriteImage(rgb.data());
+    return rgb;
+  }
+
+  const std::vector<std::array<float, 4>>& Track() const { return track_; }
+
+ private:
+  void RenderRoadPerFrame(float zoom, const std::array<float, 2>& translation,
+                          float angle) {
+    const float playfield = 2000 / 6.0f;
+    const float grass_dim = playfield / 20;
+    std::array<std::array<float, 2>, 4> field;
+    field[0] = {playfield, playfield};
+    field[1] = {playfield, -playfield};
+    field[2] = {-playfield, -playfield};
+    field[3] = {-playfield, playfield};
+    DrawColoredPolygon(field, box2d::kBgColor, zoom, translation, angle,
+                       false);
+    for (int x = -20; x < 20; x += 2) {
+      auto fx = static_cast<float>(x);
+      for (int y = -20; y < 20; y += 2) {
+        auto fy = static_cast<float>(y);
+        std::array<std::array<float, 2>, 4> grass;
+        grass[0] = {grass_dim * fx + grass_dim, grass_dim * fy};
+        grass[1] = {grass_dim * fx, grass_dim * fy};
+        grass[2] = {grass_dim * fx, grass_dim * fy + grass_dim};
+        grass[3] = {grass_dim * fx + grass_dim, grass_dim * fy + grass_dim};
+        DrawColoredPolygon(grass, box2d::kGrassColor, zoom, translation,
+                           angle);
+      }
+    }
+    for (auto& [poly, color] : roads_poly_) {
+      for (std::size_t i = 0; i < poly.size(); ++i) {
+        field[i] = {poly[i].x, poly[i].y};
+      }
+      DrawColoredPolygon(field, color, zoom, translation, angle);
+    }
+  }
+};
+
+}  // namespace
+
+TEST(CarRacingEnvTest, RoadFrameUnchanged) {
+  CarRacingRenderEnv env;
+  std::mt19937 gen(0);
+  std::uniform_real_distribution<float> unit(0, 1);
+  for (int episode = 0; episode < 3; ++episode) {
+    env.CarRacingReset(&gen);
+    const auto& track = env.Track();
+    for (std::size_t i = 0; i < track.size(); i += 3) {
+      // off the track and turned away from it, zoomed out as in the first
+      // second of an episode or in
+      float x = track[i][2] + (unit(gen) - 0.5f) * 40;
+      float y = track[i][3] + (unit(gen) - 0.5f) * 40;
+      float angle = track[i][1] + (unit(gen) - 0.5f) * 2;
+      float zoom = i % 2 == 0 ? 16.2f : 0.6f + unit(gen) * 15.6f;
+      EXPECT_EQ(env.RoadFrame(x, y, angle, zoom, false),
+                env.RoadFrame(x, y, angle, zoom, true))
+          << "episode " << episode << " tile " << i;
+    }
+    // close to and beyond the end of the playfield
+    for (int i = 0; i < 20; ++i) {
+      float x = (unit(gen) - 0.5f) * 800;
+      float y = (unit(gen) - 0.5f) * 800;
+      float angle = unit(gen) * 6.2832f;
+      EXPECT_EQ(env.RoadFrame(x, y, angle, 16.2f, false),
+                env.RoadFrame(x, y, angle, 16.2f, true))
+          << "episode " << episode << " point " << i;
+    }
+  }
+}
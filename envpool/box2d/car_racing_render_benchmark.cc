@@ -0,0 +1,58 @@
+// Copyright 2023 Garena Online Private Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures the time of one CarRacing step, which renders the frame, and of
+// rendering that frame again on its own, averaged over episodes of
+// `num_steps` steps driven with some gas and a slowly turning wheel.
+//
+// Usage: car_racing_render_benchmark [num_steps] [num_episodes]
+
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "envpool/box2d/car_racing_env.h"
+
+int main(int argc, char** argv) {
+  const int num_steps = argc > 1 ? std::stoi(argv[1]) : 1000;
+  const int num_episodes = argc > 2 ? std::stoi(argv[2]) : 5;
+  box2d::CarRacingBox2dEnv env(num_steps, 0.95);
+  std::mt19937 gen(0);
+  std::chrono::duration<double, std::micro> step{0};
+  std::chrono::duration<double, std::micro> render{0};
+  for (int episode = 0; episode < num_episodes; ++episode) {
+    env.CarRacingReset(&gen);
+    for (int i = 0; i < num_steps; ++i) {
+      auto steer = static_cast<float>(std::sin(i * 0.01));
+      auto start = std::chrono::steady_clock::now();
+      env.CarRacingStep(&gen, steer, 0.3f, 0.f);
+      auto stepped = std::chrono::steady_clock::now();
+      env.Render();
+      step += stepped - start;
+      render += std::chrono::steady_clock::now() - stepped;
+    }
+  }
+  const int total = num_steps * num_episodes;
+  std::cout << std::left << std::setw(24) << "task" << std::right
+            << std::setw(12) << "us/step" << std::setw(12) << "us/render"
+            << std::endl;
+  std::cout << std::left << std::setw(24) << "CarRacing" << std::right
+            << std::fixed << std::setprecision(1) << std::setw(12)
+            << step.count() / total << std::setw(12) << render.count() / total
+            << std::endl;
+  return 0;
+}
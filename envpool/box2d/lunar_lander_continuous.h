@@ -61,6 +61,12 @@ class LunarLanderContinuousEnv : public Env<LunarLanderContinuousEnvSpec>,
     WriteState();
   }
 
+  void Serialize(ByteWriter* writer) override { LunarLanderSerialize(writer); }
+
+  void Deserialize(ByteReader* reader) override {
+    LunarLanderDeserialize(reader);
+  }
+
  private:
   void WriteState() {
     State state = Allocate();
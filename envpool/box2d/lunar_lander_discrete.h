@@ -60,6 +60,12 @@ class LunarLanderDiscreteEnv : public Env<LunarLanderDiscreteEnvSpec>,
     WriteState();
   }
 
+  void Serialize(ByteWriter* writer) override { LunarLanderSerialize(writer); }
+
+  void Deserialize(ByteReader* reader) override {
+    LunarLanderDeserialize(reader);
+  }
+
  private:
   void WriteState() {
     State state = Allocate();
@@ -15,6 +15,7 @@
 #include "envpool/box2d/lunar_lander_env.h"
 
 #include <algorithm>
+#include <stdexcept>
 
 #include "envpool/box2d/utils.h"
 
@@ -320,4 +321,50 @@ void LunarLanderBox2dEnv::LunarLanderStep(std::mt19937* gen, int action,
   StepBox2d(gen, action, action0, action1);
 }
 
+void LunarLanderBox2dEnv::LunarLanderSerialize(ByteWriter* writer) {
+  if (lander_ == nullptr) {
+    throw std::runtime_error("Env must be reset before snapshot/restore.");
+  }
+  writer->Write(ShapeFingerprint({moon_}));
+  writer->Write(elapsed_step_);
+  writer->Write(reward_);
+  writer->Write(prev_shaping_);
+  writer->Write(done_);
+  writer->Write(obs_);
+  writer->Write(ground_contact_);
+  SerializeBody(lander_, writer);
+  SerializeBody(legs_[0], writer);
+  SerializeBody(legs_[1], writer);
+  writer->Write(particles_.size());
+  for (auto* p : particles_) {
+    writer->Write(p->GetFixtureList()->GetDensity());
+    SerializeBody(p, writer);
+  }
+}
+
+void LunarLanderBox2dEnv::LunarLanderDeserialize(ByteReader* reader) {
+  if (lander_ == nullptr) {
+    throw std::runtime_error("Env must be reset before snapshot/restore.");
+  }
+  CheckFingerprint(reader, ShapeFingerprint({moon_}));
+  reader->Read(&elapsed_step_);
+  reader->Read(&reward_);
+  reader->Read(&prev_shaping_);
+  reader->Read(&done_);
+  reader->Read(&obs_);
+  reader->Read(&ground_contact_);
+  DeserializeBody(lander_, reader);
+  DeserializeBody(legs_[0], reader);
+  DeserializeBody(legs_[1], reader);
+  for (auto* p : particles_) {
+    world_->DestroyBody(p);
+  }
+  particles_.clear();
+  auto num_particles = reader->Read<std::size_t>();
+  for (std::size_t i = 0; i < num_particles; ++i) {
+    auto mass = reader->Read<float>();
+    DeserializeBody(CreateParticle(mass, b2Vec2(0, 0)), reader);
+  }
+}
+
 }  // namespace box2d
@@ -25,6 +25,8 @@
 #include <random>
 #include <vector>
 
+#include "envpool/core/serialization.h"
+
 namespace box2d {
 
 class LunarLanderContactDetector;
@@ -72,6 +74,10 @@ class LunarLanderBox2dEnv {
   // continuous action space: action0 and action1
   void LunarLanderStep(std::mt19937* gen, int action, float action0,
                        float action1);
+  // snapshots hold a fingerprint of the terrain instead of the terrain, and
+  // restoring one after a reset onto different terrain throws
+  void LunarLanderSerialize(ByteWriter* writer);
+  void LunarLanderDeserialize(ByteReader* reader);
 
  private:
   void ResetBox2d(std::mt19937* gen);
@@ -0,0 +1,314 @@
+// Copyright 2023 Garena Online Private Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "envpool/box2d/rasterizer.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace box2d {
+
+static uint8_t Saturate(double value) {
+  return static_cast<uint8_t>(
+      std::lround(std::min(std::max(value, 0.0), 255.0)));
+}
+
+Rasterizer::Rasterizer(int window_w, int window_h, int obs_w, int obs_h)
+    : window_w_(window_w), window_h_(window_h) {
+  // source pixels and weights of `cv::resize` with INTER_LINEAR, see
+  // resizeGeneric in OpenCV's imgproc/src/resize.cpp
+  auto taps = [](int src, int dst, std::vector<int>* pos,
+                 std::vector<Tap>* taps) {
+    // the scale is inverted back from dst / src, as OpenCV does
+    double scale = 1.0 / (static_cast<double>(dst) / src);
+    for (int d = 0; d < dst; ++d) {
+      auto f = static_cast<float>((d + 0.5) * scale - 0.5);
+      int s = cvFloor(f);
+      f -= static_cast<float>(s);
+      if (s < 0) {
+        s = 0;
+        f = 0;
+      }
+      if (s >= src - 1) {
+        s = src - 1;
+        f = 0;
+      }
+      taps->push_back(
+          Tap{s, std::min(s + 1, src - 1),
+              cv::saturate_cast<int16_t>((1.f - f) * (1 << kWeightBits)),
+              cv::saturate_cast<int16_t>(f * (1 << kWeightBits))});
+      pos->push_back(taps->back().i0);
+      pos->push_back(taps->back().i1);
+    }
+    std::sort(pos->begin(), pos->end());
+    pos->erase(std::unique(pos->begin(), pos->end()), pos->end());
+    for (auto& tap : *taps) {
+      tap.i0 = static_cast<int>(
+          std::lower_bound(pos->begin(), pos->end(), tap.i0) - pos->begin());
+      tap.i1 = static_cast<int>(
+          std::lower_bound(pos->begin(), pos->end(), tap.i1) - pos->begin());
+    }
+  };
+  taps(window_w, obs_w, &xs_, &col_taps_);
+  taps(window_h, obs_h, &ys_, &row_taps_);
+  for (int x = 0; x <= window_w; ++x) {
+    cols_before_.push_back(static_cast<int>(
+        std::lower_bound(xs_.begin(), xs_.end(), x) - xs_.begin()));
+  }
+  samples_.resize(xs_.size() * ys_.size());
+}
+
+uint32_t Rasterizer::Pack(const cv::Scalar& color) {
+  const uint8_t bgr[3] = {Saturate(color[0]), Saturate(color[1]),
+                          Saturate(color[2])};
+  return Pack(bgr);
+}
+
+void Rasterizer::Clear(const cv::Scalar& color) {
+  std::fill(samples_.begin(), samples_.end(), Pack(color));
+}
+
+std::pair<int, int> Rasterizer::SampleRows(int y_lo, int y_hi) const {
+  if (flip_y_) {
+    std::swap(y_lo, y_hi);
+    y_lo = window_h_ - 1 - y_lo;
+    y_hi = window_h_ - 1 - y_hi;
+  }
+  return {static_cast<int>(std::lower_bound(ys_.begin(), ys_.end(), y_lo) -
+                           ys_.begin()),
+          static_cast<int>(std::upper_bound(ys_.begin(), ys_.end(), y_hi) -
+                           ys_.begin())};
+}
+
+void Rasterizer::FillSpan(int r, int x_lo, int x_hi, uint32_t color) {
+  uint32_t* row = samples_.data() + r * xs_.size();
+  std::fill(row + cols_before_[std::min(std::max(x_lo, 0), window_w_)],
+            row + cols_before_[std::min(std::max(x_hi + 1, 0), window_w_)],
+            color);
+}
+
+static int64_t FloorDiv(int64_t a, int64_t b) {
+  return a / b - (a % b != 0 && (a < 0) != (b < 0) ? 1 : 0);
+}
+
+void Rasterizer::Line(cv::Point p0, cv::Point p1, uint32_t color) {
+  // the pixels cv::LineIterator visits with 8-connectivity from left to
+  // right, as `cv::fillPoly` outlines its edges, but found per sample row:
+  // after k steps along the major axis the minor axis has moved
+  // ceil((2 * dy * k - dx) / (2 * dx)) pixels
+  const cv::Size size(window_w_, window_h_);
+  const cv::Rect window(cv::Point(0, 0), size);
+  if ((!window.contains(p0) || !window.contains(p1)) &&
+      !cv::clipLine(size, p0, p1)) {
+    return;
+  }
+  if (p1.x < p0.x) {
+    std::swap(p0, p1);
+  }
+  int64_t dx = p1.x - p0.x;
+  int64_t dy = std::abs(p1.y - p0.y);
+  int sy = p1.y < p0.y ? -1 : 1;
+  bool vertical = dy > dx;
+  if (vertical) {
+    std::swap(dx, dy);
+  }
+  auto [r_begin, r_end] =
+      SampleRows(std::min(p0.y, p1.y), std::max(p0.y, p1.y));
+  for (int r = r_begin; r < r_end; ++r) {
+    int y = flip_y_ ? window_h_ - 1 - ys_[r] : ys_[r];
+    int64_t m = (y - p0.y) * sy;
+    if (vertical) {
+      int64_t x = p0.x - FloorDiv(dx - 2 * dy * m, 2 * dx);
+      FillSpan(r, static_cast<int>(x), static_cast<int>(x), color);
+    } else {
+      // the steps that leave the minor axis m pixels from p0
+      int64_t k_lo = 0;
+      int64_t k_hi = dx;
+      if (dy != 0) {
+        k_lo = std::max<int64_t>(0, FloorDiv(2 * dx * m - dx, 2 * dy) + 1);
+        k_hi = std::min(dx, FloorDiv(2 * dx * m + dx, 2 * dy));
+      }
+      FillSpan(r, static_cast<int>(p0.x + k_lo), static_cast<int>(p0.x + k_hi),
+               color);
+    }
+  }
+}
+
+void Rasterizer::FillConvexPoly(const cv::Point* points, int n,
+                                const cv::Scalar& color) {
+  if (n > kMaxPoints) {
+    throw std::runtime_error("Rasterizer: too many polygon points.");
+  }
+  if (n == 0) {
+    return;
+  }
+  const uint32_t packed = Pack(color);
+  // edges as CollectPolyEdges and FillEdgeCollection in OpenCV's
+  // imgproc/src/drawing.cpp make them, x in 16.16 fixed point
+  const int shift = 16;
+  const int64_t one = int64_t{1} << shift;
+  struct Edge {
+    int y0, y1;
+    int64_t x, dx;
+  };
+  std::array<Edge, kMaxPoints> edges;
+  int num_edges = 0;
+  int y_min = std::numeric_limits<int>::max();
+  int y_max = std::numeric_limits<int>::min();
+  const cv::Size size(window_w_, window_h_);
+  const cv::Rect window(cv::Point(0, 0), size);
+  cv::Point p0 = points[n - 1];
+  for (int i = 0; i < n; ++i) {
+    cv::Point p1 = points[i];
+    Line(p0, p1, packed);
+    // edges leaving the window start and end where they cross it
+    int64_t x0 = int64_t{p0.x} * one;
+    int64_t x1 = int64_t{p1.x} * one;
+    int y0 = p0.y;
+    int y1 = p1.y;
+    if (!window.contains(p0) || !window.contains(p1)) {
+      cv::Point c0 = p0;
+      cv::Point c1 = p1;
+      cv::clipLine(size, c0, c1);
+      x0 = int64_t{c0.x} * one;
+      x1 = int64_t{c1.x} * one;
+      if (c0.y != c1.y) {
+        y0 = c0.y;
+        y1 = c1.y;
+      }
+    }
+    if (p0.y != p1.y) {
+      Edge& edge = edges[num_edges++];
+      edge.dx = (x1 - x0) / (y1 - y0);
+      if (p0.y < p1.y) {
+        edge.y0 = p0.y;
+        edge.y1 = p1.y;
+        edge.x = x0 + (p0.y - y0) * edge.dx;
+      } else {
+        edge.y0 = p1.y;
+        edge.y1 = p0.y;
+        edge.x = x1 + (p1.y - y1) * edge.dx;
+      }
+      y_min = std::min(y_min, edge.y0);
+      y_max = std::max(y_max, edge.y1);
+    }
+    p0 = p1;
+  }
+  if (num_edges < 2) {
+    return;
+  }
+  auto [r_begin, r_end] =
+      SampleRows(std::max(y_min, 0), std::min(y_max, window_h_) - 1);
+  for (int r = r_begin; r < r_end; ++r) {
+    int y = flip_y_ ? window_h_ - 1 - ys_[r] : ys_[r];
+    int64_t xs[kMaxPoints];
+    int k = 0;
+    for (int i = 0; i < num_edges; ++i) {
+      if (edges[i].y0 <= y && y < edges[i].y1) {
+        xs[k++] = edges[i].x + (y - edges[i].y0) * edges[i].dx;
+      }
+    }
+    // a handful of edges at most, sorted by insertion
+    for (int i = 1; i < k; ++i) {
+      for (int j = i; j > 0 && xs[j] < xs[j - 1]; --j) {
+        std::swap(xs[j], xs[j - 1]);
+      }
+    }
+    for (int i = 0; i + 1 < k; i += 2) {
+      auto x_lo = static_cast<int>((xs[i] + one - 1) >> shift);
+      auto x_hi = static_cast<int>(xs[i + 1] >> shift);
+      if (x_lo < window_w_ && x_hi >= 0) {
+        FillSpan(r, x_lo, x_hi, packed);
+      }
+    }
+  }
+}
+
+void Rasterizer::Polylines(const std::vector<cv::Point>& points, int thickness,
+                           const cv::Scalar& color) {
+  if (points.empty()) {
+    return;
+  }
+  if (mask_.empty()) {
+    mask_ = cv::Mat::zeros(window_h_, window_w_, CV_8UC1);
+  }
+  cv::polylines(mask_, points, false, cv::Scalar(255), thickness);
+  // the stroke stays within `thickness` of the points
+  cv::Rect box = cv::boundingRect(points);
+  box = cv::Rect(box.x - thickness, box.y - thickness,
+                 box.width + thickness * 2, box.height + thickness * 2) &
+        cv::Rect(0, 0, window_w_, window_h_);
+  const uint32_t packed = Pack(color);
+  int c_begin = cols_before_[box.x];
+  int c_end = cols_before_[box.x + box.width];
+  auto [r_begin, r_end] = SampleRows(box.y, box.y + box.height - 1);
+  for (int r = r_begin; r < r_end; ++r) {
+    const auto* m =
+        mask_.ptr<uint8_t>(flip_y_ ? window_h_ - 1 - ys_[r] : ys_[r]);
+    uint32_t* row = samples_.data() + r * xs_.size();
+    for (int c = c_begin; c < c_end; ++c) {
+      if (m[xs_[c]] != 0) {
+        row[c] = packed;
+      }
+    }
+  }
+  // drawing the stroke again clears exactly the pixels it set
+  cv::polylines(mask_, points, false, cv::Scalar(0), thickness);
+}
+
+void Rasterizer::DrawImage(const cv::Mat& image, int x, int y) {
+  auto r_begin = std::lower_bound(ys_.begin(), ys_.end(), y) - ys_.begin();
+  auto r_end =
+      std::lower_bound(ys_.begin(), ys_.end(), y + image.rows) - ys_.begin();
+  auto c_begin = std::lower_bound(xs_.begin(), xs_.end(), x) - xs_.begin();
+  auto c_end =
+      std::lower_bound(xs_.begin(), xs_.end(), x + image.cols) - xs_.begin();
+  for (auto r = r_begin; r < r_end; ++r) {
+    const auto* src = image.ptr<uint8_t>(ys_[r] - y);
+    uint32_t* p = samples_.data() + r * xs_.size();
+    for (auto c = c_begin; c < c_end; ++c) {
+      p[c] = Pack(src + (xs_[c] - x) * 3);
+    }
+  }
+}
+
+void Rasterizer::Resolve(uint8_t* rgb) const {
+  const std::size_t stride = xs_.size();
+  for (const Tap& row : row_taps_) {
+    const uint32_t* s0 = samples_.data() + row.i0 * stride;
+    const uint32_t* s1 = samples_.data() + row.i1 * stride;
+    for (const Tap& col : col_taps_) {
+      uint32_t a = s0[col.i0];
+      uint32_t b = s0[col.i1];
+      uint32_t c = s1[col.i0];
+      uint32_t d = s1[col.i1];
+      for (int ch = 0; ch < 3; ++ch, a >>= 8, b >>= 8, c >>= 8, d >>= 8) {
+        int h0 = static_cast<int>(a & 255) * col.w0 +
+                 static_cast<int>(b & 255) * col.w1;
+        int h1 = static_cast<int>(c & 255) * col.w0 +
+                 static_cast<int>(d & 255) * col.w1;
+        int v = (h0 * row.w0 + h1 * row.w1 + (1 << (kWeightBits * 2 - 1))) >>
+                (kWeightBits * 2);
+        // BGR to RGB
+        rgb[2 - ch] = static_cast<uint8_t>(v);
+      }
+      rgb += 3;
+    }
+  }
+}
+
+}  // namespace box2d
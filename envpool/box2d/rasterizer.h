@@ -0,0 +1,105 @@
+/*
+ * Copyright 2023 Garena Online Private Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ENVPOOL_BOX2D_RASTERIZER_H_
+#define ENVPOOL_BOX2D_RASTERIZER_H_
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "opencv2/opencv.hpp"
+
+namespace box2d {
+
+/*
+ * Draws polygons in window coordinates straight at observation size.
+ *
+ * CarRacing frames used to be drawn into the whole window with OpenCV and
+ * then shrunk to the observation with `cv::resize`, whose bilinear
+ * interpolation reads only the 2x2 window pixels around the center of every
+ * observation pixel. The rasterizer keeps just those samples, a grid of
+ * 2 * obs_w x 2 * obs_h window pixels, sets each of them as OpenCV would have
+ * and blends them with the weights of `cv::resize`. Frames are therefore the
+ * same as before while the window is never drawn.
+ */
+class Rasterizer {
+ public:
+  static const int kMaxPoints = 8;
+
+  Rasterizer(int window_w, int window_h, int obs_w, int obs_h);
+
+  void Clear(const cv::Scalar& color);
+  // While set, y is mirrored, as if the window was flipped vertically after
+  // drawing, like `cv::flip(surf, surf, 0)`.
+  void SetFlipY(bool flip_y) { flip_y_ = flip_y; }
+  // Fills a polygon of at most `kMaxPoints` points, in window pixels, with the
+  // pixels `cv::fillPoly` sets: its 8-connected outline and the spans between
+  // its edges.
+  void FillConvexPoly(const cv::Point* points, int n, const cv::Scalar& color);
+  void FillConvexPoly(const std::vector<cv::Point>& points,
+                      const cv::Scalar& color) {
+    FillConvexPoly(points.data(), static_cast<int>(points.size()), color);
+  }
+  // Strokes an open polyline like `cv::polylines`. It is drawn by OpenCV into
+  // a window-sized mask, of which only the box around the line is read and
+  // cleared.
+  void Polylines(const std::vector<cv::Point>& points, int thickness,
+                 const cv::Scalar& color);
+  // Copies `image`, BGR, to the window with its top left corner at (x, y).
+  void DrawImage(const cv::Mat& image, int x, int y);
+  // Writes the observation, obs_h x obs_w x 3 RGB.
+  void Resolve(uint8_t* rgb) const;
+
+ protected:
+  // the two samples an observation pixel blends and their weights, out of
+  // 1 << kWeightBits
+  struct Tap {
+    int i0, i1, w0, w1;
+  };
+  static const int kWeightBits = 11;
+
+  int window_w_, window_h_;
+  bool flip_y_{false};
+  // window pixel of every sample column and row, ascending
+  std::vector<int> xs_, ys_;
+  // number of sample columns left of every window column and of its right
+  // edge, window_w + 1 entries
+  std::vector<int> cols_before_;
+  std::vector<Tap> col_taps_, row_taps_;
+  // ys_.size() x xs_.size(), BGR from the lowest byte, so that spans are
+  // filled a sample per store
+  std::vector<uint32_t> samples_;
+  cv::Mat mask_;  // see `Polylines`, allocated on first use
+
+  static uint32_t Pack(const uint8_t* bgr) {
+    return static_cast<uint32_t>(bgr[0]) | static_cast<uint32_t>(bgr[1]) << 8 |
+           static_cast<uint32_t>(bgr[2]) << 16;
+  }
+  static uint32_t Pack(const cv::Scalar& color);
+  // The sample rows from window row `y_lo` to `y_hi` before flipping, as
+  // [first, last).
+  [[nodiscard]] std::pair<int, int> SampleRows(int y_lo, int y_hi) const;
+  // Sets the samples of row `r` from window column `x_lo` to `x_hi`.
+  void FillSpan(int r, int x_lo, int x_hi, uint32_t color);
+  // Sets the samples on the 8-connected line `cv::fillPoly` outlines edges
+  // with.
+  void Line(cv::Point p0, cv::Point p1, uint32_t color);
+};
+
+}  // namespace box2d
+
+#endif  // ENVPOOL_BOX2D_RASTERIZER_H_
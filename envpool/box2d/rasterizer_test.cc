@@ -0,0 +1,119 @@
+// Copyright 2023 Garena Online Private Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "envpool/box2d/rasterizer.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "opencv2/opencv.hpp"
+
+namespace {
+
+// Draws random polygons and particle-like strokes with `box2d::Rasterizer`
+// and, as CarRacing used to, into the whole window with `cv::fillPoly` and
+// `cv::polylines`, flipped half way and shrunk with `cv::resize`. Returns the
+// largest difference between the two observations.
+int MaxDifference(int window_w, int window_h, int obs_w, int obs_h,
+                  int seed) {
+  std::mt19937 gen(seed);
+  std::uniform_real_distribution<float> unit(0, 1);
+  // up to a tenth of the window out of it
+  auto random_x = [&]() {
+    return (unit(gen) * 1.2f - 0.1f) * static_cast<float>(window_w);
+  };
+  auto random_y = [&]() {
+    return (unit(gen) * 1.2f - 0.1f) * static_cast<float>(window_h);
+  };
+  auto random_polygon = [&]() {
+    // small like wheels or up to twice the window like road tiles close up
+    float cx = random_x();
+    float cy = random_y();
+    float radius = 1 + unit(gen) * static_cast<float>(window_w) *
+                           (gen() % 4 == 0 ? 2.0f : 0.1f);
+    float angle = unit(gen) * 6.2832f;
+    int n = 3 + static_cast<int>(gen() % 6);
+    std::vector<cv::Point> points;
+    for (int i = 0; i < n; ++i) {
+      float a = angle + static_cast<float>(i) * 6.2832f / n;
+      points.emplace_back(static_cast<int>(cx + radius * std::cos(a)),
+                          static_cast<int>(cy + radius * 1.3f * std::sin(a)));
+    }
+    return points;
+  };
+  auto random_stroke = [&]() {
+    cv::Point p(static_cast<int>(random_x()), static_cast<int>(random_y()));
+    std::vector<cv::Point> points = {p};
+    for (int i = static_cast<int>(gen() % 8); i > 0; --i) {
+      p += cv::Point(static_cast<int>(gen() % 121) - 60,
+                     static_cast<int>(gen() % 121) - 60);
+      points.push_back(p);
+    }
+    return points;
+  };
+
+  box2d::Rasterizer rasterizer(window_w, window_h, obs_w, obs_h);
+  rasterizer.Clear(cv::Scalar(0, 0, 0));
+  cv::Mat surf(window_h, window_w, CV_8UC3, cv::Scalar(0, 0, 0));
+  for (int pass = 0; pass < 2; ++pass) {
+    rasterizer.SetFlipY(pass == 0);
+    for (int i = 0; i < 200; ++i) {
+      cv::Scalar color(gen() % 256, gen() % 256, gen() % 256);
+      if (i % 4 == 3) {
+        auto points = random_stroke();
+        rasterizer.Polylines(points, 2, color);
+        cv::polylines(surf, points, false, color, 2);
+      } else {
+        auto points = random_polygon();
+        rasterizer.FillConvexPoly(points, color);
+        cv::fillPoly(surf, points, color);
+      }
+    }
+    if (pass == 0) {
+      cv::flip(surf, surf, 0);
+    }
+  }
+  cv::Mat expected;
+  cv::resize(surf, expected, cv::Size(obs_w, obs_h));
+  cv::cvtColor(expected, expected, cv::COLOR_BGR2RGB);
+  cv::Mat actual(obs_h, obs_w, CV_8UC3);
+  rasterizer.Resolve(actual.data);
+  return static_cast<int>(cv::norm(expected, actual, cv::NORM_INF));
+}
+
+}  // namespace
+
+// Samples are set exactly as OpenCV sets those pixels; only the vectorized
+// rounding of `cv::resize` may differ from `Resolve`, by one.
+TEST(RasterizerTest, CarRacingWindow) {
+  for (int seed = 0; seed < 10; ++seed) {
+    EXPECT_LE(MaxDifference(1000, 800, 96, 96, seed), 1) << "seed " << seed;
+  }
+}
+
+TEST(RasterizerTest, OtherSizes) {
+  EXPECT_LE(MaxDifference(200, 150, 64, 48, 0), 1);
+  EXPECT_LE(MaxDifference(100, 80, 96, 96, 1), 1);
+}
+
+TEST(RasterizerTest, TooManyPoints) {
+  box2d::Rasterizer rasterizer(100, 80, 10, 8);
+  std::vector<cv::Point> points(box2d::Rasterizer::kMaxPoints + 1);
+  EXPECT_THROW(rasterizer.FillConvexPoly(points, cv::Scalar(0, 0, 0)),
+               std::runtime_error);
+}
@@ -14,6 +14,9 @@
 
 #include "envpool/box2d/utils.h"
 
+#include <cstring>
+#include <stdexcept>
+
 namespace box2d {
 
 b2Vec2 Vec2(double x, double y) {
@@ -46,4 +49,59 @@ b2Vec2 Multiply(const b2Transform& trans, const b2Vec2& v) {
   return {x, y};
 }
 
+void SerializeBody(b2Body* body, ByteWriter* writer) {
+  writer->Write(body->GetPosition());
+  writer->Write(body->GetAngle());
+  writer->Write(body->GetLinearVelocity());
+  writer->Write(body->GetAngularVelocity());
+  writer->Write(body->IsAwake());
+}
+
+void DeserializeBody(b2Body* body, ByteReader* reader) {
+  auto position = reader->Read<b2Vec2>();
+  auto angle = reader->Read<float>();
+  body->SetTransform(position, angle);
+  body->SetLinearVelocity(reader->Read<b2Vec2>());
+  body->SetAngularVelocity(reader->Read<float>());
+  body->SetAwake(reader->Read<bool>());
+}
+
+uint64_t ShapeFingerprint(const std::vector<b2Body*>& bodies) {
+  // FNV-1a over the raw bytes, terrains are rebuilt bit for bit from a seed
+  uint64_t hash = 14695981039346656037ULL;
+  auto mix = [&hash](const b2Vec2& v) {
+    std::array<uint8_t, sizeof(b2Vec2)> bytes;
+    std::memcpy(bytes.data(), &v, sizeof(b2Vec2));
+    for (uint8_t byte : bytes) {
+      hash = (hash ^ byte) * 1099511628211ULL;
+    }
+  };
+  for (b2Body* body : bodies) {
+    mix(body->GetPosition());
+    for (b2Fixture* f = body->GetFixtureList(); f != nullptr;
+         f = f->GetNext()) {
+      const b2Shape* shape = f->GetShape();
+      if (shape->GetType() == b2Shape::e_edge) {
+        const auto* edge = static_cast<const b2EdgeShape*>(shape);
+        mix(edge->m_vertex1);
+        mix(edge->m_vertex2);
+      } else if (shape->GetType() == b2Shape::e_polygon) {
+        const auto* polygon = static_cast<const b2PolygonShape*>(shape);
+        for (int i = 0; i < polygon->m_count; ++i) {
+          mix(polygon->m_vertices[i]);
+        }
+      }
+    }
+  }
+  return hash;
+}
+
+void CheckFingerprint(ByteReader* reader, uint64_t expected) {
+  if (reader->Read<uint64_t>() != expected) {
+    throw std::runtime_error(
+        "Snapshot was taken on a different terrain, restore it in the "
+        "episode it was taken in.");
+  }
+}
+
 }  // namespace box2d
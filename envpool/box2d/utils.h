@@ -20,7 +20,11 @@
 #include <box2d/box2d.h>
 
 #include <array>
+#include <cstdint>
 #include <random>
+#include <vector>
+
+#include "envpool/core/serialization.h"
 
 namespace box2d {
 
@@ -38,6 +42,21 @@ b2Vec2 RotateRad(const b2Vec2& v, float angle);
 
 b2Vec2 Multiply(const b2Transform& trans, const b2Vec2& v);
 
+// Checkpointing of a body's transform, velocities and awake flag. Box2D's
+// internal contact cache and sleep timers are not part of the snapshot.
+void SerializeBody(b2Body* body, ByteWriter* writer);
+
+void DeserializeBody(b2Body* body, ByteReader* reader);
+
+// Hash of the positions and fixture shapes of `bodies`. Snapshots store it
+// for the terrain, which they do not contain, so that restoring onto another
+// terrain can be refused.
+uint64_t ShapeFingerprint(const std::vector<b2Body*>& bodies);
+
+// Reads a fingerprint written with a snapshot and throws if it is not
+// `expected`.
+void CheckFingerprint(ByteReader* reader, uint64_t expected);
+
 }  // namespace box2d
 
 #endif  // ENVPOOL_BOX2D_UTILS_H_
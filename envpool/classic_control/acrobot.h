@@ -135,6 +135,26 @@ class AcrobotEnv : public Env<AcrobotEnvSpec> {
     WriteState(reward);
   }
 
+  void Serialize(ByteWriter* writer) override {
+    writer->Write(elapsed_step_);
+    writer->Write(done_);
+    writer->Write(s_.s0);
+    writer->Write(s_.s1);
+    writer->Write(s_.s2);
+    writer->Write(s_.s3);
+    writer->Write(s_.s4);
+  }
+
+  void Deserialize(ByteReader* reader) override {
+    reader->Read(&elapsed_step_);
+    reader->Read(&done_);
+    reader->Read(&s_.s0);
+    reader->Read(&s_.s1);
+    reader->Read(&s_.s2);
+    reader->Read(&s_.s3);
+    reader->Read(&s_.s4);
+  }
+
  private:
   V5 Rk4(V5 y0) {
     V5 k1 = Derivs(y0, 0);
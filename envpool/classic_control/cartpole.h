@@ -109,6 +109,24 @@ class CartPoleEnv : public Env<CartPoleEnvSpec> {
     WriteState(1.0);
   }
 
+  void Serialize(ByteWriter* writer) override {
+    writer->Write(elapsed_step_);
+    writer->Write(done_);
+    writer->Write(x_);
+    writer->Write(x_dot_);
+    writer->Write(theta_);
+    writer->Write(theta_dot_);
+  }
+
+  void Deserialize(ByteReader* reader) override {
+    reader->Read(&elapsed_step_);
+    reader->Read(&done_);
+    reader->Read(&x_);
+    reader->Read(&x_dot_);
+    reader->Read(&theta_);
+    reader->Read(&theta_dot_);
+  }
+
  private:
   void WriteState(float reward) {
     State state = Allocate();
@@ -20,6 +20,7 @@ import numpy as np
 from absl.testing import absltest
 
 import envpool.classic_control.registration  # noqa: F401
+from envpool.python.testing import check_snapshot_restore
 from envpool.registration import make_gym
 
 
@@ -75,6 +76,23 @@ class _ClassicControlEnvPoolTest(absltest.TestCase):
         np.testing.assert_allclose(term0, term1[0])
         np.testing.assert_allclose(trunc0, trunc1[0])
 
+  def test_snapshot_restore(self) -> None:
+    for task_id, actions in [
+      # alternate pushes, so the pole stays up for the whole check
+      ("CartPole-v1", (np.arange(40) // 4 % 2).reshape(10, 4)),
+      ("Pendulum-v1", np.random.uniform(-2, 2, size=(10, 4, 1))),
+      ("MountainCar-v0", np.random.randint(3, size=(10, 4))),
+      (
+        "MountainCarContinuous-v0",
+        np.random.uniform(-1, 1, size=(10, 4, 1)),
+      ),
+      ("Acrobot-v1", np.random.randint(3, size=(10, 4))),
+    ]:
+      env = make_gym(task_id, num_envs=4, seed=0)
+      env.reset()
+      env.step(actions[0])
+      check_snapshot_restore(env, actions)
+
   def test_cartpole(self) -> None:
     env0 = gym.make("CartPole-v1")
     env1 = make_gym("CartPole-v1")
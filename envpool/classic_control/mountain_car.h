@@ -99,6 +99,20 @@ class MountainCarEnv : public Env<MountainCarEnvSpec> {
     WriteState(-1.0);
   }
 
+  void Serialize(ByteWriter* writer) override {
+    writer->Write(elapsed_step_);
+    writer->Write(done_);
+    writer->Write(pos_);
+    writer->Write(vel_);
+  }
+
+  void Deserialize(ByteReader* reader) override {
+    reader->Read(&elapsed_step_);
+    reader->Read(&done_);
+    reader->Read(&pos_);
+    reader->Read(&vel_);
+  }
+
  private:
   void WriteState(float reward) {
     State state = Allocate();
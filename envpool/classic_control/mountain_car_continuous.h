@@ -106,6 +106,20 @@ class MountainCarContinuousEnv : public Env<MountainCarContinuousEnvSpec> {
     WriteState(static_cast<float>(reward));
   }
 
+  void Serialize(ByteWriter* writer) override {
+    writer->Write(elapsed_step_);
+    writer->Write(done_);
+    writer->Write(pos_);
+    writer->Write(vel_);
+  }
+
+  void Deserialize(ByteReader* reader) override {
+    reader->Read(&elapsed_step_);
+    reader->Read(&done_);
+    reader->Read(&pos_);
+    reader->Read(&vel_);
+  }
+
  private:
   void WriteState(float reward) {
     State state = Allocate();
@@ -102,6 +102,20 @@ class PendulumEnv : public Env<PendulumEnvSpec> {
     WriteState(static_cast<float>(-cost));
   }
 
+  void Serialize(ByteWriter* writer) override {
+    writer->Write(elapsed_step_);
+    writer->Write(done_);
+    writer->Write(theta_);
+    writer->Write(theta_dot_);
+  }
+
+  void Deserialize(ByteReader* reader) override {
+    reader->Read(&elapsed_step_);
+    reader->Read(&done_);
+    reader->Read(&theta_);
+    reader->Read(&theta_dot_);
+  }
+
  private:
   void WriteState(float reward) {
     State state = Allocate();
@@ -20,6 +20,7 @@
 #include <algorithm>
 #include <atomic>
 #include <memory>
+#include <stdexcept>
 #include <thread>
 #include <utility>
 #include <vector>
@@ -188,6 +189,34 @@ class AsyncEnvPool : public EnvPool<typename Env::Spec> {
     }
     action_buffer_queue_->EnqueueBulk(actions);
   }
+
+  /**
+   * Snapshot and Restore run on the caller thread and must only be used on
+   * envs that are not stepping, e.g. right after Recv in sync mode. Restore
+   * does not write a new observation: keep the one returned alongside the
+   * snapshot.
+   */
+  std::vector<std::vector<uint8_t>> Snapshot(const Array& env_ids) override {
+    TArray<int> tenv_ids(env_ids);
+    int shared_offset = tenv_ids.Shape(0);
+    std::vector<std::vector<uint8_t>> snapshots(shared_offset);
+    for (int i = 0; i < shared_offset; ++i) {
+      snapshots[i] = envs_[tenv_ids[i]]->Snapshot();
+    }
+    return snapshots;
+  }
+
+  void Restore(const Array& env_ids,
+               const std::vector<std::vector<uint8_t>>& snapshots) override {
+    TArray<int> tenv_ids(env_ids);
+    int shared_offset = tenv_ids.Shape(0);
+    if (static_cast<std::size_t>(shared_offset) != snapshots.size()) {
+      throw std::runtime_error("env_ids and snapshots have different sizes.");
+    }
+    for (int i = 0; i < shared_offset; ++i) {
+      envs_[tenv_ids[i]]->Restore(snapshots[i]);
+    }
+  }
 };
 
 #endif  // ENVPOOL_CORE_ASYNC_ENVPOOL_H_
@@ -25,6 +25,7 @@
 #include <vector>
 
 #include "envpool/core/env_spec.h"
+#include "envpool/core/serialization.h"
 #include "envpool/core/state_buffer_queue.h"
 
 template <typename Dtype>
@@ -177,6 +178,34 @@ class Env {
   }
   virtual bool IsDone() { throw std::runtime_error("is_done not implemented"); }
 
+  /**
+   * Checkpoint hooks. `Serialize` writes the full simulator state (everything
+   * that `Step` reads) and `Deserialize` overwrites it, so that a snapshot can
+   * be restored into any env of the same pool. The random generator is not
+   * part of the snapshot: it only affects future resets.
+   */
+  virtual void Serialize(ByteWriter* writer) {
+    throw std::runtime_error("serialize not implemented");
+  }
+  virtual void Deserialize(ByteReader* reader) {
+    throw std::runtime_error("deserialize not implemented");
+  }
+
+  std::vector<uint8_t> Snapshot() {
+    std::vector<uint8_t> buf;
+    ByteWriter writer(&buf);
+    writer.Write(current_step_);
+    Serialize(&writer);
+    return buf;
+  }
+
+  void Restore(const std::vector<uint8_t>& buf) {
+    ByteReader reader(buf.data(), buf.size());
+    reader.Read(&current_step_);
+    Deserialize(&reader);
+    reader.CheckEnd();
+  }
+
  protected:
   void PreProcess(StateBufferQueue* sbq, int order, bool reset) {
     sbq_ = sbq;
@@ -196,15 +225,7 @@ class Env {
   State Allocate(int player_num = 1) {
     slice_ = sbq_->Allocate(player_num, order_);
     State state(slice_.arr);
-    bool done = IsDone();
-    int max_episode_steps = spec_.config["max_episode_steps"_];
-    state["done"_] = done;
-    state["discount"_] = static_cast<float>(!done);
-    // dm_env.StepType.FIRST == 0
-    // dm_env.StepType.MID == 1
-    // dm_env.StepType.LAST == 2
-    state["step_type"_] = current_step_ == 0 ? 0 : done ? 2 : 1;
-    state["trunc"_] = done && (current_step_ >= max_episode_steps);
+    WriteDone(&state);
     state["info:env_id"_] = env_id_;
     state["elapsed_step"_] = current_step_;
     int* player_env_id(static_cast<int*>(state["info:players.env_id"_].Data()));
@@ -220,6 +241,23 @@ class Env {
         spec_.state_spec.AllValues());
     return state;
   }
+
+  /**
+   * Writes the fields that follow from `IsDone()`. `Allocate` calls it; envs
+   * that allocate their state before stepping, e.g. to render straight into
+   * it, call it again once the step is done.
+   */
+  void WriteDone(State* state) {
+    bool done = IsDone();
+    int max_episode_steps = spec_.config["max_episode_steps"_];
+    (*state)["done"_] = done;
+    (*state)["discount"_] = static_cast<float>(!done);
+    // dm_env.StepType.FIRST == 0
+    // dm_env.StepType.MID == 1
+    // dm_env.StepType.LAST == 2
+    (*state)["step_type"_] = current_step_ == 0 ? 0 : done ? 2 : 1;
+    (*state)["trunc"_] = done && (current_step_ >= max_episode_steps);
+  }
 };
 
 #endif  // ENVPOOL_CORE_ENV_H_
@@ -0,0 +1,143 @@
+// Copyright 2023 Garena Online Private Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "envpool/core/env.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "envpool/core/async_envpool.h"
+#include "envpool/core/env_spec.h"
+
+namespace {
+
+class CountdownEnvFns {
+ public:
+  static decltype(auto) DefaultConfig() {
+    return MakeDict("episode_len"_.Bind(3), "allocate_first"_.Bind(false));
+  }
+  template <typename Config>
+  static decltype(auto) StateSpec(const Config& conf) {
+    return MakeDict("obs"_.Bind(Spec<int>({-1})));
+  }
+  template <typename Config>
+  static decltype(auto) ActionSpec(const Config& conf) {
+    return MakeDict("action"_.Bind(Spec<int>({-1})));
+  }
+};
+
+using CountdownEnvSpec = EnvSpec<CountdownEnvFns>;
+
+// Ends its episodes after `episode_len` steps or at `max_episode_steps`. With
+// `allocate_first`, the state is allocated before the env changes, as envs
+// that write their observation straight into it do, and `WriteDone` fixes
+// the fields `Allocate` wrote from the previous step.
+class CountdownEnv : public Env<CountdownEnvSpec> {
+ protected:
+  int episode_len_, max_episode_steps_;
+  bool allocate_first_;
+  int elapsed_{0};
+
+ public:
+  CountdownEnv(const Spec& spec, int env_id)
+      : Env<CountdownEnvSpec>(spec, env_id),
+        episode_len_(spec.config["episode_len"_]),
+        max_episode_steps_(spec.config["max_episode_steps"_]),
+        allocate_first_(spec.config["allocate_first"_]) {}
+
+  void Reset() override {
+    Play([this] { elapsed_ = 0; });
+  }
+
+  void Step(const Action& action) override {
+    Play([this] { ++elapsed_; });
+  }
+
+  bool IsDone() override {
+    return elapsed_ >= episode_len_ || elapsed_ >= max_episode_steps_;
+  }
+
+ private:
+  template <typename Change>
+  void Play(const Change& change) {
+    if (!allocate_first_) {
+      change();
+      State state = Allocate();
+      state["obs"_] = elapsed_;
+      return;
+    }
+    State state = Allocate();
+    change();
+    WriteDone(&state);
+    state["obs"_] = elapsed_;
+  }
+};
+
+using CountdownEnvPool = AsyncEnvPool<CountdownEnv>;
+
+// The states of every step with `allocate_first` set or not.
+std::vector<std::vector<int>> RunCountdown(int episode_len,
+                                           bool allocate_first) {
+  auto config = CountdownEnvSpec::kDefaultConfig;
+  config["num_envs"_] = 1;
+  config["num_threads"_] = 1;
+  config["max_episode_steps"_] = 5;
+  config["episode_len"_] = episode_len;
+  config["allocate_first"_] = allocate_first;
+  CountdownEnvSpec spec(config);
+  CountdownEnvPool envpool(spec);
+  Array env_ids(Spec<int>({1}));
+  env_ids[0] = 0;
+  envpool.Reset(env_ids);
+  std::vector<std::vector<int>> states;
+  for (int i = 0; i < 20; ++i) {
+    CountdownEnv::State state(envpool.Recv());
+    states.push_back({
+        static_cast<int>(state["obs"_][0]),
+        static_cast<int>(static_cast<bool>(state["done"_][0])),
+        static_cast<int>(static_cast<float>(state["discount"_][0])),
+        static_cast<int>(state["step_type"_][0]),
+        static_cast<int>(static_cast<bool>(state["trunc"_][0])),
+        static_cast<int>(state["elapsed_step"_][0]),
+    });
+    std::vector<Array> raw_action({Array(Spec<int>({1})),
+                                   Array(Spec<int>({1})),
+                                   Array(Spec<int>({1}))});
+    CountdownEnv::Action action(raw_action);
+    action["env_id"_][0] = 0;
+    action["players.env_id"_][0] = 0;
+    action["action"_][0] = 0;
+    envpool.Send(action);
+  }
+  return states;
+}
+
+}  // namespace
+
+TEST(EnvTest, WriteDoneAfterAllocate) {
+  // episodes end before, and are truncated at, max_episode_steps
+  for (int episode_len : {3, 8}) {
+    auto expected = RunCountdown(episode_len, false);
+    EXPECT_EQ(RunCountdown(episode_len, true), expected) << episode_len;
+    bool last = false;
+    bool first = false;
+    for (const auto& state : expected) {
+      last |= state[3] == 2;
+      first |= state[3] == 0 && state[5] == 0;
+    }
+    EXPECT_TRUE(last);
+    EXPECT_TRUE(first);
+  }
+}
@@ -17,6 +17,7 @@
 #ifndef ENVPOOL_CORE_ENVPOOL_H_
 #define ENVPOOL_CORE_ENVPOOL_H_
 
+#include <cstdint>
 #include <utility>
 #include <vector>
 
@@ -48,6 +49,13 @@ class EnvPool {
   virtual void Reset(const Array& env_ids) {
     throw std::runtime_error("reset not implemented");
   }
+  virtual std::vector<std::vector<uint8_t>> Snapshot(const Array& env_ids) {
+    throw std::runtime_error("snapshot not implemented");
+  }
+  virtual void Restore(const Array& env_ids,
+                       const std::vector<std::vector<uint8_t>>& snapshots) {
+    throw std::runtime_error("restore not implemented");
+  }
 };
 
 #endif  // ENVPOOL_CORE_ENVPOOL_H_
@@ -25,6 +25,7 @@
 #include <exception>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <tuple>
 #include <utility>
 #include <vector>
@@ -273,6 +274,40 @@ class PyEnvPool : public EnvPool {
     py::gil_scoped_release release;
     EnvPool::Reset(arr);
   }
+
+  /**
+   * py api
+   */
+  std::vector<py::bytes> PySnapshot(const py::array& env_ids) {
+    auto arr = NumpyToArrayIncRef<int>(env_ids);
+    std::vector<std::vector<uint8_t>> snapshots;
+    {
+      py::gil_scoped_release release;
+      snapshots = EnvPool::Snapshot(arr);
+    }
+    std::vector<py::bytes> ret;
+    ret.reserve(snapshots.size());
+    for (const auto& s : snapshots) {
+      ret.emplace_back(reinterpret_cast<const char*>(s.data()), s.size());
+    }
+    return ret;
+  }
+
+  /**
+   * py api
+   */
+  void PyRestore(const py::array& env_ids,
+                 const std::vector<py::bytes>& py_snapshots) {
+    auto arr = NumpyToArrayIncRef<int>(env_ids);
+    std::vector<std::vector<uint8_t>> snapshots;
+    snapshots.reserve(py_snapshots.size());
+    for (const auto& b : py_snapshots) {
+      std::string_view view(b);
+      snapshots.emplace_back(view.begin(), view.end());
+    }
+    py::gil_scoped_release release;
+    EnvPool::Restore(arr, snapshots);
+  }
 };
 
 template <typename EnvPool>
@@ -306,6 +341,8 @@ py::object abc_meta = py::module::import("abc").attr("ABCMeta");
       .def("_recv", &ENVPOOL::PyRecv)                                \
       .def("_send", &ENVPOOL::PySend)                                \
       .def("_reset", &ENVPOOL::PyReset)                              \
+      .def("_snapshot", &ENVPOOL::PySnapshot)                        \
+      .def("_restore", &ENVPOOL::PyRestore)                          \
       .def_readonly_static("_state_keys", &ENVPOOL::py_state_keys)   \
       .def_readonly_static("_action_keys", &ENVPOOL::py_action_keys) \
       .def("_xla", &ENVPOOL::Xla);
@@ -0,0 +1,118 @@
+/*
+ * Copyright 2023-2024 FAR AI
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ENVPOOL_CORE_SERIALIZATION_H_
+#define ENVPOOL_CORE_SERIALIZATION_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+/**
+ * Appends trivially copyable values to a flat byte buffer. Used by
+ * `Env::Serialize` to produce env snapshots.
+ */
+class ByteWriter {
+ protected:
+  std::vector<uint8_t>* buf_;
+
+ public:
+  explicit ByteWriter(std::vector<uint8_t>* buf) : buf_(buf) {}
+
+  void WriteBytes(const void* data, std::size_t size) {
+    if (size == 0) {
+      return;
+    }
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    buf_->insert(buf_->end(), bytes, bytes + size);
+  }
+
+  template <typename T>
+  void Write(const T& value) {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "ByteWriter only supports trivially copyable types");
+    WriteBytes(&value, sizeof(T));
+  }
+
+  template <typename T>
+  void WriteArray(const T* data, std::size_t n) {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "ByteWriter only supports trivially copyable types");
+    WriteBytes(data, sizeof(T) * n);
+  }
+
+  [[nodiscard]] std::size_t Size() const { return buf_->size(); }
+};
+
+/**
+ * Reads back values written by `ByteWriter`, in the same order. Throws
+ * `std::runtime_error` if the buffer is too short.
+ */
+class ByteReader {
+ protected:
+  const uint8_t* data_;
+  std::size_t size_, offset_{0};
+
+ public:
+  ByteReader(const uint8_t* data, std::size_t size)
+      : data_(data), size_(size) {}
+
+  void ReadBytes(void* out, std::size_t size) {
+    if (size == 0) {
+      return;
+    }
+    if (offset_ + size > size_) {
+      throw std::runtime_error("Snapshot is truncated or corrupted.");
+    }
+    std::memcpy(out, data_ + offset_, size);
+    offset_ += size;
+  }
+
+  template <typename T>
+  void Read(T* value) {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "ByteReader only supports trivially copyable types");
+    ReadBytes(value, sizeof(T));
+  }
+
+  template <typename T>
+  T Read() {
+    T value;
+    Read(&value);
+    return value;
+  }
+
+  template <typename T>
+  void ReadArray(T* data, std::size_t n) {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "ByteReader only supports trivially copyable types");
+    ReadBytes(data, sizeof(T) * n);
+  }
+
+  [[nodiscard]] std::size_t Remaining() const { return size_ - offset_; }
+
+  void CheckEnd() const {
+    if (offset_ != size_) {
+      throw std::runtime_error(
+          "Snapshot has trailing bytes, it was taken from a different env.");
+    }
+  }
+};
+
+#endif  // ENVPOOL_CORE_SERIALIZATION_H_
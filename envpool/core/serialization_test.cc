@@ -0,0 +1,50 @@
+// Copyright 2023-2024 FAR AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "envpool/core/serialization.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <stdexcept>
+#include <vector>
+
+TEST(SerializationTest, RoundTrip) {
+  std::vector<uint8_t> buf;
+  ByteWriter writer(&buf);
+  std::array<double, 3> arr{1.5, -2.0, 3.25};
+  writer.Write(42);
+  writer.Write(true);
+  writer.WriteArray(arr.data(), arr.size());
+  EXPECT_EQ(writer.Size(), sizeof(int) + sizeof(bool) + 3 * sizeof(double));
+
+  ByteReader reader(buf.data(), buf.size());
+  EXPECT_EQ(reader.Read<int>(), 42);
+  EXPECT_EQ(reader.Read<bool>(), true);
+  std::array<double, 3> out{};
+  reader.ReadArray(out.data(), out.size());
+  EXPECT_EQ(out, arr);
+  EXPECT_EQ(reader.Remaining(), 0);
+  reader.CheckEnd();
+}
+
+TEST(SerializationTest, Truncated) {
+  std::vector<uint8_t> buf;
+  ByteWriter writer(&buf);
+  writer.Write(1);
+  ByteReader reader(buf.data(), buf.size());
+  EXPECT_THROW(reader.Read<double>(), std::runtime_error);
+  ByteReader trailing(buf.data(), buf.size());
+  EXPECT_THROW(trailing.CheckEnd(), std::runtime_error);
+}
@@ -17,6 +17,8 @@
 #ifndef ENVPOOL_MINIGRID_EMPTY_H_
 #define ENVPOOL_MINIGRID_EMPTY_H_
 
+#include <memory>
+#include <string>
 #include <utility>
 
 #include "envpool/core/async_envpool.h"
@@ -31,7 +33,8 @@ class EmptyEnvFns {
   static decltype(auto) DefaultConfig() {
     return MakeDict("size"_.Bind(8),
                     "agent_start_pos"_.Bind(std::pair<int, int>(1, 1)),
-                    "agent_start_dir"_.Bind(0), "agent_view_size"_.Bind(7));
+                    "agent_start_dir"_.Bind(0), "agent_view_size"_.Bind(7),
+                    "layout_pool_size"_.Bind(0));
   }
   template <typename Config>
   static decltype(auto) StateSpec(const Config& conf) {
@@ -60,6 +63,16 @@ class EmptyEnv : public Env<EmptyEnvSpec>, public MiniGridEmptyEnv {
                          spec.config["max_episode_steps"_],
                          spec.config["agent_view_size"_]) {
     gen_ref_ = &gen_;
+    const int layout_pool_size = spec.config["layout_pool_size"_];
+    if (layout_pool_size > 0) {
+      const int size = spec.config["size"_];
+      layout_pool_ = LayoutPool::Open(
+          "Empty-" + std::to_string(size), layout_pool_size,
+          spec.config["seed"_], [size] {
+            return std::make_unique<MiniGridEmptyEnv>(
+                size, std::pair<int, int>(1, 1), 0, 1, 7);
+          });
+    }
   }
 
   bool IsDone() override { return done_; }
@@ -74,6 +87,12 @@ class EmptyEnv : public Env<EmptyEnvSpec>, public MiniGridEmptyEnv {
     WriteState(MiniGridStep(static_cast<Act>(act)));
   }
 
+  void Serialize(ByteWriter* writer) override { MiniGridSerialize(writer); }
+
+  void Deserialize(ByteReader* reader) override {
+    MiniGridDeserialize(reader);
+  }
+
  private:
   void WriteState(float reward) {
     State state = Allocate();
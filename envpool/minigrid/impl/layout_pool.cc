@@ -0,0 +1,97 @@
+// Copyright 2023 Garena Online Private Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "envpool/minigrid/impl/layout_pool.h"
+
+#include <algorithm>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "envpool/minigrid/impl/minigrid_env.h"
+
+namespace minigrid {
+
+LayoutPool::LayoutPool(int width, int height, std::size_t size)
+    : width_(width),
+      height_(height),
+      size_(size),
+      cells_(size * width * height) {}
+
+uint16_t LayoutPool::Pack(const WorldObj& obj) {
+  if (obj.GetContains() != nullptr) {
+    throw std::runtime_error("Layout pools cannot hold boxes with contents.");
+  }
+  return static_cast<uint16_t>(obj.GetType() | (obj.GetColor() << 4) |
+                               (obj.GetDoorOpen() << 7) |
+                               (obj.GetDoorLocked() << 8));
+}
+
+std::shared_ptr<const LayoutPool> LayoutPool::Open(const std::string& key,
+                                                   std::size_t size, int seed,
+                                                   const EnvFactory& factory) {
+  static std::mutex mutex;
+  static std::map<std::string, std::weak_ptr<const LayoutPool>> cache;
+
+  if (size == 0) {
+    throw std::runtime_error("A layout pool needs at least one layout.");
+  }
+  const std::string full_key =
+      key + "#" + std::to_string(seed) + "#" + std::to_string(size);
+  std::lock_guard<std::mutex> lock(mutex);
+  auto pool = cache[full_key].lock();
+  if (pool != nullptr) {
+    return pool;
+  }
+
+  std::unique_ptr<MiniGridEnv> probe = factory();
+  std::shared_ptr<LayoutPool> layouts(
+      new LayoutPool(probe->Width(), probe->Height(), size));
+  const std::size_t num_threads = std::min<std::size_t>(
+      size, std::max(1U, std::thread::hardware_concurrency()));
+  std::vector<std::thread> workers;
+  std::vector<std::exception_ptr> errors(num_threads);
+  for (std::size_t t = 0; t < num_threads; t++) {
+    workers.emplace_back([&, t] {
+      try {
+        std::unique_ptr<MiniGridEnv> env = factory();
+        const std::size_t cells = layouts->width_ * layouts->height_;
+        for (std::size_t i = t; i < size; i += num_threads) {
+          std::seed_seq seq{seed, static_cast<int>(i)};
+          std::mt19937 gen(seq);
+          env->GenLayout(&gen, layouts->cells_.data() + i * cells);
+        }
+      } catch (...) {
+        errors[t] = std::current_exception();
+      }
+    });
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  for (const auto& error : errors) {
+    if (error != nullptr) {
+      std::rethrow_exception(error);
+    }
+  }
+  cache[full_key] = layouts;
+  return layouts;
+}
+
+}  // namespace minigrid
@@ -0,0 +1,83 @@
+/*
+ * Copyright 2023 Garena Online Private Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ENVPOOL_MINIGRID_IMPL_LAYOUT_POOL_H_
+#define ENVPOOL_MINIGRID_IMPL_LAYOUT_POOL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <glog/logging.h>
+
+#include "envpool/minigrid/impl/utils.h"
+
+namespace minigrid {
+
+class MiniGridEnv;
+
+/**
+ * Layouts pre-generated by a task's `GenGrid`, shared by every env of the
+ * task in the process. Each cell is packed into 16 bits: type in bits 0-3,
+ * color in bits 4-6, door open in bit 7 and door locked in bit 8. Boxes
+ * holding an object cannot be packed.
+ */
+class LayoutPool {
+ protected:
+  int width_, height_;
+  std::size_t size_;
+  std::vector<uint16_t> cells_;  // size_ x height_ x width_
+
+  LayoutPool(int width, int height, std::size_t size);
+
+ public:
+  // Builds a fresh env of the task, used to generate layouts.
+  using EnvFactory = std::function<std::unique_ptr<MiniGridEnv>()>;
+
+  /**
+   * Returns the pool of `key`, generating `size` layouts with envs from
+   * `factory` on all cores if it does not exist yet. Layout `i` is generated
+   * from a generator seeded with (`seed`, `i`), so the pool does not depend
+   * on the number of threads. `key` must identify everything `GenGrid`
+   * depends on.
+   */
+  static std::shared_ptr<const LayoutPool> Open(const std::string& key,
+                                                std::size_t size, int seed,
+                                                const EnvFactory& factory);
+
+  [[nodiscard]] std::size_t Size() const { return size_; }
+  [[nodiscard]] int Width() const { return width_; }
+  [[nodiscard]] int Height() const { return height_; }
+  [[nodiscard]] const uint16_t* Layout(std::size_t i) const {
+    return cells_.data() + i * width_ * height_;
+  }
+
+  static uint16_t Pack(const WorldObj& obj);
+  static WorldObj Unpack(uint16_t cell) {
+    WorldObj obj(static_cast<Type>(cell & 0xF),
+                 static_cast<Color>((cell >> 4) & 0x7));
+    obj.SetDoorOpen(((cell >> 7) & 1) != 0);
+    obj.SetDoorLocker(((cell >> 8) & 1) != 0);
+    return obj;
+  }
+};
+
+}  // namespace minigrid
+
+#endif  // ENVPOOL_MINIGRID_IMPL_LAYOUT_POOL_H_
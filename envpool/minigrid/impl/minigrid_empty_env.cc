@@ -33,25 +33,22 @@ MiniGridEmptyEnv::MiniGridEmptyEnv(int size,
 }
 
 void MiniGridEmptyEnv::GenGrid() {
-  grid_.clear();
-  for (int i = 0; i < height_; ++i) {
-    std::vector<WorldObj> temp_vec(width_);
-    for (int j = 0; j < width_; ++j) {
-      temp_vec[j] = WorldObj(kEmpty);
-    }
-    grid_.emplace_back(temp_vec);
-  }
+  grid_.assign(width_ * height_, WorldObj(kEmpty));
   // generate the surrounding walls
   for (int i = 0; i < width_; ++i) {
-    grid_[0][i] = WorldObj(kWall, kGrey);
-    grid_[height_ - 1][i] = WorldObj(kWall, kGrey);
+    At(i, 0) = WorldObj(kWall, kGrey);
+    At(i, height_ - 1) = WorldObj(kWall, kGrey);
   }
   for (int i = 0; i < height_; ++i) {
-    grid_[i][0] = WorldObj(kWall, kGrey);
-    grid_[i][width_ - 1] = WorldObj(kWall, kGrey);
+    At(0, i) = WorldObj(kWall, kGrey);
+    At(width_ - 1, i) = WorldObj(kWall, kGrey);
   }
   // place a goal square in the bottom-right corner
-  grid_[height_ - 2][width_ - 2] = WorldObj(kGoal, kGreen);
+  At(width_ - 2, height_ - 2) = WorldObj(kGoal, kGreen);
+  ResetAgent();
+}
+
+void MiniGridEmptyEnv::ResetAgent() {
   // place the agent
   if (agent_start_pos_.first == -1) {
     PlaceAgent(1, 1, width_ - 2, height_ - 2);
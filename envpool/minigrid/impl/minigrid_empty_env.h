@@ -28,6 +28,7 @@ class MiniGridEmptyEnv : public MiniGridEnv {
   MiniGridEmptyEnv(int size, std::pair<int, int> agent_start_pos,
                    int agent_start_dir, int max_steps, int agent_view_size);
   void GenGrid() override;
+  void ResetAgent() override;
 };
 
 }  // namespace minigrid
@@ -18,7 +18,7 @@
  *
  *  0 -------------> x (width_)
  *  |
- *  |    grid[y][x] -> (x, y)
+ *  |    grid[x + y * width] -> (x, y)
  *  |
  *  v
  *  y (height_)
@@ -26,19 +26,32 @@
 
 #include "envpool/minigrid/impl/minigrid_env.h"
 
+#include <stdexcept>
 #include <utility>
 
 namespace minigrid {
 
 void MiniGridEnv::MiniGridReset() {
-  GenGrid();
+  if (layout_pool_ != nullptr) {
+    std::uniform_int_distribution<std::size_t> layout_dist(
+        0, layout_pool_->Size() - 1);
+    const uint16_t* layout = layout_pool_->Layout(layout_dist(*gen_ref_));
+    grid_.resize(width_ * height_);
+    for (std::size_t i = 0; i < grid_.size(); ++i) {
+      grid_[i] = LayoutPool::Unpack(layout[i]);
+    }
+    ResetAgent();
+  } else {
+    GenGrid();
+  }
   step_count_ = 0;
   done_ = false;
   CHECK_GE(agent_pos_.first, 0);
   CHECK_GE(agent_pos_.second, 0);
   CHECK_GE(agent_dir_, 0);
-  CHECK(grid_[agent_pos_.second][agent_pos_.first].CanOverlap());
+  CHECK(At(agent_pos_.first, agent_pos_.second).CanOverlap());
   carrying_ = WorldObj(kEmpty);
+  view_dirty_ = true;
 }
 
 float MiniGridEnv::MiniGridStep(Act act) {
@@ -68,6 +81,7 @@ float MiniGridEnv::MiniGridStep(Act act) {
   CHECK_GE(fwd_pos.second, 0);
   CHECK(fwd_pos.second < height_);
   // Get the forward cell object
+  WorldObj& fwd = At(fwd_pos.first, fwd_pos.second);
   if (act == kLeft) {
     agent_dir_ -= 1;
     if (agent_dir_ < 0) {
@@ -76,51 +90,51 @@ float MiniGridEnv::MiniGridStep(Act act) {
   } else if (act == kRight) {
     agent_dir_ = (agent_dir_ + 1) % 4;
   } else if (act == kForward) {
-    if (grid_[fwd_pos.second][fwd_pos.first].CanOverlap()) {
+    if (fwd.CanOverlap()) {
       agent_pos_ = fwd_pos;
     }
-    if (grid_[fwd_pos.second][fwd_pos.first].GetType() == kGoal) {
+    if (fwd.GetType() == kGoal) {
       done_ = true;
       reward = 1 - 0.9 * (static_cast<float>(step_count_) / max_steps_);
-    } else if (grid_[fwd_pos.second][fwd_pos.first].GetType() == kLava) {
+    } else if (fwd.GetType() == kLava) {
       done_ = true;
     }
   } else if (act == kPickup) {
-    if (carrying_.GetType() == kEmpty &&
-        grid_[fwd_pos.second][fwd_pos.first].CanPickup()) {
-      carrying_ = grid_[fwd_pos.second][fwd_pos.first];
-      grid_[fwd_pos.second][fwd_pos.first] = WorldObj(kEmpty);
+    if (carrying_.GetType() == kEmpty && fwd.CanPickup()) {
+      carrying_ = fwd;
+      fwd = WorldObj(kEmpty);
+      view_dirty_ = true;
     }
   } else if (act == kDrop) {
-    if (carrying_.GetType() != kEmpty &&
-        grid_[fwd_pos.second][fwd_pos.first].GetType() == kEmpty) {
-      grid_[fwd_pos.second][fwd_pos.first] = carrying_;
+    if (carrying_.GetType() != kEmpty && fwd.GetType() == kEmpty) {
+      fwd = carrying_;
       carrying_ = WorldObj(kEmpty);
+      view_dirty_ = true;
     }
   } else if (act == kToggle) {
-    WorldObj obj = grid_[fwd_pos.second][fwd_pos.first];
-    if (obj.GetType() == kDoor) {
-      if (obj.GetDoorLocked()) {
+    if (fwd.GetType() == kDoor) {
+      if (fwd.GetDoorLocked()) {
         // If the agent has the right key to open the door
         if (carrying_.GetType() == kKey &&
-            carrying_.GetColor() == obj.GetColor()) {
-          grid_[fwd_pos.second][fwd_pos.first].SetDoorOpen(true);
+            carrying_.GetColor() == fwd.GetColor()) {
+          fwd.SetDoorOpen(true);
         }
       } else {
-        grid_[fwd_pos.second][fwd_pos.first].SetDoorOpen(!obj.GetDoorOpen());
+        fwd.SetDoorOpen(!fwd.GetDoorOpen());
       }
-    } else if (obj.GetType() == kBox) {
+      view_dirty_ = true;
+    } else if (fwd.GetType() == kBox) {
       // WARNING: this is MESSY!!!
-      auto* contains = grid_[fwd_pos.second][fwd_pos.first].GetContains();
+      auto* contains = fwd.GetContains();
       if (contains != nullptr) {
-        grid_[fwd_pos.second][fwd_pos.first] = *contains;
-        grid_[fwd_pos.second][fwd_pos.first].SetContains(
-            contains->GetContains());
+        fwd = *contains;
+        fwd.SetContains(contains->GetContains());
         contains->SetContains(nullptr);
         delete contains;
       } else {
-        grid_[fwd_pos.second][fwd_pos.first] = WorldObj(kEmpty);
+        fwd = WorldObj(kEmpty);
       }
+      view_dirty_ = true;
     }
   } else if (act != kDone) {
     CHECK(false);
@@ -141,7 +155,7 @@ void MiniGridEnv::PlaceAgent(int start_x, int start_y, int end_x, int end_y) {
   while (true) {
     int x = x_dist(*gen_ref_);
     int y = y_dist(*gen_ref_);
-    if (grid_[y][x].GetType() != kEmpty) {
+    if (At(x, y).GetType() != kEmpty) {
       continue;
     }
     agent_pos_.first = x;
@@ -155,7 +169,10 @@ void MiniGridEnv::PlaceAgent(int start_x, int start_y, int end_x, int end_y) {
   }
 }
 
-void MiniGridEnv::GenImage(const Array& obs) {
+void MiniGridEnv::UpdateView() {
+  if (!view_dirty_ && view_pos_ == agent_pos_ && view_dir_ == agent_dir_) {
+    return;
+  }
   // Get the extents of the square set of tiles visible to the agent
   // Note: the bottom extent indices are not include in the set
   int top_x;
@@ -176,66 +193,144 @@ void MiniGridEnv::GenImage(const Array& obs) {
     CHECK(false);
   }
 
-  // Generate the sub-grid observed by the agent
-  std::vector<std::vector<WorldObj>> agent_view_grid;
-  for (int i = 0; i < agent_view_size_; ++i) {
-    std::vector<WorldObj> temp_vec;
-    for (int j = 0; j < agent_view_size_; ++j) {
+  // Grid cells of the sub-grid observed by the agent
+  const int n = agent_view_size_;
+  view_cells_.resize(n * n);
+  view_scratch_.resize(n * n);
+  for (int i = 0; i < n; ++i) {
+    for (int j = 0; j < n; ++j) {
       int x = top_x + j;
       int y = top_y + i;
-      if (x >= 0 && x < width_ && y >= 0 && y < height_) {
-        temp_vec.emplace_back(WorldObj(grid_[y][x].GetType()));
-      } else {
-        temp_vec.emplace_back(WorldObj(kWall));
-      }
+      view_cells_[i * n + j] =
+          x >= 0 && x < width_ && y >= 0 && y < height_ ? x + y * width_ : -1;
     }
-    agent_view_grid.emplace_back(temp_vec);
   }
   // Rotate the agent view grid to relatively facing up
   for (int i = 0; i < agent_dir_ + 1; ++i) {
     // Rotate counter-clockwise
-    std::vector<std::vector<WorldObj>> copy_grid =
-        agent_view_grid;  // This is a deep copy
-    for (int y = 0; y < agent_view_size_; ++y) {
-      for (int x = 0; x < agent_view_size_; ++x) {
-        copy_grid[agent_view_size_ - 1 - x][y] = agent_view_grid[y][x];
+    for (int y = 0; y < n; ++y) {
+      for (int x = 0; x < n; ++x) {
+        view_scratch_[(n - 1 - x) * n + y] = view_cells_[y * n + x];
       }
     }
-    agent_view_grid = copy_grid;
+    view_cells_.swap(view_scratch_);
   }
   // Process occluders and visibility
-  // Note that this incurs some performance cost
-  int agent_pos_x = agent_view_size_ / 2;
-  int agent_pos_y = agent_view_size_ - 1;
-  std::vector<std::vector<bool>> vis_mask(agent_view_size_,
-                                          std::vector<bool>(agent_view_size_));
-  for (auto& row : vis_mask) {
-    std::fill(row.begin(), row.end(), 0);
-  }
-  if (!see_through_walls_) {
-    // TODO(siping): Process_vis
-    vis_mask[agent_pos_y][agent_pos_x] = true;
-  } else {
-    for (auto& row : vis_mask) {
-      std::fill(row.begin(), row.end(), 1);
+  // TODO(siping): Process_vis; without see_through_walls_ only the agent's
+  // own cell is visible for now.
+  view_visible_.assign(n * n, see_through_walls_ ? 1 : 0);
+  view_visible_[(n - 1) * n + n / 2] = 1;
+
+  view_pos_ = agent_pos_;
+  view_dir_ = agent_dir_;
+  view_dirty_ = false;
+}
+
+void MiniGridEnv::GenImage(const Array& obs) {
+  UpdateView();
+  const int n = agent_view_size_;
+  const int agent_cell = (n - 1) * n + n / 2;
+  auto* data = static_cast<uint8_t*>(obs.Data());
+  for (int y = 0; y < n; ++y) {
+    for (int x = 0; x < n; ++x) {
+      const int k = y * n + x;
+      if (!view_visible_[k]) {
+        continue;
+      }
+      Type type;
+      Color color;
+      int state = 0;
+      if (k == agent_cell) {
+        // Let the agent see what it's carrying
+        type = carrying_.GetType();
+        color = type != kEmpty ? carrying_.GetColor() : DefaultColor(kEmpty);
+        state = type != kEmpty ? carrying_.GetState() : 0;
+      } else if (view_cells_[k] < 0) {
+        type = kWall;
+        color = DefaultColor(kWall);
+      } else {
+        // Cells are shown by type only, in the type's default color
+        type = grid_[view_cells_[k]].GetType();
+        color = DefaultColor(type);
+      }
+      // Transpose to align with the python library
+      uint8_t* out = data + (x * n + y) * 3;
+      out[0] = static_cast<uint8_t>(type);
+      out[1] = static_cast<uint8_t>(color);
+      out[2] = static_cast<uint8_t>(state);
     }
   }
-  // Let the agent see what it's carrying
-  if (carrying_.GetType() != kEmpty) {
-    agent_view_grid[agent_pos_y][agent_pos_x] = carrying_;
-  } else {
-    agent_view_grid[agent_pos_y][agent_pos_x] = WorldObj(kEmpty);
-  }
-  for (int y = 0; y < agent_view_size_; ++y) {
-    for (int x = 0; x < agent_view_size_; ++x) {
-      if (vis_mask[y][x]) {
-        // Transpose to align with the python library
-        obs(x, y, 0) = static_cast<uint8_t>(agent_view_grid[y][x].GetType());
-        obs(x, y, 1) = static_cast<uint8_t>(agent_view_grid[y][x].GetColor());
-        obs(x, y, 2) = static_cast<uint8_t>(agent_view_grid[y][x].GetState());
-      }
+}
+
+void MiniGridEnv::GenLayout(std::mt19937* gen, uint16_t* out) {
+  gen_ref_ = gen;
+  GenGrid();
+  for (std::size_t i = 0; i < grid_.size(); ++i) {
+    out[i] = LayoutPool::Pack(grid_[i]);
+  }
+}
+
+// Objects are written depth-first, a box is followed by what it contains.
+static void WriteObj(ByteWriter* writer, WorldObj* obj) {
+  writer->Write(static_cast<uint8_t>(obj->GetType()));
+  writer->Write(static_cast<uint8_t>(obj->GetColor()));
+  writer->Write(obj->GetDoorOpen());
+  writer->Write(obj->GetDoorLocked());
+  WorldObj* contains = obj->GetContains();
+  writer->Write(contains != nullptr);
+  if (contains != nullptr) {
+    WriteObj(writer, contains);
+  }
+}
+
+static void ReadObj(ByteReader* reader, WorldObj* obj) {
+  auto type = static_cast<Type>(reader->Read<uint8_t>());
+  auto color = static_cast<Color>(reader->Read<uint8_t>());
+  // WorldObj copies are shallow, so free the old contents before assigning
+  // and attach the new ones after
+  delete obj->GetContains();
+  obj->SetContains(nullptr);
+  *obj = WorldObj(type, color);
+  obj->SetDoorOpen(reader->Read<bool>());
+  obj->SetDoorLocker(reader->Read<bool>());
+  if (reader->Read<bool>()) {
+    auto* contains = new WorldObj();
+    ReadObj(reader, contains);
+    obj->SetContains(contains);
+  }
+}
+
+void MiniGridEnv::MiniGridSerialize(ByteWriter* writer) {
+  if (grid_.empty()) {
+    throw std::runtime_error("Env must be reset before snapshot/restore.");
+  }
+  writer->Write(step_count_);
+  writer->Write(done_);
+  writer->Write(agent_pos_.first);
+  writer->Write(agent_pos_.second);
+  writer->Write(agent_dir_);
+  for (int y = 0; y < height_; ++y) {
+    for (int x = 0; x < width_; ++x) {
+      WriteObj(writer, &At(x, y));
+    }
+  }
+  WriteObj(writer, &carrying_);
+}
+
+void MiniGridEnv::MiniGridDeserialize(ByteReader* reader) {
+  reader->Read(&step_count_);
+  reader->Read(&done_);
+  reader->Read(&agent_pos_.first);
+  reader->Read(&agent_pos_.second);
+  reader->Read(&agent_dir_);
+  grid_.resize(width_ * height_);
+  for (int y = 0; y < height_; ++y) {
+    for (int x = 0; x < width_; ++x) {
+      ReadObj(reader, &At(x, y));
     }
   }
+  ReadObj(reader, &carrying_);
+  view_dirty_ = true;
 }
 
 }  // namespace minigrid
@@ -17,11 +17,15 @@
 #ifndef ENVPOOL_MINIGRID_IMPL_MINIGRID_ENV_H_
 #define ENVPOOL_MINIGRID_IMPL_MINIGRID_ENV_H_
 
+#include <cstdint>
+#include <memory>
 #include <random>
 #include <utility>
 #include <vector>
 
 #include "envpool/core/array.h"
+#include "envpool/core/serialization.h"
+#include "envpool/minigrid/impl/layout_pool.h"
 #include "envpool/minigrid/impl/utils.h"
 
 namespace minigrid {
@@ -40,8 +44,25 @@ class MiniGridEnv {
   int agent_start_dir_;
   int agent_dir_;
   std::mt19937* gen_ref_;
-  std::vector<std::vector<WorldObj>> grid_;
+  // Row-major, cell (x, y) at grid_[x + y * width_].
+  std::vector<WorldObj> grid_;
   WorldObj carrying_;
+  // If set, resets copy a random layout from the pool and only call
+  // `ResetAgent`, instead of running `GenGrid`.
+  std::shared_ptr<const LayoutPool> layout_pool_;
+
+  // The agent's view as of the last `GenImage`: for each view cell, row-major
+  // with the agent facing up, the grid cell it shows (-1 outside the grid)
+  // and whether it is visible. Only rebuilt when the agent moved or turned,
+  // or `view_dirty_` was set because a cell's see-through state changed.
+  std::vector<int> view_cells_, view_scratch_;
+  std::vector<uint8_t> view_visible_;
+  std::pair<int, int> view_pos_{-1, -1};
+  int view_dir_{-1};
+  bool view_dirty_{true};
+
+  WorldObj& At(int x, int y) { return grid_[x + y * width_]; }
+  void UpdateView();
 
  public:
   MiniGridEnv() { carrying_ = WorldObj(kEmpty); }
@@ -50,7 +71,16 @@ class MiniGridEnv {
   void PlaceAgent(int start_x = 0, int start_y = 0, int end_x = -1,
                   int end_y = -1);
   void GenImage(const Array& obs);
+  void MiniGridSerialize(ByteWriter* writer);
+  void MiniGridDeserialize(ByteReader* reader);
+  // Runs `GenGrid` with `gen` and packs the grid into `out`, for `LayoutPool`.
+  void GenLayout(std::mt19937* gen, uint16_t* out);
+  [[nodiscard]] int Width() const { return width_; }
+  [[nodiscard]] int Height() const { return height_; }
+  virtual ~MiniGridEnv() = default;
   virtual void GenGrid() {}
+  // Places the agent on a generated grid; `GenGrid` ends by calling it.
+  virtual void ResetAgent() {}
 };
 
 }  // namespace minigrid
@@ -17,7 +17,7 @@
 #ifndef ENVPOOL_MINIGRID_IMPL_UTILS_H_
 #define ENVPOOL_MINIGRID_IMPL_UTILS_H_
 
-#include <unordered_map>
+#include <cstdint>
 
 namespace minigrid {
 
@@ -60,19 +60,38 @@ enum Type {
   kAgent = 10
 };
 
-// constants
-static const std::unordered_map<Type, bool> kCanSeeBehind{
-    {kEmpty, true}, {kWall, false}, {kGoal, true},
-    {kFloor, true}, {kLava, true},  {kKey, true},
-    {kBall, true},  {kDoor, true},  {kBox, true}};
-static const std::unordered_map<Type, bool> kCanOverlap{
-    {kEmpty, true}, {kWall, false}, {kGoal, true},
-    {kFloor, true}, {kLava, true},  {kKey, false},
-    {kBall, false}, {kDoor, true},  {kBox, false}};
-static const std::unordered_map<Type, bool> kCanPickup{
-    {kEmpty, false}, {kWall, false}, {kGoal, false},
-    {kFloor, false}, {kLava, false}, {kKey, true},
-    {kBall, true},   {kDoor, false}, {kBox, true}};
+// constants: one bit per `Type` that has the property
+constexpr uint32_t TypeBit(Type type) { return uint32_t{1} << type; }
+constexpr uint32_t kCanSeeBehind =
+    TypeBit(kEmpty) | TypeBit(kGoal) | TypeBit(kFloor) | TypeBit(kLava) |
+    TypeBit(kKey) | TypeBit(kBall) | TypeBit(kDoor) | TypeBit(kBox);
+constexpr uint32_t kCanOverlap = TypeBit(kEmpty) | TypeBit(kGoal) |
+                                 TypeBit(kFloor) | TypeBit(kLava) |
+                                 TypeBit(kDoor);
+constexpr uint32_t kCanPickup = TypeBit(kKey) | TypeBit(kBall) | TypeBit(kBox);
+constexpr bool HasProperty(uint32_t mask, Type type) {
+  return (mask & TypeBit(type)) != 0;
+}
+
+// Color of an object created without one.
+inline Color DefaultColor(Type type) {
+  switch (type) {
+    case kEmpty:
+    case kLava:
+      return kRed;
+    case kWall:
+      return kGrey;
+    case kGoal:
+      return kGreen;
+    case kKey:
+    case kBall:
+    case kFloor:
+      return kBlue;
+    default:
+      CHECK(false);
+      return kUnassigned;
+  }
+}
 
 // object class
 
@@ -88,47 +107,26 @@ class WorldObj {
  public:
   explicit WorldObj(Type type = kEmpty, Color color = kUnassigned,
                     WorldObj* contains = nullptr)
-      : type_(type), contains_(contains) {
-    if (color == kUnassigned) {
-      switch (type) {
-        case kEmpty:
-        case kLava:
-          color_ = kRed;
-          break;
-        case kWall:
-          color_ = kGrey;
-          break;
-        case kGoal:
-          color_ = kGreen;
-          break;
-        case kKey:
-        case kBall:
-        case kFloor:
-          color_ = kBlue;
-          break;
-        default:
-          CHECK(false);
-          break;
-      }
-    } else {
-      color_ = color;
-    }
-  }
+      : type_(type),
+        color_(color == kUnassigned ? DefaultColor(type) : color),
+        contains_(contains) {}
   ~WorldObj() { delete contains_; }
   [[nodiscard]] bool CanSeeBehind() const {
-    return door_open_ && kCanSeeBehind.at(type_);
+    return door_open_ && HasProperty(kCanSeeBehind, type_);
   }
   [[nodiscard]] bool CanOverlap() const {
-    return door_open_ && kCanOverlap.at(type_);
+    return door_open_ && HasProperty(kCanOverlap, type_);
+  }
+  [[nodiscard]] bool CanPickup() const {
+    return HasProperty(kCanPickup, type_);
   }
-  [[nodiscard]] bool CanPickup() const { return kCanPickup.at(type_); }
   [[nodiscard]] bool GetDoorOpen() const { return door_open_; }
   void SetDoorOpen(bool flag) { door_open_ = flag; }
   [[nodiscard]] bool GetDoorLocked() const { return door_locked_; }
   void SetDoorLocker(bool flag) { door_locked_ = flag; }
-  Type GetType() { return type_; }
-  Color GetColor() { return color_; }
-  int GetState() {
+  [[nodiscard]] Type GetType() const { return type_; }
+  [[nodiscard]] Color GetColor() const { return color_; }
+  [[nodiscard]] int GetState() const {
     if (type_ != kDoor) {
       return 0;
     }
@@ -140,7 +138,7 @@ class WorldObj {
     }
     return 1;
   }
-  WorldObj* GetContains() { return contains_; }
+  [[nodiscard]] WorldObj* GetContains() const { return contains_; }
   void SetContains(WorldObj* contains) {
     if (contains != nullptr && type_ != kBox) {
       CHECK(false);
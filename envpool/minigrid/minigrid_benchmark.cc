@@ -0,0 +1,75 @@
+// Copyright 2023 Garena Online Private Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures steps/sec of `MiniGridStep` plus `GenImage` on Empty layouts of
+// growing size, i.e. the game logic of `EmptyEnv::Step` without the envpool
+// machinery.
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "envpool/core/array.h"
+#include "envpool/minigrid/impl/minigrid_empty_env.h"
+
+namespace minigrid {
+
+class BenchmarkEnv : public MiniGridEmptyEnv {
+ public:
+  BenchmarkEnv(int size, std::mt19937* gen)
+      : MiniGridEmptyEnv(size, {-1, -1}, -1, 4 * size * size, 7) {
+    gen_ref_ = gen;
+  }
+  [[nodiscard]] bool Done() const { return done_; }
+};
+
+}  // namespace minigrid
+
+int main(int argc, char** argv) {
+  const int64_t num_steps = argc > 1 ? std::stoll(argv[1]) : 10000000;
+  std::mt19937 gen(0);
+  std::vector<minigrid::Act> actions(4096);
+  for (auto& action : actions) {
+    // mostly turn and move, like a random policy over the movement actions
+    action = static_cast<minigrid::Act>(gen() % 3);
+  }
+
+  for (int size : {5, 8, 16, 32, 64}) {
+    minigrid::BenchmarkEnv env(size, &gen);
+    Array obs(Spec<uint8_t>({7, 7, 3}));
+    const auto* obs_data = static_cast<const uint8_t*>(obs.Data());
+    env.MiniGridReset();
+    int64_t checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int64_t i = 0; i < num_steps; i++) {
+      if (env.Done()) {
+        env.MiniGridReset();
+      }
+      checksum += static_cast<int64_t>(
+          env.MiniGridStep(actions[i % actions.size()]) * 1000);
+      env.GenImage(obs);
+      checksum += obs_data[i % obs.size];
+    }
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    std::cout << "Empty-" << size << "x" << size << ": "
+              << static_cast<double>(num_steps) / elapsed.count()
+              << " steps/s (checksum " << checksum << ")" << std::endl;
+  }
+  return 0;
+}
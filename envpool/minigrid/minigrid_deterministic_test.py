@@ -19,6 +19,7 @@ import numpy as np
 from absl.testing import absltest
 
 import envpool.minigrid.registration  # noqa: F401
+from envpool.python.testing import check_snapshot_restore
 from envpool.registration import make_gym
 
 
@@ -52,10 +53,27 @@ class _MiniGridEnvPoolDeterministicTest(absltest.TestCase):
       )
     assert same_count == 0, f"{same_count=}"
 
+  def test_snapshot_restore(self) -> None:
+    num_envs = 4
+    env = make_gym("MiniGrid-Empty-Random-6x6-v0", num_envs=num_envs, seed=0)
+    env.reset()
+    act_space = env.action_space
+    act_space.seed(0)
+    actions = [
+      np.array([act_space.sample() for _ in range(num_envs)])
+      for _ in range(10)
+    ]
+    check_snapshot_restore(env, actions, obs_keys=["image", "direction"])
+
   def test_empty(self) -> None:
     self.run_deterministic_check("MiniGrid-Empty-Random-5x5-v0")
     self.run_deterministic_check("MiniGrid-Empty-Random-6x6-v0")
 
+  def test_empty_layout_pool(self) -> None:
+    self.run_deterministic_check(
+      "MiniGrid-Empty-Random-5x5-v0", layout_pool_size=64
+    )
+
 
 if __name__ == "__main__":
   absltest.main()
@@ -41,12 +41,18 @@ class AcrobotEnvFns {
  public:
   static decltype(auto) DefaultConfig() {
     return MakeDict("frame_skip"_.Bind(1),
-                    "task_name"_.Bind(std::string("swingup")));
+                    "task_name"_.Bind(std::string("swingup")),
+                    "from_pixels"_.Bind(false), "render_width"_.Bind(84),
+                    "render_height"_.Bind(84), "render_camera_id"_.Bind(0),
+                    "mjb_cache_dir"_.Bind(std::string("")),
+                    "model_randomization"_.Bind(std::string("")),
+                    "reset_pool_size"_.Bind(0), "reset_pool_refresh"_.Bind(0));
   }
   template <typename Config>
   static decltype(auto) StateSpec(const Config& conf) {
     return MakeDict("obs:orientations"_.Bind(Spec<mjtNum>({4})),
-                    "obs:velocity"_.Bind(Spec<mjtNum>({2}))
+                    "obs:velocity"_.Bind(Spec<mjtNum>({2})),
+                    "obs:pixels"_.Bind(PixelSpec(conf))
 #ifdef ENVPOOL_TEST
                         ,
                     "info:qpos0"_.Bind(Spec<mjtNum>({2}))
@@ -73,7 +79,10 @@ class AcrobotEnv : public Env<AcrobotEnvSpec>, public MujocoEnv {
         MujocoEnv(
             spec.config["base_path"_],
             GetAcrobotXML(spec.config["base_path"_], spec.config["task_name"_]),
-            spec.config["frame_skip"_], spec.config["max_episode_steps"_]),
+            spec.config["frame_skip"_], spec.config["max_episode_steps"_],
+            spec.config["mjb_cache_dir"_], spec.config["model_randomization"_],
+            spec.config["reset_pool_size"_],
+            spec.config["reset_pool_refresh"_]),
         id_upper_arm_(mj_name2id(model_, mjOBJ_XBODY, "upper_arm")),
         id_lower_arm_(mj_name2id(model_, mjOBJ_XBODY, "lower_arm")),
         id_target_(mj_name2id(model_, mjOBJ_SITE, "target")),
@@ -81,6 +90,8 @@ class AcrobotEnv : public Env<AcrobotEnvSpec>, public MujocoEnv {
         id_shoulder_(GetQposId(model_, "shoulder")),
         id_elbow_(GetQposId(model_, "elbow")),
         is_sparse_(spec.config["task_name"_] == "swingup_sparse") {
+    CheckRenderConfig(spec.config);
+    OpenResetPool<AcrobotEnv>(spec, &gen_);
     const std::string& task_name = spec.config["task_name"_];
     if (task_name != "swingup" && task_name != "swingup_sparse") {
       throw std::runtime_error("Unknown task_name " + task_name +
@@ -99,7 +110,7 @@ class AcrobotEnv : public Env<AcrobotEnvSpec>, public MujocoEnv {
   bool IsDone() override { return done_; }
 
   void Reset() override {
-    ControlReset();
+    ControlReset(&gen_);
     WriteState();
   }
 
@@ -116,11 +127,16 @@ class AcrobotEnv : public Env<AcrobotEnvSpec>, public MujocoEnv {
   }
   bool TaskShouldTerminateEpisode() override { return false; }
 
+  void Serialize(ByteWriter* writer) override { MujocoSerialize(writer); }
+
+  void Deserialize(ByteReader* reader) override { MujocoDeserialize(reader); }
+
  private:
   void WriteState() {
     State state = Allocate();
     state["reward"_] = reward_;
     state["discount"_] = discount_;
+    RenderPixels(state["obs:pixels"_], spec_.config["render_camera_id"_]);
     // obs
     const auto& orientations = Orientations();
     state["obs:orientations"_].Assign(orientations.begin(),
@@ -40,12 +40,18 @@ class BallInCupEnvFns {
  public:
   static decltype(auto) DefaultConfig() {
     return MakeDict("frame_skip"_.Bind(10),
-                    "task_name"_.Bind(std::string("catch")));
+                    "task_name"_.Bind(std::string("catch")),
+                    "from_pixels"_.Bind(false), "render_width"_.Bind(84),
+                    "render_height"_.Bind(84), "render_camera_id"_.Bind(0),
+                    "mjb_cache_dir"_.Bind(std::string("")),
+                    "model_randomization"_.Bind(std::string("")),
+                    "reset_pool_size"_.Bind(0), "reset_pool_refresh"_.Bind(0));
   }
   template <typename Config>
   static decltype(auto) StateSpec(const Config& conf) {
     return MakeDict("obs:position"_.Bind(Spec<mjtNum>({4})),
-                    "obs:velocity"_.Bind(Spec<mjtNum>({4}))
+                    "obs:velocity"_.Bind(Spec<mjtNum>({4})),
+                    "obs:pixels"_.Bind(PixelSpec(conf))
 #ifdef ENVPOOL_TEST
                         ,
                     "info:qpos0"_.Bind(Spec<mjtNum>({4}))
@@ -71,11 +77,17 @@ class BallInCupEnv : public Env<BallInCupEnvSpec>, public MujocoEnv {
                   GetBallInCupXML(spec.config["base_path"_],
                                   spec.config["task_name"_]),
                   spec.config["frame_skip"_],
-                  spec.config["max_episode_steps"_]),
+                  spec.config["max_episode_steps"_],
+                  spec.config["mjb_cache_dir"_],
+                  spec.config["model_randomization"_],
+                  spec.config["reset_pool_size"_],
+                  spec.config["reset_pool_refresh"_]),
         id_target_(mj_name2id(model_, mjOBJ_SITE, "target")),
         id_ball_(mj_name2id(model_, mjOBJ_XBODY, "ball")),
         id_ball_x_(GetQposId(model_, "ball_x")),
         id_ball_z_(GetQposId(model_, "ball_z")) {
+    CheckRenderConfig(spec.config);
+    OpenResetPool<BallInCupEnv>(spec, &gen_);
     const std::string& task_name = spec.config["task_name"_];
     if (task_name != "catch") {
       throw std::runtime_error("Unknown task_name " + task_name +
@@ -101,7 +113,7 @@ class BallInCupEnv : public Env<BallInCupEnvSpec>, public MujocoEnv {
   bool IsDone() override { return done_; }
 
   void Reset() override {
-    ControlReset();
+    ControlReset(&gen_);
     WriteState();
   }
 
@@ -115,11 +127,16 @@ class BallInCupEnv : public Env<BallInCupEnvSpec>, public MujocoEnv {
 
   bool TaskShouldTerminateEpisode() override { return false; }
 
+  void Serialize(ByteWriter* writer) override { MujocoSerialize(writer); }
+
+  void Deserialize(ByteReader* reader) override { MujocoDeserialize(reader); }
+
  private:
   void WriteState() {
     State state = Allocate();
     state["reward"_] = reward_;
     state["discount"_] = discount_;
+    RenderPixels(state["obs:pixels"_], spec_.config["render_camera_id"_]);
     // obs
     state["obs:position"_].Assign(data_->qpos, model_->nq);
     state["obs:velocity"_].Assign(data_->qvel, model_->nv);
@@ -51,7 +51,12 @@ class CartpoleEnvFns {
  public:
   static decltype(auto) DefaultConfig() {
     return MakeDict("frame_skip"_.Bind(1),
-                    "task_name"_.Bind(std::string("balance")));
+                    "task_name"_.Bind(std::string("balance")),
+                    "from_pixels"_.Bind(false), "render_width"_.Bind(84),
+                    "render_height"_.Bind(84), "render_camera_id"_.Bind(0),
+                    "mjb_cache_dir"_.Bind(std::string("")),
+                    "model_randomization"_.Bind(std::string("")),
+                    "reset_pool_size"_.Bind(0), "reset_pool_refresh"_.Bind(0));
   }
   template <typename Config>
   static decltype(auto) StateSpec(const Config& conf) {
@@ -69,7 +74,8 @@ class CartpoleEnvFns {
                                " for dmc cartpole.");
     }
     return MakeDict("obs:position"_.Bind(Spec<mjtNum>({1 + 2 * n_poles})),
-                    "obs:velocity"_.Bind(Spec<mjtNum>({1 + n_poles}))
+                    "obs:velocity"_.Bind(Spec<mjtNum>({1 + n_poles})),
+                    "obs:pixels"_.Bind(PixelSpec(conf))
 #ifdef ENVPOOL_TEST
                         ,
                     "info:qpos0"_.Bind(Spec<mjtNum>({1 + n_poles})),
@@ -101,7 +107,11 @@ class CartpoleEnv : public Env<CartpoleEnvSpec>, public MujocoEnv {
                   GetCartpoleXML(spec.config["base_path"_],
                                  spec.config["task_name"_]),
                   spec.config["frame_skip"_],
-                  spec.config["max_episode_steps"_]),
+                  spec.config["max_episode_steps"_],
+                  spec.config["mjb_cache_dir"_],
+                  spec.config["model_randomization"_],
+                  spec.config["reset_pool_size"_],
+                  spec.config["reset_pool_refresh"_]),
         id_slider_(GetQposId(model_, "slider")),
         id_hinge1_(GetQposId(model_, "hinge_1")),
         is_sparse_(spec.config["task_name"_] == "balance_sparse" ||
@@ -110,6 +120,8 @@ class CartpoleEnv : public Env<CartpoleEnvSpec>, public MujocoEnv {
                     spec.config["task_name"_] == "swingup_sparse" ||
                     spec.config["task_name"_] == "two_poles" ||
                     spec.config["task_name"_] == "three_poles") {
+    CheckRenderConfig(spec.config);
+    OpenResetPool<CartpoleEnv>(spec, &gen_);
 #ifdef ENVPOOL_TEST
     qvel0_.reset(new mjtNum[model_->nv]);
 #endif
@@ -140,7 +152,7 @@ class CartpoleEnv : public Env<CartpoleEnvSpec>, public MujocoEnv {
   bool IsDone() override { return done_; }
 
   void Reset() override {
-    ControlReset();
+    ControlReset(&gen_);
     WriteState();
   }
 
@@ -183,11 +195,16 @@ class CartpoleEnv : public Env<CartpoleEnvSpec>, public MujocoEnv {
   }
   bool TaskShouldTerminateEpisode() override { return false; }
 
+  void Serialize(ByteWriter* writer) override { MujocoSerialize(writer); }
+
+  void Deserialize(ByteReader* reader) override { MujocoDeserialize(reader); }
+
  private:
   void WriteState() {
     State state = Allocate();
     state["reward"_] = reward_;
     state["discount"_] = discount_;
+    RenderPixels(state["obs:pixels"_], spec_.config["render_camera_id"_]);
     // obs
     const auto& position = BoundedPosition();
     state["obs:position"_].Assign(position.data(), position.size());
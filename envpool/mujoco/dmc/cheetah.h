@@ -40,12 +40,18 @@ class CheetahEnvFns {
  public:
   static decltype(auto) DefaultConfig() {
     return MakeDict("frame_skip"_.Bind(1),
-                    "task_name"_.Bind(std::string("run")));
+                    "task_name"_.Bind(std::string("run")),
+                    "from_pixels"_.Bind(false), "render_width"_.Bind(84),
+                    "render_height"_.Bind(84), "render_camera_id"_.Bind(0),
+                    "mjb_cache_dir"_.Bind(std::string("")),
+                    "model_randomization"_.Bind(std::string("")),
+                    "reset_pool_size"_.Bind(0), "reset_pool_refresh"_.Bind(0));
   }
   template <typename Config>
   static decltype(auto) StateSpec(const Config& conf) {
     return MakeDict("obs:position"_.Bind(Spec<mjtNum>({8})),
-                    "obs:velocity"_.Bind(Spec<mjtNum>({9}))
+                    "obs:velocity"_.Bind(Spec<mjtNum>({9})),
+                    "obs:pixels"_.Bind(PixelSpec(conf))
 #ifdef ENVPOOL_TEST
                         ,
                     "info:qpos0"_.Bind(Spec<mjtNum>({9}))
@@ -71,8 +77,13 @@ class CheetahEnv : public Env<CheetahEnvSpec>, public MujocoEnv {
         MujocoEnv(
             spec.config["base_path"_],
             GetCheetahXML(spec.config["base_path"_], spec.config["task_name"_]),
-            spec.config["frame_skip"_], spec.config["max_episode_steps"_]),
+            spec.config["frame_skip"_], spec.config["max_episode_steps"_],
+            spec.config["mjb_cache_dir"_], spec.config["model_randomization"_],
+            spec.config["reset_pool_size"_],
+            spec.config["reset_pool_refresh"_]),
         id_torso_subtreelinvel_(GetSensorId(model_, "torso_subtreelinvel")) {
+    CheckRenderConfig(spec.config);
+    OpenResetPool<CheetahEnv>(spec, &gen_);
     const std::string& task_name = spec.config["task_name"_];
     if (task_name != "run") {
       throw std::runtime_error("Unknown task_name " + task_name +
@@ -100,7 +111,7 @@ class CheetahEnv : public Env<CheetahEnvSpec>, public MujocoEnv {
   bool IsDone() override { return done_; }
 
   void Reset() override {
-    ControlReset();
+    ControlReset(&gen_);
     WriteState();
   }
 
@@ -118,11 +129,16 @@ class CheetahEnv : public Env<CheetahEnvSpec>, public MujocoEnv {
 
   bool TaskShouldTerminateEpisode() override { return false; }
 
+  void Serialize(ByteWriter* writer) override { MujocoSerialize(writer); }
+
+  void Deserialize(ByteReader* reader) override { MujocoDeserialize(reader); }
+
  private:
   void WriteState() {
     State state = Allocate();
     state["reward"_] = reward_;
     state["discount"_] = discount_;
+    RenderPixels(state["obs:pixels"_], spec_.config["render_camera_id"_]);
     // obs
     state["obs:position"_].Assign(data_->qpos + 1, model_->nq - 1);
     state["obs:velocity"_].Assign(data_->qvel, model_->nv);
@@ -41,7 +41,12 @@ class FingerEnvFns {
  public:
   static decltype(auto) DefaultConfig() {
     return MakeDict("frame_skip"_.Bind(2),
-                    "task_name"_.Bind(std::string("spin")));
+                    "task_name"_.Bind(std::string("spin")),
+                    "from_pixels"_.Bind(false), "render_width"_.Bind(84),
+                    "render_height"_.Bind(84), "render_camera_id"_.Bind(0),
+                    "mjb_cache_dir"_.Bind(std::string("")),
+                    "model_randomization"_.Bind(std::string("")),
+                    "reset_pool_size"_.Bind(0), "reset_pool_refresh"_.Bind(0));
   }
   template <typename Config>
   static decltype(auto) StateSpec(const Config& conf) {
@@ -49,7 +54,8 @@ class FingerEnvFns {
                     "obs:velocity"_.Bind(Spec<mjtNum>({3})),
                     "obs:touch"_.Bind(Spec<mjtNum>({2})),
                     "obs:target_position"_.Bind(Spec<mjtNum>({2})),
-                    "obs:dist_to_target"_.Bind(Spec<mjtNum>({}))
+                    "obs:dist_to_target"_.Bind(Spec<mjtNum>({})),
+                    "obs:pixels"_.Bind(PixelSpec(conf))
 #ifdef ENVPOOL_TEST
                         ,
                     "info:qpos0"_.Bind(Spec<mjtNum>({3})),
@@ -89,7 +95,10 @@ class FingerEnv : public Env<FingerEnvSpec>, public MujocoEnv {
         MujocoEnv(
             spec.config["base_path"_],
             GetFingerXML(spec.config["base_path"_], spec.config["task_name"_]),
-            spec.config["frame_skip"_], spec.config["max_episode_steps"_]),
+            spec.config["frame_skip"_], spec.config["max_episode_steps"_],
+            spec.config["mjb_cache_dir"_], spec.config["model_randomization"_],
+            spec.config["reset_pool_size"_],
+            spec.config["reset_pool_refresh"_]),
         id_site_target_(mj_name2id(model_, mjOBJ_SITE, "target")),
         id_site_tip_(mj_name2id(model_, mjOBJ_SITE, "tip")),
         id_hinge_(GetQvelId(model_, "hinge")),
@@ -105,6 +114,8 @@ class FingerEnv : public Env<FingerEnvSpec>, public MujocoEnv {
         id_touchtop_(GetSensorId(model_, "touchtop")),
         id_touchbottom_(GetSensorId(model_, "touchbottom")),
         is_spin_(spec.config["task_name"_] == "spin") {
+    CheckRenderConfig(spec.config);
+    OpenResetPool<FingerEnv>(spec, &gen_);
     const std::string& task_name = spec.config["task_name"_];
     if (task_name == "turn_easy") {
       target_radius_ = kEasyTargetSize;
@@ -153,7 +164,7 @@ class FingerEnv : public Env<FingerEnvSpec>, public MujocoEnv {
   bool IsDone() override { return done_; }
 
   void Reset() override {
-    ControlReset();
+    ControlReset(&gen_);
     WriteState();
   }
 
@@ -172,11 +183,28 @@ class FingerEnv : public Env<FingerEnvSpec>, public MujocoEnv {
 
   bool TaskShouldTerminateEpisode() override { return false; }
 
+  void TaskSerialize(ByteWriter* writer) override {
+    writer->Write(model_->site_pos[id_site_target_]);
+    writer->Write(model_->site_pos[id_site_target_ + 2]);
+    writer->Write(model_->site_size[id_site_target_]);
+  }
+
+  void TaskDeserialize(ByteReader* reader) override {
+    reader->Read(&model_->site_pos[id_site_target_]);
+    reader->Read(&model_->site_pos[id_site_target_ + 2]);
+    reader->Read(&model_->site_size[id_site_target_]);
+  }
+
+  void Serialize(ByteWriter* writer) override { MujocoSerialize(writer); }
+
+  void Deserialize(ByteReader* reader) override { MujocoDeserialize(reader); }
+
  private:
   void WriteState() {
     State state = Allocate();
     state["reward"_] = reward_;
     state["discount"_] = discount_;
+    RenderPixels(state["obs:pixels"_], spec_.config["render_camera_id"_]);
     // obs
     const auto& bound_pos = BoundedPosition();
     const auto& velocity = Velocity();
@@ -41,14 +41,20 @@ class FishEnvFns {
  public:
   static decltype(auto) DefaultConfig() {
     return MakeDict("frame_skip"_.Bind(10),
-                    "task_name"_.Bind(std::string("upright")));
+                    "task_name"_.Bind(std::string("upright")),
+                    "from_pixels"_.Bind(false), "render_width"_.Bind(84),
+                    "render_height"_.Bind(84), "render_camera_id"_.Bind(0),
+                    "mjb_cache_dir"_.Bind(std::string("")),
+                    "model_randomization"_.Bind(std::string("")),
+                    "reset_pool_size"_.Bind(0), "reset_pool_refresh"_.Bind(0));
   }
   template <typename Config>
   static decltype(auto) StateSpec(const Config& conf) {
     return MakeDict("obs:joint_angles"_.Bind(Spec<mjtNum>({7})),
                     "obs:upright"_.Bind(Spec<mjtNum>({})),
                     "obs:velocity"_.Bind(Spec<mjtNum>({13})),
-                    "obs:target"_.Bind(Spec<mjtNum>({3}))
+                    "obs:target"_.Bind(Spec<mjtNum>({3})),
+                    "obs:pixels"_.Bind(PixelSpec(conf))
 #ifdef ENVPOOL_TEST
                         ,
                     "info:qpos0"_.Bind(Spec<mjtNum>({14})),
@@ -83,12 +89,17 @@ class FishEnv : public Env<FishEnvSpec>, public MujocoEnv {
         MujocoEnv(
             spec.config["base_path"_],
             GetFishXML(spec.config["base_path"_], spec.config["task_name"_]),
-            spec.config["frame_skip"_], spec.config["max_episode_steps"_]),
+            spec.config["frame_skip"_], spec.config["max_episode_steps"_],
+            spec.config["mjb_cache_dir"_], spec.config["model_randomization"_],
+            spec.config["reset_pool_size"_],
+            spec.config["reset_pool_refresh"_]),
         id_mouth_(mj_name2id(model_, mjOBJ_GEOM, "mouth")),
         id_qpos_root_(GetQposId(model_, "root")),
         id_torso_(mj_name2id(model_, mjOBJ_XBODY, "torso")),
         id_target_(mj_name2id(model_, mjOBJ_GEOM, "target")),
         is_swim_(spec.config["task_name"_] == "swim") {
+    CheckRenderConfig(spec.config);
+    OpenResetPool<FishEnv>(spec, &gen_);
     const std::string& task_name = spec.config["task_name"_];
     if (task_name != "upright" && task_name != "swim") {
       throw std::runtime_error("Unknown task_name " + task_name +
@@ -143,7 +154,7 @@ class FishEnv : public Env<FishEnvSpec>, public MujocoEnv {
   bool IsDone() override { return done_; }
 
   void Reset() override {
-    ControlReset();
+    ControlReset(&gen_);
     WriteState();
   }
 
@@ -169,11 +180,24 @@ class FishEnv : public Env<FishEnvSpec>, public MujocoEnv {
 
   bool TaskShouldTerminateEpisode() override { return false; }
 
+  void TaskSerialize(ByteWriter* writer) override {
+    writer->WriteArray(model_->geom_pos + id_target_ * 3, 3);
+  }
+
+  void TaskDeserialize(ByteReader* reader) override {
+    reader->ReadArray(model_->geom_pos + id_target_ * 3, 3);
+  }
+
+  void Serialize(ByteWriter* writer) override { MujocoSerialize(writer); }
+
+  void Deserialize(ByteReader* reader) override { MujocoDeserialize(reader); }
+
  private:
   void WriteState() {
     State state = Allocate();
     state["reward"_] = reward_;
     state["discount"_] = discount_;
+    RenderPixels(state["obs:pixels"_], spec_.config["render_camera_id"_]);
     // obs
     const auto& joint_angles = JointAngles();
     state["obs:joint_angles"_].Assign(joint_angles.begin(),
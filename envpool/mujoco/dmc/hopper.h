@@ -39,13 +39,19 @@ class HopperEnvFns {
  public:
   static decltype(auto) DefaultConfig() {
     return MakeDict("frame_skip"_.Bind(4),
-                    "task_name"_.Bind(std::string("stand")));
+                    "task_name"_.Bind(std::string("stand")),
+                    "from_pixels"_.Bind(false), "render_width"_.Bind(84),
+                    "render_height"_.Bind(84), "render_camera_id"_.Bind(0),
+                    "mjb_cache_dir"_.Bind(std::string("")),
+                    "model_randomization"_.Bind(std::string("")),
+                    "reset_pool_size"_.Bind(0), "reset_pool_refresh"_.Bind(0));
   }
   template <typename Config>
   static decltype(auto) StateSpec(const Config& conf) {
     return MakeDict("obs:position"_.Bind(Spec<mjtNum>({6})),
                     "obs:velocity"_.Bind(Spec<mjtNum>({7})),
-                    "obs:touch"_.Bind(Spec<mjtNum>({2}))
+                    "obs:touch"_.Bind(Spec<mjtNum>({2})),
+                    "obs:pixels"_.Bind(PixelSpec(conf))
 #ifdef ENVPOOL_TEST
                         ,
                     "info:qpos0"_.Bind(Spec<mjtNum>({7}))
@@ -73,12 +79,17 @@ class HopperEnv : public Env<HopperEnvSpec>, public MujocoEnv {
         MujocoEnv(
             spec.config["base_path"_],
             GetHopperXML(spec.config["base_path"_], spec.config["task_name"_]),
-            spec.config["frame_skip"_], spec.config["max_episode_steps"_]),
+            spec.config["frame_skip"_], spec.config["max_episode_steps"_],
+            spec.config["mjb_cache_dir"_], spec.config["model_randomization"_],
+            spec.config["reset_pool_size"_],
+            spec.config["reset_pool_refresh"_]),
         id_torso_(mj_name2id(model_, mjOBJ_XBODY, "torso")),
         id_foot_(mj_name2id(model_, mjOBJ_XBODY, "foot")),
         id_torso_subtreelinvel_(GetSensorId(model_, "torso_subtreelinvel")),
         id_touch_toe_(GetSensorId(model_, "touch_toe")),
         id_touch_heel_(GetSensorId(model_, "touch_heel")) {
+    CheckRenderConfig(spec.config);
+    OpenResetPool<HopperEnv>(spec, &gen_);
     const std::string& task_name = spec.config["task_name"_];
     if (task_name == "stand") {
       hopping_ = false;
@@ -101,7 +112,7 @@ class HopperEnv : public Env<HopperEnvSpec>, public MujocoEnv {
   bool IsDone() override { return done_; }
 
   void Reset() override {
-    ControlReset();
+    ControlReset(&gen_);
     WriteState();
   }
 
@@ -131,6 +142,10 @@ class HopperEnv : public Env<HopperEnvSpec>, public MujocoEnv {
 
   bool TaskShouldTerminateEpisode() override { return false; }
 
+  void Serialize(ByteWriter* writer) override { MujocoSerialize(writer); }
+
+  void Deserialize(ByteReader* reader) override { MujocoDeserialize(reader); }
+
  private:
   mjtNum Height() {
     // return (self.named.data.xipos['torso', 'z'] -
@@ -153,6 +168,7 @@ class HopperEnv : public Env<HopperEnvSpec>, public MujocoEnv {
     State state = Allocate();
     state["reward"_] = reward_;
     state["discount"_] = discount_;
+    RenderPixels(state["obs:pixels"_], spec_.config["render_camera_id"_]);
     // obs
     state["obs:position"_].Assign(data_->qpos + 1, model_->nq - 1);
     state["obs:velocity"_].Assign(data_->qvel, model_->nv);
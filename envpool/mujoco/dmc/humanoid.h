@@ -41,7 +41,12 @@ class HumanoidEnvFns {
  public:
   static decltype(auto) DefaultConfig() {
     return MakeDict("frame_skip"_.Bind(5),
-                    "task_name"_.Bind(std::string("stand")));
+                    "task_name"_.Bind(std::string("stand")),
+                    "from_pixels"_.Bind(false), "render_width"_.Bind(84),
+                    "render_height"_.Bind(84), "render_camera_id"_.Bind(0),
+                    "mjb_cache_dir"_.Bind(std::string("")),
+                    "model_randomization"_.Bind(std::string("")),
+                    "reset_pool_size"_.Bind(0), "reset_pool_refresh"_.Bind(0));
   }
   template <typename Config>
   static decltype(auto) StateSpec(const Config& conf) {
@@ -51,7 +56,8 @@ class HumanoidEnvFns {
                     "obs:torso_vertical"_.Bind(Spec<mjtNum>({3})),
                     "obs:com_velocity"_.Bind(Spec<mjtNum>({3})),
                     "obs:position"_.Bind(Spec<mjtNum>({28})),
-                    "obs:velocity"_.Bind(Spec<mjtNum>({27}))
+                    "obs:velocity"_.Bind(Spec<mjtNum>({27})),
+                    "obs:pixels"_.Bind(PixelSpec(conf))
 #ifdef ENVPOOL_TEST
                         ,
                     "info:qpos0"_.Bind(Spec<mjtNum>({28}))
@@ -90,7 +96,11 @@ class HumanoidEnv : public Env<HumanoidEnvSpec>, public MujocoEnv {
                   GetHumanoidXML(spec.config["base_path"_],
                                  spec.config["task_name"_]),
                   spec.config["frame_skip"_],
-                  spec.config["max_episode_steps"_]),
+                  spec.config["max_episode_steps"_],
+                  spec.config["mjb_cache_dir"_],
+                  spec.config["model_randomization"_],
+                  spec.config["reset_pool_size"_],
+                  spec.config["reset_pool_refresh"_]),
         id_head_(mj_name2id(model_, mjOBJ_XBODY, "head")),
         id_left_hand_(mj_name2id(model_, mjOBJ_XBODY, "left_hand")),
         id_left_foot_(mj_name2id(model_, mjOBJ_XBODY, "left_foot")),
@@ -99,6 +109,8 @@ class HumanoidEnv : public Env<HumanoidEnvSpec>, public MujocoEnv {
         id_torso_(mj_name2id(model_, mjOBJ_XBODY, "torso")),
         id_torso_subtreelinvel_(GetSensorId(model_, "torso_subtreelinvel")),
         is_pure_state_(spec.config["task_name"_] == "run_pure_state") {
+    CheckRenderConfig(spec.config);
+    OpenResetPool<HumanoidEnv>(spec, &gen_);
     const std::string& task_name = spec.config["task_name"_];
     if (task_name == "stand") {
       move_speed_ = 0;
@@ -131,7 +143,7 @@ class HumanoidEnv : public Env<HumanoidEnvSpec>, public MujocoEnv {
   bool IsDone() override { return done_; }
 
   void Reset() override {
-    ControlReset();
+    ControlReset(&gen_);
     WriteState();
   }
 
@@ -176,11 +188,16 @@ class HumanoidEnv : public Env<HumanoidEnvSpec>, public MujocoEnv {
 
   bool TaskShouldTerminateEpisode() override { return false; }
 
+  void Serialize(ByteWriter* writer) override { MujocoSerialize(writer); }
+
+  void Deserialize(ByteReader* reader) override { MujocoDeserialize(reader); }
+
  private:
   void WriteState() {
     State state = Allocate();
     state["reward"_] = reward_;
     state["discount"_] = discount_;
+    RenderPixels(state["obs:pixels"_], spec_.config["render_camera_id"_]);
     // obs
     const auto& joint_angles = JointAngles();
     const auto& extremities = Extremities();
@@ -41,7 +41,12 @@ class HumanoidCMUEnvFns {
  public:
   static decltype(auto) DefaultConfig() {
     return MakeDict("frame_skip"_.Bind(10),
-                    "task_name"_.Bind(std::string("stand")));
+                    "task_name"_.Bind(std::string("stand")),
+                    "from_pixels"_.Bind(false), "render_width"_.Bind(84),
+                    "render_height"_.Bind(84), "render_camera_id"_.Bind(0),
+                    "mjb_cache_dir"_.Bind(std::string("")),
+                    "model_randomization"_.Bind(std::string("")),
+                    "reset_pool_size"_.Bind(0), "reset_pool_refresh"_.Bind(0));
   }
   template <typename Config>
   static decltype(auto) StateSpec(const Config& conf) {
@@ -50,7 +55,8 @@ class HumanoidCMUEnvFns {
                     "obs:extremities"_.Bind(Spec<mjtNum>({12})),
                     "obs:torso_vertical"_.Bind(Spec<mjtNum>({3})),
                     "obs:com_velocity"_.Bind(Spec<mjtNum>({3})),
-                    "obs:velocity"_.Bind(Spec<mjtNum>({62}))
+                    "obs:velocity"_.Bind(Spec<mjtNum>({62})),
+                    "obs:pixels"_.Bind(PixelSpec(conf))
 #ifdef ENVPOOL_TEST
                         ,
                     "info:qpos0"_.Bind(Spec<mjtNum>({63}))
@@ -87,7 +93,11 @@ class HumanoidCMUEnv : public Env<HumanoidCMUEnvSpec>, public MujocoEnv {
                   GetHumanoidCMUXML(spec.config["base_path"_],
                                     spec.config["task_name"_]),
                   spec.config["frame_skip"_],
-                  spec.config["max_episode_steps"_]),
+                  spec.config["max_episode_steps"_],
+                  spec.config["mjb_cache_dir"_],
+                  spec.config["model_randomization"_],
+                  spec.config["reset_pool_size"_],
+                  spec.config["reset_pool_refresh"_]),
         id_head_(mj_name2id(model_, mjOBJ_XBODY, "head")),
         id_lhand_(mj_name2id(model_, mjOBJ_XBODY, "lhand")),
         id_lfoot_(mj_name2id(model_, mjOBJ_XBODY, "lfoot")),
@@ -95,6 +105,8 @@ class HumanoidCMUEnv : public Env<HumanoidCMUEnvSpec>, public MujocoEnv {
         id_rfoot_(mj_name2id(model_, mjOBJ_XBODY, "rfoot")),
         id_thorax_(mj_name2id(model_, mjOBJ_XBODY, "thorax")),
         id_thorax_subtreelinvel_(GetSensorId(model_, "thorax_subtreelinvel")) {
+    CheckRenderConfig(spec.config);
+    OpenResetPool<HumanoidCMUEnv>(spec, &gen_);
     const std::string& task_name = spec.config["task_name"_];
     if (task_name == "stand") {
       move_speed_ = 0;
@@ -125,7 +137,7 @@ class HumanoidCMUEnv : public Env<HumanoidCMUEnvSpec>, public MujocoEnv {
   bool IsDone() override { return done_; }
 
   void Reset() override {
-    ControlReset();
+    ControlReset(&gen_);
     WriteState();
   }
 
@@ -169,11 +181,16 @@ class HumanoidCMUEnv : public Env<HumanoidCMUEnvSpec>, public MujocoEnv {
 
   bool TaskShouldTerminateEpisode() override { return false; }
 
+  void Serialize(ByteWriter* writer) override { MujocoSerialize(writer); }
+
+  void Deserialize(ByteReader* reader) override { MujocoDeserialize(reader); }
+
  private:
   void WriteState() {
     State state = Allocate();
     state["reward"_] = reward_;
     state["discount"_] = discount_;
+    RenderPixels(state["obs:pixels"_], spec_.config["render_camera_id"_]);
     // obs
     const auto& joint_angles = JointAngles();
     const auto& extremities = Extremities();
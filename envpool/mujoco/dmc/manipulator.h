@@ -57,7 +57,12 @@ class ManipulatorEnvFns {
  public:
   static decltype(auto) DefaultConfig() {
     return MakeDict("frame_skip"_.Bind(10),
-                    "task_name"_.Bind(std::string("bring_ball")));
+                    "task_name"_.Bind(std::string("bring_ball")),
+                    "from_pixels"_.Bind(false), "render_width"_.Bind(84),
+                    "render_height"_.Bind(84), "render_camera_id"_.Bind(0),
+                    "mjb_cache_dir"_.Bind(std::string("")),
+                    "model_randomization"_.Bind(std::string("")),
+                    "reset_pool_size"_.Bind(0), "reset_pool_refresh"_.Bind(0));
   }
   template <typename Config>
   static decltype(auto) StateSpec(const Config& conf) {
@@ -67,7 +72,8 @@ class ManipulatorEnvFns {
                     "obs:hand_pos"_.Bind(Spec<mjtNum>({4})),
                     "obs:object_pos"_.Bind(Spec<mjtNum>({4})),
                     "obs:object_vel"_.Bind(Spec<mjtNum>({3})),
-                    "obs:target_pos"_.Bind(Spec<mjtNum>({4}))
+                    "obs:target_pos"_.Bind(Spec<mjtNum>({4})),
+                    "obs:pixels"_.Bind(PixelSpec(conf))
 #ifdef ENVPOOL_TEST
                         ,
                     "info:qpos0"_.Bind(Spec<mjtNum>({11})),
@@ -119,7 +125,11 @@ class ManipulatorEnv : public Env<ManipulatorEnvSpec>, public MujocoEnv {
                   GetManipulatorXML(spec.config["base_path"_],
                                     spec.config["task_name"_]),
                   spec.config["frame_skip"_],
-                  spec.config["max_episode_steps"_]),
+                  spec.config["max_episode_steps"_],
+                  spec.config["mjb_cache_dir"_],
+                  spec.config["model_randomization"_],
+                  spec.config["reset_pool_size"_],
+                  spec.config["reset_pool_refresh"_]),
         use_peg_(spec.config["task_name"_] == "bring_peg" ||
                  spec.config["task_name"_] == "insert_peg"),
         insert_(spec.config["task_name"_] == "insert_peg" ||
@@ -147,6 +157,8 @@ class ManipulatorEnv : public Env<ManipulatorEnvSpec>, public MujocoEnv {
         id_site_peg_tip_(mj_name2id(model_, mjOBJ_SITE, "peg_tip")),
         id_site_ball_(mj_name2id(model_, mjOBJ_SITE, "ball")),
         id_site_target_ball_(mj_name2id(model_, mjOBJ_SITE, "target_ball")) {
+    CheckRenderConfig(spec.config);
+    OpenResetPool<ManipulatorEnv>(spec, &gen_);
     for (std::size_t i = 0; i < kArmJoints.size(); ++i) {
       id_arm_joints_[i] =
           mj_name2id(model_, mjOBJ_JOINT, kArmJoints[i].c_str());
@@ -261,7 +273,7 @@ class ManipulatorEnv : public Env<ManipulatorEnvSpec>, public MujocoEnv {
   bool IsDone() override { return done_; }
 
   void Reset() override {
-    ControlReset();
+    ControlReset(&gen_);
     WriteState();
   }
 
@@ -280,6 +292,24 @@ class ManipulatorEnv : public Env<ManipulatorEnvSpec>, public MujocoEnv {
 
   bool TaskShouldTerminateEpisode() override { return false; }
 
+  void TaskSerialize(ByteWriter* writer) override {
+    writer->WriteArray(model_->body_pos + id_body_receptacle_ * 3, 3);
+    writer->WriteArray(model_->body_quat + id_body_receptacle_ * 4, 4);
+    writer->WriteArray(model_->body_pos + id_body_target_ * 3, 3);
+    writer->WriteArray(model_->body_quat + id_body_target_ * 4, 4);
+  }
+
+  void TaskDeserialize(ByteReader* reader) override {
+    reader->ReadArray(model_->body_pos + id_body_receptacle_ * 3, 3);
+    reader->ReadArray(model_->body_quat + id_body_receptacle_ * 4, 4);
+    reader->ReadArray(model_->body_pos + id_body_target_ * 3, 3);
+    reader->ReadArray(model_->body_quat + id_body_target_ * 4, 4);
+  }
+
+  void Serialize(ByteWriter* writer) override { MujocoSerialize(writer); }
+
+  void Deserialize(ByteReader* reader) override { MujocoDeserialize(reader); }
+
  private:
   std::array<mjtNum, 16> BoundedJointPos() {
     std::array<mjtNum, 16> bound;
@@ -364,6 +394,7 @@ class ManipulatorEnv : public Env<ManipulatorEnvSpec>, public MujocoEnv {
     State state = Allocate();
     state["reward"_] = reward_;
     state["discount"_] = discount_;
+    RenderPixels(state["obs:pixels"_], spec_.config["render_camera_id"_]);
     // obs
     state["obs:arm_pos"_].Assign(bounded_joint_pos.begin(),
                                  bounded_joint_pos.size());
@@ -20,6 +20,7 @@ import numpy as np
 from absl.testing import absltest
 
 import envpool.mujoco.dmc.registration  # noqa: F401
+from envpool.python.testing import check_snapshot_restore
 from envpool.registration import make_dm
 
 
@@ -164,6 +165,73 @@ class _MujocoDmcDeterministicTest(absltest.TestCase):
     for task in ["run", "stand", "walk"]:
       self.check("walker", task, obs_keys)
 
+  def test_snapshot_restore(self) -> None:
+    num_envs = 4
+    env = make_dm("CheetahRun-v1", num_envs=num_envs, seed=0)
+    env.reset()
+    act_spec = env.action_spec()
+    actions = np.random.uniform(
+      low=act_spec.minimum,
+      high=act_spec.maximum,
+      size=(10, num_envs, *act_spec.shape),
+    )
+    env.step(actions[0])
+    check_snapshot_restore(env, actions, obs_keys=["position", "velocity"])
+
+  def test_reset_pool(self) -> None:
+    kwargs = dict(num_envs=2, max_episode_steps=5, reset_pool_size=4)
+    env0 = make_dm("ReacherEasy-v1", seed=0, **kwargs)
+    env1 = make_dm("ReacherEasy-v1", seed=0, **kwargs)
+    env2 = make_dm("ReacherEasy-v1", seed=0, reset_pool_refresh=8, **kwargs)
+    action = np.zeros((2, 2))
+    starts, refreshed_starts = set(), set()
+    for _ in range(120):
+      ts0 = env0.step(action)
+      ts1 = env1.step(action)
+      ts2 = env2.step(action)
+      np.testing.assert_allclose(
+        ts0.observation.position, ts1.observation.position
+      )
+      if ts0.step_type[0] == dm_env.StepType.FIRST:
+        starts.add(ts0.observation.to_target[0].tobytes())
+        refreshed_starts.add(ts2.observation.to_target[0].tobytes())
+    # every episode starts from one of the pooled states, unless refreshed
+    self.assertGreater(len(starts), 1)
+    self.assertLessEqual(len(starts), 4)
+    self.assertGreater(len(refreshed_starts), 4)
+
+  def test_pixels(self) -> None:
+    kwargs = dict(
+      num_envs=2, from_pixels=True, render_width=64, render_height=48
+    )
+    env0 = make_dm("CartpoleSwingup-v1", seed=0, **kwargs)
+    env1 = make_dm("CartpoleSwingup-v1", seed=0, **kwargs)
+    self.assertEqual(env0.observation_spec().pixels.shape, (48, 64, 3))
+    pixels = env0.reset().observation.pixels
+    np.testing.assert_array_equal(pixels, env1.reset().observation.pixels)
+    self.assertEqual(pixels.shape, (2, 48, 64, 3))
+    self.assertEqual(pixels.dtype, np.uint8)
+    self.assertGreater(pixels.std(), 0)
+    action = np.ones((2, 1))
+    for _ in range(20):
+      obs0 = env0.step(action).observation.pixels
+      obs1 = env1.step(action).observation.pixels
+      np.testing.assert_array_equal(obs0, obs1)
+    # the cart has moved
+    self.assertFalse(np.array_equal(obs0, pixels))
+    # off unless asked for
+    env = make_dm("CartpoleSwingup-v1", num_envs=1)
+    self.assertEqual(env.reset().observation.pixels.shape, (1, 0, 0, 3))
+    # bad settings fail when the pool is made, not in a worker thread
+    with self.assertRaises(RuntimeError):
+      make_dm(
+        "CartpoleSwingup-v1", num_envs=1, from_pixels=True, render_camera_id=9
+      )
+    with self.assertRaises(RuntimeError):
+      make_dm(
+        "CartpoleSwingup-v1", num_envs=1, from_pixels=True, render_width=0
+      )
+
 
 if __name__ == "__main__":
   absltest.main()
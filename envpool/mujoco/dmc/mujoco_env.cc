@@ -17,39 +17,65 @@
 #include <cassert>
 #include <cmath>
 #include <cstring>
+#include <memory>
+#include <random>
 #include <stdexcept>
+#include <utility>
 #include <vector>
 
+#include "envpool/mujoco/model_cache.h"
+
 namespace mujoco_dmc {
 
 MujocoEnv::MujocoEnv(const std::string& base_path, const std::string& raw_xml,
-                     int n_sub_steps, int max_episode_steps)
-    : n_sub_steps_(n_sub_steps),
+                     int n_sub_steps, int max_episode_steps,
+                     const std::string& cache_dir,
+                     const std::string& randomization, int reset_pool_size,
+                     int reset_pool_refresh)
+    : reset_pool_size_(reset_pool_size),
+      reset_pool_refresh_(reset_pool_refresh),
+      n_sub_steps_(n_sub_steps),
       max_episode_steps_(max_episode_steps),
       elapsed_step_(max_episode_steps + 1) {
-  // initialize vfs from common assets and raw xml
-  // https://github.com/deepmind/dm_control/blob/1.0.2/dm_control/mujoco/wrapper/core.py#L158
-  // https://github.com/deepmind/mujoco/blob/main/python/mujoco/structs.cc
-  // MjModelWrapper::LoadXML
-  std::unique_ptr<mjVFS, void (*)(mjVFS*)> vfs(new mjVFS, [](mjVFS* vfs) {
-    mj_deleteVFS(vfs);
-    delete vfs;
-  });
-  mj_defaultVFS(vfs.get());
-  // save raw_xml into vfs
-  std::string model_filename("model_.xml");
-  mj_makeEmptyFileVFS(vfs.get(), model_filename.c_str(), raw_xml.size());
-  std::memcpy(vfs->filedata[vfs->nfile - 1], raw_xml.c_str(), raw_xml.size());
   // https://github.com/deepmind/dm_control/blob/1.0.2/dm_control/suite/common/__init__.py#L28
   std::vector<std::string> common_assets_name(
       {"./common/materials.xml", "./common/skybox.xml", "./common/visual.xml"});
+  std::vector<std::string> common_assets;
+  std::string key = raw_xml;
   for (const auto& asset_name : common_assets_name) {
-    std::string content = GetFileContent(base_path, asset_name);
-    mj_makeEmptyFileVFS(vfs.get(), asset_name.c_str(), content.size());
-    std::memcpy(vfs->filedata[vfs->nfile - 1], content.c_str(), content.size());
+    common_assets.push_back(GetFileContent(base_path, asset_name));
+    key += "\n" + asset_name + "\n" + common_assets.back();
   }
+  auto compile = [&](char* error, int error_size) {
+    // initialize vfs from common assets and raw xml
+    // https://github.com/deepmind/dm_control/blob/1.0.2/dm_control/mujoco/wrapper/core.py#L158
+    // https://github.com/deepmind/mujoco/blob/main/python/mujoco/structs.cc
+    // MjModelWrapper::LoadXML
+    std::unique_ptr<mjVFS, void (*)(mjVFS*)> vfs(new mjVFS, [](mjVFS* vfs) {
+      mj_deleteVFS(vfs);
+      delete vfs;
+    });
+    mj_defaultVFS(vfs.get());
+    // save raw_xml into vfs
+    std::string model_filename("model_.xml");
+    mj_makeEmptyFileVFS(vfs.get(), model_filename.c_str(), raw_xml.size());
+    std::memcpy(vfs->filedata[vfs->nfile - 1], raw_xml.c_str(),
+                raw_xml.size());
+    for (std::size_t i = 0; i < common_assets.size(); ++i) {
+      const std::string& content = common_assets[i];
+      mj_makeEmptyFileVFS(vfs.get(), common_assets_name[i].c_str(),
+                          content.size());
+      std::memcpy(vfs->filedata[vfs->nfile - 1], content.c_str(),
+                  content.size());
+    }
+    return mj_loadXML(model_filename.c_str(), vfs.get(), error, error_size);
+  };
   // create model and data
-  model_ = mj_loadXML(model_filename.c_str(), vfs.get(), error_.begin(), 1000);
+  model_template_ = mujoco_common::LoadModel(key, cache_dir, compile);
+  model_key_ = std::move(key);
+  randomizer_ =
+      mujoco_common::ModelRandomizer(model_template_.get(), randomization);
+  model_ = mj_copyModel(nullptr, model_template_.get());
   data_ = mj_makeData(model_);
 #ifdef ENVPOOL_TEST
   qpos0_.reset(new mjtNum[model_->nq]);
@@ -63,15 +89,46 @@ MujocoEnv::~MujocoEnv() {
 
 // rl control Environment
 // https://github.com/deepmind/dm_control/blob/1.0.2/dm_control/rl/control.py#L77
-void MujocoEnv::ControlReset() {
+void MujocoEnv::ControlReset(std::mt19937* gen) {
   elapsed_step_ = 0;
   discount_ = 1.0;
   done_ = false;
+  if (reset_pool_ == nullptr) {
+    InitializeEpisode(gen);
+    PhysicsAfterReset();  // second mj_forward
+    return;
+  }
+  if (reset_pool_refresh_ > 0 && reset_pool_uses_ >= reset_pool_refresh_) {
+    reset_pool_ = reset_pool_->Next();
+    reset_pool_uses_ = 0;
+  }
+  std::uniform_int_distribution<int> dist(0, reset_pool_size_ - 1);
+  const auto& state = reset_pool_->State(dist(*gen));
+  // clears what the state leaves out, e.g. ctrl, as a full reset does
+  mj_resetData(model_, data_);
+  ByteReader reader(state.data(), state.size());
+  ReadPhysicsState(&reader);
+  ++reset_pool_uses_;
+  // the state is taken before the last mj_forward of a full reset, which
+  // therefore computes the same mjData
+  PhysicsAfterReset();
+}
+
+void MujocoEnv::GenResetState(std::seed_seq* seq,
+                              std::vector<uint8_t>* state) {
+  gen_ref_->seed(*seq);
+  InitializeEpisode(gen_ref_);
+  state->clear();
+  ByteWriter writer(state);
+  WritePhysicsState(&writer);
+}
+
+void MujocoEnv::InitializeEpisode(std::mt19937* gen) {
+  randomizer_.Randomize(model_, gen);
   TaskInitializeEpisodeMjcf();
   // attention: no keyframe_id
   PhysicsReset();  // first mj_forward
   TaskInitializeEpisode();
-  PhysicsAfterReset();  // second mj_forward
 }
 
 // https://github.com/deepmind/dm_control/blob/1.0.2/dm_control/rl/control.py#L94
@@ -94,6 +151,43 @@ void MujocoEnv::ControlStep(const mjtNum* action) {
   }
 }
 
+void MujocoEnv::MujocoSerialize(ByteWriter* writer) {
+  writer->Write(elapsed_step_);
+  writer->Write(reward_);
+  writer->Write(discount_);
+  writer->Write(done_);
+  WritePhysicsState(writer);
+}
+
+void MujocoEnv::MujocoDeserialize(ByteReader* reader) {
+  reader->Read(&elapsed_step_);
+  reader->Read(&reward_);
+  reader->Read(&discount_);
+  reader->Read(&done_);
+  ReadPhysicsState(reader);
+  PhysicsForward();
+}
+
+void MujocoEnv::WritePhysicsState(ByteWriter* writer) {
+  writer->Write(data_->time);
+  writer->WriteArray(data_->qpos, model_->nq);
+  writer->WriteArray(data_->qvel, model_->nv);
+  writer->WriteArray(data_->act, model_->na);
+  writer->WriteArray(data_->qacc_warmstart, model_->nv);
+  randomizer_.Serialize(model_, writer);
+  TaskSerialize(writer);
+}
+
+void MujocoEnv::ReadPhysicsState(ByteReader* reader) {
+  reader->Read(&data_->time);
+  reader->ReadArray(data_->qpos, model_->nq);
+  reader->ReadArray(data_->qvel, model_->nv);
+  reader->ReadArray(data_->act, model_->na);
+  reader->ReadArray(data_->qacc_warmstart, model_->nv);
+  randomizer_.Deserialize(model_, reader);
+  TaskDeserialize(reader);
+}
+
 // Task
 // https://github.com/deepmind/dm_control/blob/1.0.2/dm_control/suite/base.py#L73
 void MujocoEnv::TaskBeforeStep(const mjtNum* action) {
@@ -105,6 +199,19 @@ float MujocoEnv::TaskGetReward() {
 float MujocoEnv::TaskGetDiscount() { return 1.0; }
 bool MujocoEnv::TaskShouldTerminateEpisode() { return false; }
 
+void MujocoEnv::RenderPixels(const Array& pixels, int camera_id) {
+  if (pixels.size == 0) {
+    return;
+  }
+  if (renderer_ == nullptr) {
+    // created on first use, so on the thread that steps this env
+    renderer_ = std::make_unique<SoftwareRenderer>(
+        model_, static_cast<int>(pixels.Shape(1)),
+        static_cast<int>(pixels.Shape(0)), camera_id);
+  }
+  renderer_->Render(model_, data_, static_cast<uint8_t*>(pixels.Data()));
+}
+
 // Physics
 // https://github.com/deepmind/dm_control/blob/1.0.2/dm_control/mujoco/engine.py#L263
 void MujocoEnv::PhysicsReset(int keyframe_id) {
@@ -20,14 +20,32 @@
 #include <mjxmacro.h>
 #include <mujoco.h>
 
+#include <cstdint>
 #include <memory>
 #include <random>
 #include <string>
+#include <vector>
 
+#include "envpool/core/array.h"
+#include "envpool/core/dict.h"
+#include "envpool/core/serialization.h"
+#include "envpool/mujoco/dmc/render.h"
+#include "envpool/mujoco/dmc/reset_pool.h"
 #include "envpool/mujoco/dmc/utils.h"
+#include "envpool/mujoco/model_randomizer.h"
 
 namespace mujoco_dmc {
 
+// `obs:pixels`, height x width x 3, which is empty unless `from_pixels`.
+template <typename Config>
+Spec<uint8_t> PixelSpec(const Config& conf) {
+  if (!conf["from_pixels"_]) {
+    return Spec<uint8_t>({0, 0, 3}, {0, 255});
+  }
+  return Spec<uint8_t>({conf["render_height"_], conf["render_width"_], 3},
+                       {0, 255});
+}
+
 /*
  * This class combines with dmc Task and Physics API.
  *
@@ -39,7 +57,21 @@ namespace mujoco_dmc {
  */
 class MujocoEnv {
  private:
-  std::array<char, 1000> error_;
+  // compiled model this env's `model_` was copied from, kept alive so that
+  // the other envs of the process copy it instead of compiling again
+  std::shared_ptr<const mjModel> model_template_;
+  mujoco_common::ModelRandomizer randomizer_;
+  // XML and assets `model_template_` was compiled from
+  std::string model_key_;
+  // initial states drawn ahead of time, see `ControlReset`
+  int reset_pool_size_, reset_pool_refresh_, reset_pool_uses_{0};
+  std::shared_ptr<const ResetPool> reset_pool_;
+
+  // `ControlReset` up to the last mj_forward
+  void InitializeEpisode(std::mt19937* gen);
+  // the part of a snapshot that a reset determines
+  void WritePhysicsState(ByteWriter* writer);
+  void ReadPhysicsState(ByteReader* reader);
 
  protected:
   mjModel* model_;
@@ -47,18 +79,62 @@ class MujocoEnv {
   int n_sub_steps_, max_episode_steps_, elapsed_step_;
   float reward_, discount_;
   bool done_{true};
+  std::unique_ptr<SoftwareRenderer> renderer_;
+  // the task's `Env::gen_`, which its reset draws from
+  std::mt19937* gen_ref_{nullptr};
 #ifdef ENVPOOL_TEST
   std::unique_ptr<mjtNum> qpos0_;
 #endif
 
  public:
+  // The compiled model is shared through `mujoco_common::LoadModel`, which
+  // also saves it under `cache_dir` unless empty; each env writes to a copy.
+  // `randomization` is a `mujoco_common::ModelRandomizer` spec, applied at
+  // every reset. `reset_pool_size` and `reset_pool_refresh` configure the
+  // pool of initial states described at `ControlReset`.
   MujocoEnv(const std::string& base_path, const std::string& raw_xml,
-            int n_sub_steps, int max_episode_steps);
-  ~MujocoEnv();
+            int n_sub_steps, int max_episode_steps,
+            const std::string& cache_dir, const std::string& randomization,
+            int reset_pool_size, int reset_pool_refresh);
+  virtual ~MujocoEnv();
+
+  // Every task calls this from its constructor with its `Env::gen_`. With
+  // "reset_pool_size" > 0, it also opens the `ResetPool` shared by the envs
+  // of the task, seed and randomization in the process, generating it with
+  // envs of type `TaskEnv` if it does not exist yet.
+  template <typename TaskEnv, typename Spec>
+  void OpenResetPool(const Spec& spec, std::mt19937* gen) {
+    gen_ref_ = gen;
+    if (reset_pool_size_ <= 0) {
+      return;
+    }
+    Spec worker_spec = spec;
+    worker_spec.config["reset_pool_size"_] = 0;
+    const std::string& task_name = spec.config["task_name"_];
+    const std::string& randomization = spec.config["model_randomization"_];
+    reset_pool_ = ResetPool::Open(
+        model_key_ + "\n" + task_name + "\n" + randomization,
+        reset_pool_size_, spec.config["seed"_],
+        [worker_spec] {
+          return std::unique_ptr<MujocoEnv>(new TaskEnv(worker_spec, 0));
+        },
+        reset_pool_refresh_ > 0);
+  }
+
+  // Seeds the task's generator with `seq`, runs a full reset up to its last
+  // mj_forward and writes the state reached into `state`, for `ResetPool`.
+  void GenResetState(std::seed_seq* seq, std::vector<uint8_t>* state);
 
   // rl control Environment
   // https://github.com/deepmind/dm_control/blob/1.0.2/dm_control/rl/control.py#L77
-  void ControlReset();
+  //
+  // With `reset_pool_size` > 0, each reset restores one of the states of the
+  // shared `ResetPool`, drawn from `gen`, and runs a single mj_forward. After
+  // `reset_pool_refresh` resets (0 for never) the env moves on to the pool's
+  // next generation, shared with the other envs that get there, so episodes
+  // stay deterministic under the seed. That generation is built in the
+  // background while the current one is in use.
+  void ControlReset(std::mt19937* gen);
 
   // https://github.com/deepmind/dm_control/blob/1.0.2/dm_control/rl/control.py#L94
   void ControlStep(const mjtNum* action);
@@ -74,6 +150,31 @@ class MujocoEnv {
   virtual float TaskGetReward();
   virtual float TaskGetDiscount();
   virtual bool TaskShouldTerminateEpisode();
+  // model fields randomized per episode, restored before mj_forward
+  virtual void TaskSerialize(ByteWriter* writer) {}
+  virtual void TaskDeserialize(ByteReader* reader) {}
+
+  // Checkpointing: only the integration state of mjData and the randomized
+  // model values are stored, everything else is recomputed by mj_forward on
+  // restore.
+  void MujocoSerialize(ByteWriter* writer);
+  void MujocoDeserialize(ByteReader* reader);
+
+  // Throws if `from_pixels` is set and the render size or camera of `conf`
+  // does not fit the model, so that a bad setting fails when the env is made
+  // instead of at its first frame on a worker thread.
+  template <typename Config>
+  void CheckRenderConfig(const Config& conf) const {
+    if (conf["from_pixels"_]) {
+      SoftwareRenderer::CheckConfig(model_, conf["render_width"_],
+                                    conf["render_height"_],
+                                    conf["render_camera_id"_]);
+    }
+  }
+
+  // Renders the current frame into `pixels` from `camera_id`, -1 for the
+  // free camera. Does nothing if `pixels` is empty.
+  void RenderPixels(const Array& pixels, int camera_id);
 
   // Physics
   // https://github.com/deepmind/dm_control/blob/1.0.2/dm_control/mujoco/engine.py#L263
@@ -41,12 +41,18 @@ class PendulumEnvFns {
  public:
   static decltype(auto) DefaultConfig() {
     return MakeDict("frame_skip"_.Bind(1),
-                    "task_name"_.Bind(std::string("swingup")));
+                    "task_name"_.Bind(std::string("swingup")),
+                    "from_pixels"_.Bind(false), "render_width"_.Bind(84),
+                    "render_height"_.Bind(84), "render_camera_id"_.Bind(0),
+                    "mjb_cache_dir"_.Bind(std::string("")),
+                    "model_randomization"_.Bind(std::string("")),
+                    "reset_pool_size"_.Bind(0), "reset_pool_refresh"_.Bind(0));
   }
   template <typename Config>
   static decltype(auto) StateSpec(const Config& conf) {
     return MakeDict("obs:orientation"_.Bind(Spec<mjtNum>({2})),
-                    "obs:velocity"_.Bind(Spec<mjtNum>({1}))
+                    "obs:velocity"_.Bind(Spec<mjtNum>({1})),
+                    "obs:pixels"_.Bind(PixelSpec(conf))
 #ifdef ENVPOOL_TEST
                         ,
                     "info:qpos0"_.Bind(Spec<mjtNum>({1}))
@@ -73,9 +79,15 @@ class PendulumEnv : public Env<PendulumEnvSpec>, public MujocoEnv {
                   GetPendulumXML(spec.config["base_path"_],
                                  spec.config["task_name"_]),
                   spec.config["frame_skip"_],
-                  spec.config["max_episode_steps"_]),
+                  spec.config["max_episode_steps"_],
+                  spec.config["mjb_cache_dir"_],
+                  spec.config["model_randomization"_],
+                  spec.config["reset_pool_size"_],
+                  spec.config["reset_pool_refresh"_]),
         id_hinge_(GetQvelId(model_, "hinge")),
         id_pole_(mj_name2id(model_, mjOBJ_XBODY, "pole")) {
+    CheckRenderConfig(spec.config);
+    OpenResetPool<PendulumEnv>(spec, &gen_);
     const std::string& task_name = spec.config["task_name"_];
     if (task_name != "swingup") {
       throw std::runtime_error("Unknown task_name " + task_name +
@@ -93,7 +105,7 @@ class PendulumEnv : public Env<PendulumEnvSpec>, public MujocoEnv {
   bool IsDone() override { return done_; }
 
   void Reset() override {
-    ControlReset();
+    ControlReset(&gen_);
     WriteState();
   }
 
@@ -108,11 +120,16 @@ class PendulumEnv : public Env<PendulumEnvSpec>, public MujocoEnv {
   }
   bool TaskShouldTerminateEpisode() override { return false; }
 
+  void Serialize(ByteWriter* writer) override { MujocoSerialize(writer); }
+
+  void Deserialize(ByteReader* reader) override { MujocoDeserialize(reader); }
+
  private:
   void WriteState() {
     State state = Allocate();
     state["reward"_] = reward_;
     state["discount"_] = discount_;
+    RenderPixels(state["obs:pixels"_], spec_.config["render_camera_id"_]);
     // obs
     const auto& pole_orient = PoleOrientation();
     state["obs:orientation"_].Assign(pole_orient.begin(), pole_orient.size());
@@ -39,12 +39,18 @@ class PointMassEnvFns {
  public:
   static decltype(auto) DefaultConfig() {
     return MakeDict("frame_skip"_.Bind(1),
-                    "task_name"_.Bind(std::string("easy")));
+                    "task_name"_.Bind(std::string("easy")),
+                    "from_pixels"_.Bind(false), "render_width"_.Bind(84),
+                    "render_height"_.Bind(84), "render_camera_id"_.Bind(0),
+                    "mjb_cache_dir"_.Bind(std::string("")),
+                    "model_randomization"_.Bind(std::string("")),
+                    "reset_pool_size"_.Bind(0), "reset_pool_refresh"_.Bind(0));
   }
   template <typename Config>
   static decltype(auto) StateSpec(const Config& conf) {
     return MakeDict("obs:position"_.Bind(Spec<mjtNum>({2})),
-                    "obs:velocity"_.Bind(Spec<mjtNum>({2}))
+                    "obs:velocity"_.Bind(Spec<mjtNum>({2})),
+                    "obs:pixels"_.Bind(PixelSpec(conf))
 #ifdef ENVPOOL_TEST
                         ,
                     "info:qpos0"_.Bind(Spec<mjtNum>({2})),
@@ -75,10 +81,16 @@ class PointMassEnv : public Env<PointMassEnvSpec>, public MujocoEnv {
                   GetPointMassXML(spec.config["base_path"_],
                                   spec.config["task_name"_]),
                   spec.config["frame_skip"_],
-                  spec.config["max_episode_steps"_]),
+                  spec.config["max_episode_steps"_],
+                  spec.config["mjb_cache_dir"_],
+                  spec.config["model_randomization"_],
+                  spec.config["reset_pool_size"_],
+                  spec.config["reset_pool_refresh"_]),
 
         id_geom_target_(mj_name2id(model_, mjOBJ_GEOM, "target")),
         id_geom_pointmass_(mj_name2id(model_, mjOBJ_GEOM, "pointmass")) {
+    CheckRenderConfig(spec.config);
+    OpenResetPool<PointMassEnv>(spec, &gen_);
     const std::string& task_name = spec.config["task_name"_];
     if (task_name == "easy") {
       randomize_gains_ = false;
@@ -125,7 +137,7 @@ class PointMassEnv : public Env<PointMassEnvSpec>, public MujocoEnv {
   bool IsDone() override { return done_; }
 
   void Reset() override {
-    ControlReset();
+    ControlReset(&gen_);
     WriteState();
   }
 
@@ -149,6 +161,18 @@ class PointMassEnv : public Env<PointMassEnvSpec>, public MujocoEnv {
 
   bool TaskShouldTerminateEpisode() override { return false; }
 
+  void TaskSerialize(ByteWriter* writer) override {
+    writer->WriteArray(model_->wrap_prm, 4);
+  }
+
+  void TaskDeserialize(ByteReader* reader) override {
+    reader->ReadArray(model_->wrap_prm, 4);
+  }
+
+  void Serialize(ByteWriter* writer) override { MujocoSerialize(writer); }
+
+  void Deserialize(ByteReader* reader) override { MujocoDeserialize(reader); }
+
  private:
   mjtNum MassToTargetDist() {
     // return np.linalg.norm(self.mass_to_target())
@@ -173,6 +197,7 @@ class PointMassEnv : public Env<PointMassEnvSpec>, public MujocoEnv {
     State state = Allocate();
     state["reward"_] = reward_;
     state["discount"_] = discount_;
+    RenderPixels(state["obs:pixels"_], spec_.config["render_camera_id"_]);
     // obs
     state["obs:position"_].Assign(data_->qpos, model_->nq);
     state["obs:velocity"_].Assign(data_->qvel, model_->nv);
@@ -41,13 +41,19 @@ class ReacherEnvFns {
  public:
   static decltype(auto) DefaultConfig() {
     return MakeDict("frame_skip"_.Bind(1),
-                    "task_name"_.Bind(std::string("easy")));
+                    "task_name"_.Bind(std::string("easy")),
+                    "from_pixels"_.Bind(false), "render_width"_.Bind(84),
+                    "render_height"_.Bind(84), "render_camera_id"_.Bind(0),
+                    "mjb_cache_dir"_.Bind(std::string("")),
+                    "model_randomization"_.Bind(std::string("")),
+                    "reset_pool_size"_.Bind(0), "reset_pool_refresh"_.Bind(0));
   }
   template <typename Config>
   static decltype(auto) StateSpec(const Config& conf) {
     return MakeDict("obs:position"_.Bind(Spec<mjtNum>({2})),
                     "obs:to_target"_.Bind(Spec<mjtNum>({2})),
-                    "obs:velocity"_.Bind(Spec<mjtNum>({2}))
+                    "obs:velocity"_.Bind(Spec<mjtNum>({2})),
+                    "obs:pixels"_.Bind(PixelSpec(conf))
 #ifdef ENVPOOL_TEST
                         ,
                     "info:qpos0"_.Bind(Spec<mjtNum>({2})),
@@ -79,9 +85,14 @@ class ReacherEnv : public Env<ReacherEnvSpec>, public MujocoEnv {
         MujocoEnv(
             spec.config["base_path"_],
             GetReacherXML(spec.config["base_path"_], spec.config["task_name"_]),
-            spec.config["frame_skip"_], spec.config["max_episode_steps"_]),
+            spec.config["frame_skip"_], spec.config["max_episode_steps"_],
+            spec.config["mjb_cache_dir"_], spec.config["model_randomization"_],
+            spec.config["reset_pool_size"_],
+            spec.config["reset_pool_refresh"_]),
         id_target_(mj_name2id(model_, mjOBJ_GEOM, "target")),
         id_finger_(mj_name2id(model_, mjOBJ_GEOM, "finger")) {
+    CheckRenderConfig(spec.config);
+    OpenResetPool<ReacherEnv>(spec, &gen_);
     const std::string& task_name = spec.config["task_name"_];
     if (task_name == "easy") {
       target_size_ = kBigTarget;
@@ -112,7 +123,7 @@ class ReacherEnv : public Env<ReacherEnvSpec>, public MujocoEnv {
   bool IsDone() override { return done_; }
 
   void Reset() override {
-    ControlReset();
+    ControlReset(&gen_);
     WriteState();
   }
 
@@ -129,11 +140,24 @@ class ReacherEnv : public Env<ReacherEnvSpec>, public MujocoEnv {
     return static_cast<float>(RewardTolerance(FingerToTargetDist(), 0, radii));
   }
 
+  void TaskSerialize(ByteWriter* writer) override {
+    writer->WriteArray(model_->geom_pos + id_target_ * 3, 3);
+  }
+
+  void TaskDeserialize(ByteReader* reader) override {
+    reader->ReadArray(model_->geom_pos + id_target_ * 3, 3);
+  }
+
+  void Serialize(ByteWriter* writer) override { MujocoSerialize(writer); }
+
+  void Deserialize(ByteReader* reader) override { MujocoDeserialize(reader); }
+
  private:
   void WriteState() {
     State state = Allocate();
     state["reward"_] = reward_;
     state["discount"_] = discount_;
+    RenderPixels(state["obs:pixels"_], spec_.config["render_camera_id"_]);
     // obs
     state["obs:position"_].Assign(data_->qpos, model_->nq);
     const auto& finger = FingerToTarget();
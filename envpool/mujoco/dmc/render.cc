@@ -0,0 +1,598 @@
+// Copyright 2022 Garena Online Private Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "envpool/mujoco/dmc/render.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace mujoco_dmc {
+
+namespace {
+
+constexpr int kMaxGeom = 2000;
+constexpr int kSlices = 16;     // around the axis of round geoms
+constexpr int kStacks = 6;      // per quarter circle of spheres and capsules
+constexpr int kPlaneCells = 8;  // per side, so point lights vary over planes
+// top color of the dm_control skybox gradient
+constexpr std::array<float, 3> kSkyColor = {0.4F, 0.6F, 0.8F};
+
+float Dot(const float* a, const float* b) {
+  return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+void Normalize(float* v) {
+  float norm = std::sqrt(Dot(v, v));
+  if (norm > 0) {
+    v[0] /= norm;
+    v[1] /= norm;
+    v[2] /= norm;
+  }
+}
+
+// 2x the signed area of (a, b, p), positive if counter-clockwise
+float Edge(const float* a, const float* b, float px, float py) {
+  return (b[0] - a[0]) * (py - a[1]) - (b[1] - a[1]) * (px - a[0]);
+}
+
+// std::floor is a library call without SSE4.1
+float Floor(float x) {
+  float truncated = static_cast<float>(static_cast<int>(x));
+  return truncated > x ? truncated - 1 : truncated;
+}
+
+uint8_t ToByte(float x) {
+  return static_cast<uint8_t>(std::clamp(x, 0.0F, 1.0F) * 255.0F + 0.5F);
+}
+
+}  // namespace
+
+void SoftwareRenderer::CheckConfig(const mjModel* model, int width,
+                                   int height, int camera_id) {
+  if (width <= 0 || height <= 0) {
+    throw std::runtime_error("Render size must be positive, got " +
+                             std::to_string(width) + "x" +
+                             std::to_string(height) + ".");
+  }
+  if (camera_id < -1 || camera_id >= model->ncam) {
+    throw std::runtime_error("Camera id " + std::to_string(camera_id) +
+                             " is out of range, the model has " +
+                             std::to_string(model->ncam) + " cameras.");
+  }
+}
+
+SoftwareRenderer::SoftwareRenderer(const mjModel* model, int width,
+                                   int height, int camera_id)
+    : width_(width), height_(height), depth_(width * height) {
+  CheckConfig(model, width, height, camera_id);
+  mjv_defaultScene(&scene_);
+  mjv_makeScene(model, &scene_, kMaxGeom);
+  mjv_defaultOption(&option_);
+  mjv_defaultCamera(&camera_);
+  if (camera_id >= 0) {
+    camera_.type = mjCAMERA_FIXED;
+    camera_.fixedcamid = camera_id;
+  } else {
+    // same as mjv_defaultFreeCamera, which dm_control uses for -1
+    camera_.type = mjCAMERA_FREE;
+    for (int i = 0; i < 3; ++i) {
+      camera_.lookat[i] = model->stat.center[i];
+    }
+    camera_.distance = 1.5 * model->stat.extent;
+    camera_.azimuth = model->vis.global.azimuth;
+    camera_.elevation = model->vis.global.elevation;
+  }
+}
+
+SoftwareRenderer::~SoftwareRenderer() { mjv_freeScene(&scene_); }
+
+void SoftwareRenderer::Render(const mjModel* model, mjData* data,
+                              uint8_t* rgb) {
+  mjv_updateScene(model, data, &option_, nullptr, &camera_,
+                  mjCAT_STATIC | mjCAT_DYNAMIC, &scene_);
+  mjvGLCamera camera =
+      mjv_averageCamera(&scene_.camera[0], &scene_.camera[1]);
+  for (int i = 0; i < 3; ++i) {
+    eye_[i] = camera.pos[i];
+    forward_[i] = camera.forward[i];
+    up_[i] = camera.up[i];
+  }
+  Normalize(forward_);
+  Normalize(up_);
+  right_[0] = forward_[1] * up_[2] - forward_[2] * up_[1];
+  right_[1] = forward_[2] * up_[0] - forward_[0] * up_[2];
+  right_[2] = forward_[0] * up_[1] - forward_[1] * up_[0];
+  near_ = camera.frustum_near;
+  half_height_ = (camera.frustum_top - camera.frustum_bottom) / 2;
+  center_y_ = (camera.frustum_top + camera.frustum_bottom) / 2;
+  half_width_ = half_height_ * static_cast<float>(width_) / height_;
+  center_x_ = camera.frustum_center;
+
+  const uint8_t sky[3] = {ToByte(kSkyColor[0]), ToByte(kSkyColor[1]),
+                           ToByte(kSkyColor[2])};
+  for (int i = 0; i < width_ * height_; ++i) {
+    std::memcpy(rgb + i * 3, sky, 3);
+  }
+  std::fill(depth_.begin(), depth_.end(), 0.0F);
+
+  // opaque geoms in any order, then transparent ones back to front
+  std::vector<int> transparent;
+  for (int i = 0; i < scene_.ngeom; ++i) {
+    const mjvGeom& geom = scene_.geoms[i];
+    if (geom.rgba[3] <= 0) {
+      continue;
+    }
+    if (geom.transparent != 0 || geom.rgba[3] < 1) {
+      transparent.push_back(i);
+    } else {
+      DrawGeom(model, geom, rgb);
+    }
+  }
+  std::sort(transparent.begin(), transparent.end(), [this](int a, int b) {
+    return scene_.geoms[a].camdist > scene_.geoms[b].camdist;
+  });
+  for (int i : transparent) {
+    DrawGeom(model, scene_.geoms[i], rgb);
+  }
+}
+
+void SoftwareRenderer::AddLathe(const std::vector<float>& profile) {
+  // profile holds (radius, z, normal radius, normal z) per ring
+  static const auto kCircle = [] {
+    std::array<float, 2 * kSlices> circle;
+    for (int s = 0; s < kSlices; ++s) {
+      circle[2 * s] = std::cos(2 * M_PI * s / kSlices);
+      circle[2 * s + 1] = std::sin(2 * M_PI * s / kSlices);
+    }
+    return circle;
+  }();
+  int base = static_cast<int>(local_pos_.size() / 3);
+  int rings = static_cast<int>(profile.size() / 4);
+  for (int i = 0; i < rings; ++i) {
+    const float* ring = profile.data() + 4 * i;
+    for (int s = 0; s < kSlices; ++s) {
+      float c = kCircle[2 * s];
+      float sn = kCircle[2 * s + 1];
+      local_pos_.insert(local_pos_.end(), {ring[0] * c, ring[0] * sn, ring[1]});
+      local_normal_.insert(local_normal_.end(),
+                           {ring[2] * c, ring[2] * sn, ring[3]});
+      local_uv_.insert(local_uv_.end(), {0.0F, 0.0F});
+    }
+  }
+  for (int i = 0; i + 1 < rings; ++i) {
+    for (int s = 0; s < kSlices; ++s) {
+      int a = base + i * kSlices + s;
+      int b = base + i * kSlices + (s + 1) % kSlices;
+      triangles_.insert(triangles_.end(),
+                        {a, b, b + kSlices, a, b + kSlices, a + kSlices});
+    }
+  }
+}
+
+void SoftwareRenderer::AddQuad(const float* corner, const float* du,
+                               const float* dv, const float* normal) {
+  int base = static_cast<int>(local_pos_.size() / 3);
+  for (int k = 0; k < 4; ++k) {
+    float u = (k == 1 || k == 2) ? 1.0F : 0.0F;
+    float v = k >= 2 ? 1.0F : 0.0F;
+    float pos[3];
+    for (int i = 0; i < 3; ++i) {
+      pos[i] = corner[i] + u * du[i] + v * dv[i];
+    }
+    local_pos_.insert(local_pos_.end(), pos, pos + 3);
+    local_normal_.insert(local_normal_.end(), normal, normal + 3);
+    // planes are textured by their local x and y
+    local_uv_.insert(local_uv_.end(), {pos[0], pos[1]});
+  }
+  triangles_.insert(triangles_.end(),
+                    {base, base + 1, base + 2, base, base + 2, base + 3});
+}
+
+void SoftwareRenderer::Tessellate(const mjModel* model, const mjvGeom& geom) {
+  local_pos_.clear();
+  local_normal_.clear();
+  local_uv_.clear();
+  triangles_.clear();
+  profile_.clear();
+  const float* size = geom.size;
+  switch (geom.type) {
+    case mjGEOM_SPHERE:
+    case mjGEOM_ELLIPSOID: {
+      for (int k = 0; k <= 2 * kStacks; ++k) {
+        float phi = M_PI * k / (2 * kStacks);
+        profile_.insert(profile_.end(), {std::sin(phi), std::cos(phi),
+                                       std::sin(phi), std::cos(phi)});
+      }
+      AddLathe(profile_);
+      float scale[3] = {size[0], size[0], size[0]};
+      if (geom.type == mjGEOM_ELLIPSOID) {
+        scale[1] = size[1];
+        scale[2] = size[2];
+      }
+      for (std::size_t i = 0; i < local_pos_.size(); i += 3) {
+        for (int j = 0; j < 3; ++j) {
+          local_pos_[i + j] *= scale[j];
+          local_normal_[i + j] /= scale[j];
+        }
+        Normalize(&local_normal_[i]);
+      }
+      break;
+    }
+    case mjGEOM_CAPSULE: {
+      float radius = size[0];
+      float half_length = size[2];
+      for (int k = 0; k <= 2 * kStacks; ++k) {
+        float phi = M_PI * k / (2 * kStacks);
+        float shift = k <= kStacks ? half_length : -half_length;
+        profile_.insert(profile_.end(),
+                       {radius * std::sin(phi), radius * std::cos(phi) + shift,
+                        std::sin(phi), std::cos(phi)});
+        if (k == kStacks) {
+          // the cylinder between the two hemispheres
+          profile_.insert(profile_.end(), {radius, -half_length, 1.0F, 0.0F});
+        }
+      }
+      AddLathe(profile_);
+      break;
+    }
+    case mjGEOM_CYLINDER: {
+      float radius = size[0];
+      float half_length = size[2];
+      profile_ = {0,      half_length,  0, 1,   // top cap
+                  radius, half_length,  0, 1,   //
+                  radius, half_length,  1, 0,   // side
+                  radius, -half_length, 1, 0,   //
+                  radius, -half_length, 0, -1,  // bottom cap
+                  0,      -half_length, 0, -1};
+      AddLathe(profile_);
+      break;
+    }
+    case mjGEOM_BOX: {
+      for (int axis = 0; axis < 3; ++axis) {
+        int u = (axis + 1) % 3;
+        int v = (axis + 2) % 3;
+        for (float sign : {-1.0F, 1.0F}) {
+          float corner[3];
+          float du[3] = {0, 0, 0};
+          float dv[3] = {0, 0, 0};
+          float normal[3] = {0, 0, 0};
+          corner[axis] = sign * size[axis];
+          corner[u] = -size[u];
+          corner[v] = -size[v];
+          du[u] = 2 * size[u];
+          dv[v] = 2 * size[v];
+          normal[axis] = sign;
+          AddQuad(corner, du, dv, normal);
+        }
+      }
+      break;
+    }
+    case mjGEOM_PLANE: {
+      // infinite planes are drawn up to the far clipping distance
+      float far = model->vis.map.zfar * model->stat.extent;
+      float half_x = size[0] > 0 ? size[0] : far;
+      float half_y = size[1] > 0 ? size[1] : far;
+      float du[3] = {2 * half_x / kPlaneCells, 0, 0};
+      float dv[3] = {0, 2 * half_y / kPlaneCells, 0};
+      float normal[3] = {0, 0, 1};
+      for (int i = 0; i < kPlaneCells; ++i) {
+        for (int j = 0; j < kPlaneCells; ++j) {
+          float corner[3] = {-half_x + i * du[0], -half_y + j * dv[1], 0};
+          AddQuad(corner, du, dv, normal);
+        }
+      }
+      break;
+    }
+    case mjGEOM_MESH: {
+      int mesh_id = geom.dataid;
+      if (mesh_id < 0 || mesh_id >= model->nmesh) {
+        break;
+      }
+      const float* vert = model->mesh_vert + 3 * model->mesh_vertadr[mesh_id];
+      const int* face = model->mesh_face + 3 * model->mesh_faceadr[mesh_id];
+      // flat shaded, every face gets its own vertices
+      for (int f = 0; f < model->mesh_facenum[mesh_id]; ++f) {
+        const float* p0 = vert + 3 * face[3 * f];
+        const float* p1 = vert + 3 * face[3 * f + 1];
+        const float* p2 = vert + 3 * face[3 * f + 2];
+        float e1[3] = {p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]};
+        float e2[3] = {p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]};
+        float normal[3] = {e1[1] * e2[2] - e1[2] * e2[1],
+                           e1[2] * e2[0] - e1[0] * e2[2],
+                           e1[0] * e2[1] - e1[1] * e2[0]};
+        Normalize(normal);
+        int base = static_cast<int>(local_pos_.size() / 3);
+        for (const float* p : {p0, p1, p2}) {
+          local_pos_.insert(local_pos_.end(), p, p + 3);
+          local_normal_.insert(local_normal_.end(), normal, normal + 3);
+          local_uv_.insert(local_uv_.end(), {0.0F, 0.0F});
+        }
+        triangles_.insert(triangles_.end(), {base, base + 1, base + 2});
+      }
+      break;
+    }
+    default:
+      // height fields and decor are not drawn
+      break;
+  }
+}
+
+void SoftwareRenderer::Light(const mjvGeom& geom, bool textured) {
+  std::size_t n = local_pos_.size() / 3;
+  vertices_.resize(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    const float* local_pos = &local_pos_[3 * i];
+    const float* local_normal = &local_normal_[3 * i];
+    Vertex& vertex = vertices_[i];
+    float normal[3];
+    for (int r = 0; r < 3; ++r) {
+      const float* row = geom.mat + 3 * r;
+      vertex.pos[r] = geom.pos[r] + Dot(row, local_pos);
+      normal[r] = Dot(row, local_normal);
+    }
+    std::array<float, 3> light = {geom.emission, geom.emission,
+                                  geom.emission};
+    for (int l = 0; l < scene_.nlight; ++l) {
+      const mjvLight& scene_light = scene_.lights[l];
+      float dir[3];
+      if (scene_light.headlight != 0) {
+        dir[0] = -forward_[0];
+        dir[1] = -forward_[1];
+        dir[2] = -forward_[2];
+      } else if (scene_light.directional != 0) {
+        dir[0] = -scene_light.dir[0];
+        dir[1] = -scene_light.dir[1];
+        dir[2] = -scene_light.dir[2];
+      } else {
+        dir[0] = scene_light.pos[0] - vertex.pos[0];
+        dir[1] = scene_light.pos[1] - vertex.pos[1];
+        dir[2] = scene_light.pos[2] - vertex.pos[2];
+        Normalize(dir);
+      }
+      float diffuse = std::max(0.0F, Dot(normal, dir));
+      for (int c = 0; c < 3; ++c) {
+        light[c] += scene_light.ambient[c] + scene_light.diffuse[c] * diffuse;
+      }
+    }
+    for (int c = 0; c < 3; ++c) {
+      vertex.color[c] = std::min(1.0F, geom.rgba[c] * light[c]);
+    }
+    vertex.uv[0] = local_uv_[2 * i];
+    vertex.uv[1] = local_uv_[2 * i + 1];
+    if (textured) {
+      // texrepeat is per unit length with texuniform, else per plane
+      float scale_u = geom.texrepeat[0];
+      float scale_v = geom.texrepeat[1];
+      if (geom.texuniform == 0) {
+        scale_u /= geom.size[0] > 0 ? 2 * geom.size[0] : 1.0F;
+        scale_v /= geom.size[1] > 0 ? 2 * geom.size[1] : 1.0F;
+      }
+      vertex.uv[0] *= scale_u;
+      vertex.uv[1] *= scale_v;
+    }
+  }
+}
+
+void SoftwareRenderer::DrawGeom(const mjModel* model, const mjvGeom& geom,
+                                uint8_t* rgb) {
+  Tessellate(model, geom);
+  if (triangles_.empty()) {
+    return;
+  }
+  Texture texture{};
+  bool textured = geom.type == mjGEOM_PLANE && geom.texid >= 0 &&
+                  geom.texid < model->ntex &&
+                  model->tex_type[geom.texid] == mjTEXTURE_2D;
+  if (textured) {
+    texture.rgb = model->tex_rgb + 3 * model->tex_adr[geom.texid];
+    texture.width = model->tex_width[geom.texid];
+    texture.height = model->tex_height[geom.texid];
+  }
+  Light(geom, textured);
+  for (std::size_t i = 0; i < triangles_.size(); i += 3) {
+    Vertex triangle[3] = {vertices_[triangles_[i]],
+                          vertices_[triangles_[i + 1]],
+                          vertices_[triangles_[i + 2]]};
+    DrawTriangle(triangle, textured ? &texture : nullptr,
+                 std::min(1.0F, geom.rgba[3]), rgb);
+  }
+}
+
+void SoftwareRenderer::DrawTriangle(const Vertex* triangle,
+                                    const Texture* texture, float alpha,
+                                    uint8_t* rgb) {
+  // to camera space: x right, y up, z the depth along the view direction
+  Vertex camera[3];
+  for (int i = 0; i < 3; ++i) {
+    camera[i] = triangle[i];
+    float d[3] = {triangle[i].pos[0] - eye_[0], triangle[i].pos[1] - eye_[1],
+                  triangle[i].pos[2] - eye_[2]};
+    camera[i].pos[0] = Dot(d, right_);
+    camera[i].pos[1] = Dot(d, up_);
+    camera[i].pos[2] = Dot(d, forward_);
+  }
+  // clip against the near plane, which leaves at most a quad
+  Vertex polygon[4];
+  int n = 0;
+  for (int i = 0; i < 3; ++i) {
+    const Vertex& cur = camera[i];
+    const Vertex& next = camera[(i + 1) % 3];
+    bool cur_in = cur.pos[2] >= near_;
+    bool next_in = next.pos[2] >= near_;
+    if (cur_in) {
+      polygon[n++] = cur;
+    }
+    if (cur_in != next_in) {
+      float t = (near_ - cur.pos[2]) / (next.pos[2] - cur.pos[2]);
+      Vertex& v = polygon[n++];
+      for (int j = 0; j < 3; ++j) {
+        v.pos[j] = cur.pos[j] + t * (next.pos[j] - cur.pos[j]);
+        v.color[j] = cur.color[j] + t * (next.color[j] - cur.color[j]);
+      }
+      for (int j = 0; j < 2; ++j) {
+        v.uv[j] = cur.uv[j] + t * (next.uv[j] - cur.uv[j]);
+      }
+    }
+  }
+  if (n < 3) {
+    return;
+  }
+  // to pixels, keeping 1 / depth and attributes over depth, which are linear
+  // in screen space
+  for (int i = 0; i < n; ++i) {
+    Vertex& v = polygon[i];
+    float inv_z = 1.0F / v.pos[2];
+    float x = (v.pos[0] * near_ * inv_z - center_x_) / half_width_;
+    float y = (v.pos[1] * near_ * inv_z - center_y_) / half_height_;
+    v.pos[0] = (x + 1) * 0.5F * width_;
+    v.pos[1] = (1 - y) * 0.5F * height_;
+    v.pos[2] = inv_z;
+    for (float& c : v.color) {
+      c *= inv_z;
+    }
+    v.uv[0] *= inv_z;
+    v.uv[1] *= inv_z;
+  }
+  Rasterize(&polygon[0], &polygon[1], &polygon[2], texture, alpha, rgb);
+  if (n == 4) {
+    Rasterize(&polygon[0], &polygon[2], &polygon[3], texture, alpha, rgb);
+  }
+}
+
+void SoftwareRenderer::Rasterize(const Vertex* a, const Vertex* b,
+                                 const Vertex* c, const Texture* texture,
+                                 float alpha, uint8_t* rgb) {
+  float area = Edge(a->pos, b->pos, c->pos[0], c->pos[1]);
+  if (std::abs(area) < 1e-8F) {
+    return;
+  }
+  // pixels whose centers are inside the bounding box
+  float min_x = std::min({a->pos[0], b->pos[0], c->pos[0]});
+  float max_x = std::max({a->pos[0], b->pos[0], c->pos[0]});
+  float min_y = std::min({a->pos[1], b->pos[1], c->pos[1]});
+  float max_y = std::max({a->pos[1], b->pos[1], c->pos[1]});
+  int x0 = std::max(0, static_cast<int>(std::ceil(min_x - 0.5F)));
+  int x1 = std::min(width_ - 1, static_cast<int>(std::floor(max_x - 0.5F)));
+  int y0 = std::max(0, static_cast<int>(std::ceil(min_y - 0.5F)));
+  int y1 = std::min(height_ - 1, static_cast<int>(std::floor(max_y - 0.5F)));
+  // the weight of each vertex is dx * px + dy * py + c at pixel (px, py)
+  float inv_area = 1.0F / area;
+  const Vertex* edges[3][2] = {{b, c}, {c, a}, {a, b}};
+  float dx[3], dy[3], c0[3], inv_dx[3];
+  for (int i = 0; i < 3; ++i) {
+    const float* p = edges[i][0]->pos;
+    const float* q = edges[i][1]->pos;
+    dx[i] = -(q[1] - p[1]) * inv_area;
+    dy[i] = (q[0] - p[0]) * inv_area;
+    c0[i] = ((q[1] - p[1]) * p[0] - (q[0] - p[0]) * p[1]) * inv_area;
+    inv_dx[i] = dx[i] != 0 ? 1.0F / dx[i] : 0.0F;
+  }
+  // 1 / depth, color and uv over depth are linear in screen space too, so
+  // they step by a constant along the row
+  float attr[3][6];
+  for (int i = 0; i < 3; ++i) {
+    const Vertex* v = edges[(i + 1) % 3][1];  // a, b, c in weight order
+    attr[i][0] = v->pos[2];
+    attr[i][1] = v->color[0];
+    attr[i][2] = v->color[1];
+    attr[i][3] = v->color[2];
+    attr[i][4] = v->uv[0];
+    attr[i][5] = v->uv[1];
+  }
+  float step[6];
+  for (int k = 0; k < 6; ++k) {
+    step[k] = dx[0] * attr[0][k] + dx[1] * attr[1][k] + dx[2] * attr[2][k];
+  }
+  for (int y = y0; y <= y1; ++y) {
+    float py = y + 0.5F;
+    // the weights are linear along the row, so only walk the span where all
+    // three are non-negative instead of the whole bounding box
+    float w[3];
+    float lo = x0 + 0.5F;
+    float hi = x1 + 0.5F;
+    for (int i = 0; i < 3; ++i) {
+      w[i] = dy[i] * py + c0[i];
+      if (dx[i] > 0) {
+        lo = std::max(lo, -w[i] * inv_dx[i]);
+      } else if (dx[i] < 0) {
+        hi = std::min(hi, -w[i] * inv_dx[i]);
+      } else if (w[i] < 0) {
+        hi = lo - 1;
+      }
+    }
+    if (lo > hi) {
+      continue;
+    }
+    // one pixel of slack either way, the exact test is below
+    int row_x0 = std::max(x0, static_cast<int>(std::ceil(lo - 0.5F)) - 1);
+    int row_x1 = std::min(x1, static_cast<int>(std::floor(hi - 0.5F)) + 1);
+    float px = row_x0 + 0.5F;
+    float value[6];
+    for (int i = 0; i < 3; ++i) {
+      w[i] += dx[i] * px;
+    }
+    for (int k = 0; k < 6; ++k) {
+      value[k] = w[0] * attr[0][k] + w[1] * attr[1][k] + w[2] * attr[2][k];
+    }
+    for (int x = row_x0; x <= row_x1; ++x) {
+      int index = y * width_ + x;
+      if (w[0] >= 0 && w[1] >= 0 && w[2] >= 0 && value[0] > depth_[index]) {
+        float z = 1.0F / value[0];
+        float color[3] = {value[1] * z, value[2] * z, value[3] * z};
+        if (texture != nullptr) {
+          float u = value[4] * z;
+          float v = value[5] * z;
+          int tx = std::min(
+              texture->width - 1,
+              static_cast<int>((u - Floor(u)) *
+                               static_cast<float>(texture->width)));
+          int ty = std::min(
+              texture->height - 1,
+              static_cast<int>((v - Floor(v)) *
+                               static_cast<float>(texture->height)));
+          const uint8_t* texel =
+              texture->rgb + 3 * (ty * texture->width + tx);
+          for (int k = 0; k < 3; ++k) {
+            color[k] *= texel[k] / 255.0F;
+          }
+        }
+        uint8_t* pixel = rgb + 3 * index;
+        if (alpha < 1) {
+          // transparent geoms blend over what is behind and hide nothing
+          for (int k = 0; k < 3; ++k) {
+            pixel[k] =
+                ToByte(alpha * color[k] + (1 - alpha) * pixel[k] / 255.0F);
+          }
+        } else {
+          for (int k = 0; k < 3; ++k) {
+            pixel[k] = ToByte(color[k]);
+          }
+          depth_[index] = value[0];
+        }
+      }
+      for (int i = 0; i < 3; ++i) {
+        w[i] += dx[i];
+      }
+      for (int k = 0; k < 6; ++k) {
+        value[k] += step[k];
+      }
+    }
+  }
+}
+
+}  // namespace mujoco_dmc
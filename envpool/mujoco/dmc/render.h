@@ -0,0 +1,94 @@
+/*
+ * Copyright 2022 Garena Online Private Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ENVPOOL_MUJOCO_DMC_RENDER_H_
+#define ENVPOOL_MUJOCO_DMC_RENDER_H_
+
+#include <mujoco.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace mujoco_dmc {
+
+/*
+ * CPU rasterizer of the abstract scene built by mjv_updateScene, so pixel
+ * observations need neither a GPU nor an OpenGL context. Geoms are
+ * tessellated, lit per vertex by the scene lights and drawn with a depth
+ * buffer. 2D textures are sampled on planes only; the skybox is a flat color
+ * and shadows, reflections, height fields and decor are not drawn.
+ *
+ * Every env owns its renderer, so rendering runs on the thread stepping the
+ * env without any locking.
+ */
+class SoftwareRenderer {
+ public:
+  // `camera_id` is a camera of the model, or -1 for the free camera.
+  SoftwareRenderer(const mjModel* model, int width, int height,
+                   int camera_id);
+  // Throws unless the size is positive and `camera_id` is valid for `model`.
+  static void CheckConfig(const mjModel* model, int width, int height,
+                          int camera_id);
+  ~SoftwareRenderer();
+  SoftwareRenderer(const SoftwareRenderer&) = delete;
+  SoftwareRenderer& operator=(const SoftwareRenderer&) = delete;
+
+  // Draws the current state of `data` into `rgb`, height x width x 3, top row
+  // first.
+  void Render(const mjModel* model, mjData* data, uint8_t* rgb);
+
+ protected:
+  struct Vertex {
+    float pos[3];
+    float color[3];  // lit color, multiplied by the texel when textured
+    float uv[2];
+  };
+  struct Texture {
+    const uint8_t* rgb;
+    int width, height;
+  };
+
+  int width_, height_;
+  mjvScene scene_;
+  mjvOption option_;
+  mjvCamera camera_;
+
+  // view of the frame being drawn
+  float eye_[3], right_[3], up_[3], forward_[3];
+  float near_, center_x_, center_y_, half_width_, half_height_;
+
+  std::vector<float> depth_;  // 1 / depth of the closest fragment, 0 if none
+  // geom being drawn: local positions and normals, then lit world vertices
+  std::vector<float> profile_;  // rings of the round geom being built
+  std::vector<float> local_pos_, local_normal_, local_uv_;
+  std::vector<int> triangles_;
+  std::vector<Vertex> vertices_;
+
+  void Tessellate(const mjModel* model, const mjvGeom& geom);
+  void AddLathe(const std::vector<float>& profile);
+  void AddQuad(const float* corner, const float* du, const float* dv,
+               const float* normal);
+  void Light(const mjvGeom& geom, bool textured);
+  void DrawGeom(const mjModel* model, const mjvGeom& geom, uint8_t* rgb);
+  void DrawTriangle(const Vertex* triangle, const Texture* texture,
+                    float alpha, uint8_t* rgb);
+  void Rasterize(const Vertex* a, const Vertex* b, const Vertex* c,
+                 const Texture* texture, float alpha, uint8_t* rgb);
+};
+
+}  // namespace mujoco_dmc
+
+#endif  // ENVPOOL_MUJOCO_DMC_RENDER_H_
@@ -0,0 +1,141 @@
+// Copyright 2023 Garena Online Private Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "envpool/mujoco/dmc/reset_pool.h"
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <utility>
+
+#include "envpool/mujoco/dmc/mujoco_env.h"
+
+namespace mujoco_dmc {
+
+ResetPool::ResetPool(std::string key, std::size_t size, int seed,
+                     int generation, EnvFactory factory)
+    : key_(std::move(key)),
+      seed_(seed),
+      generation_(generation),
+      factory_(std::move(factory)),
+      states_(size) {}
+
+ResetPool::~ResetPool() {
+  cancelled_ = true;
+  if (builder_.joinable()) {
+    builder_.join();
+  }
+}
+
+std::shared_ptr<const ResetPool> ResetPool::Open(const std::string& key,
+                                                 std::size_t size, int seed,
+                                                 const EnvFactory& factory,
+                                                 bool build_next) {
+  if (size == 0) {
+    throw std::runtime_error("A reset pool needs at least one state.");
+  }
+  const std::size_t num_threads = std::min<std::size_t>(
+      size, std::max(1U, std::thread::hardware_concurrency()));
+  std::shared_ptr<const ResetPool> pool =
+      Get(key, size, seed, 0, factory, num_threads);
+  pool->Wait();
+  if (build_next) {
+    pool->BuildNext();
+  }
+  return pool;
+}
+
+std::shared_ptr<const ResetPool> ResetPool::Next() const {
+  BuildNext();
+  std::shared_ptr<const ResetPool> next;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    next = next_;
+  }
+  next->Wait();
+  next->BuildNext();
+  return next;
+}
+
+std::shared_ptr<ResetPool> ResetPool::Get(const std::string& key,
+                                          std::size_t size, int seed,
+                                          int generation,
+                                          const EnvFactory& factory,
+                                          std::size_t num_threads) {
+  // only guards the lookup: building a pool happens on its own builder thread
+  static std::mutex mutex;
+  static std::map<std::string, std::weak_ptr<ResetPool>> cache;
+
+  const std::string full_key = key + "#" + std::to_string(seed) + "#" +
+                               std::to_string(generation) + "#" +
+                               std::to_string(size);
+  std::lock_guard<std::mutex> lock(mutex);
+  auto pool = cache[full_key].lock();
+  if (pool == nullptr) {
+    pool.reset(new ResetPool(key, size, seed, generation, factory));
+    pool->builder_ = std::thread([ptr = pool.get(), num_threads] {
+      ptr->Build(num_threads);
+    });
+    cache[full_key] = pool;
+  }
+  return pool;
+}
+
+void ResetPool::Build(std::size_t num_threads) {
+  const std::size_t size = states_.size();
+  std::vector<std::thread> workers;
+  std::vector<std::exception_ptr> errors(num_threads);
+  for (std::size_t t = 0; t < num_threads; t++) {
+    workers.emplace_back([&, t] {
+      try {
+        std::unique_ptr<MujocoEnv> env = factory_();
+        for (std::size_t i = t; i < size && !cancelled_; i += num_threads) {
+          std::seed_seq seq{seed_, generation_, static_cast<int>(i)};
+          env->GenResetState(&seq, &states_[i]);
+        }
+      } catch (...) {
+        errors[t] = std::current_exception();
+      }
+    });
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto& error : errors) {
+    if (error != nullptr && error_ == nullptr) {
+      error_ = error;
+    }
+  }
+  built_ = true;
+  built_cv_.notify_all();
+}
+
+void ResetPool::Wait() const {
+  std::unique_lock<std::mutex> lock(mutex_);
+  built_cv_.wait(lock, [this] { return built_; });
+  if (error_ != nullptr) {
+    std::rethrow_exception(error_);
+  }
+}
+
+void ResetPool::BuildNext() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (next_ == nullptr) {
+    next_ = Get(key_, states_.size(), seed_, generation_ + 1, factory_, 1);
+  }
+}
+
+}  // namespace mujoco_dmc
@@ -0,0 +1,108 @@
+/*
+ * Copyright 2023 Garena Online Private Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ENVPOOL_MUJOCO_DMC_RESET_POOL_H_
+#define ENVPOOL_MUJOCO_DMC_RESET_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace mujoco_dmc {
+
+class MujocoEnv;
+
+/**
+ * Initial states pre-generated by a task's full reset, shared by every env of
+ * the task in the process. A state is what `MujocoEnv::GenResetState` writes,
+ * taken before the last mj_forward of the reset.
+ *
+ * Generations after the first are built ahead, off the step path: opening a
+ * generation starts building the next one on a single background thread, so
+ * an env moving on with `Next` normally finds it ready. Building one pool
+ * only ever blocks the envs waiting for that very pool.
+ */
+class ResetPool {
+ public:
+  // Builds a fresh env of the task without a reset pool, used to generate
+  // states.
+  using EnvFactory = std::function<std::unique_ptr<MujocoEnv>()>;
+
+  /**
+   * Returns generation 0 of the pool of `key`, generating its `size` states
+   * with envs from `factory` on all cores if it does not exist yet. State `i`
+   * of a generation is generated from a generator seeded with (`seed`,
+   * generation, `i`), so the pool does not depend on the number of threads.
+   * `key` must identify everything the task's reset depends on. With
+   * `build_next`, generation 1 starts building in the background.
+   */
+  static std::shared_ptr<const ResetPool> Open(const std::string& key,
+                                               std::size_t size, int seed,
+                                               const EnvFactory& factory,
+                                               bool build_next);
+
+  // The next generation, waiting for it if it is still being built, and
+  // starts building the one after it.
+  [[nodiscard]] std::shared_ptr<const ResetPool> Next() const;
+
+  ~ResetPool();
+
+  [[nodiscard]] std::size_t Size() const { return states_.size(); }
+  [[nodiscard]] const std::vector<uint8_t>& State(std::size_t i) const {
+    return states_[i];
+  }
+
+ protected:
+  std::string key_;
+  int seed_, generation_;
+  EnvFactory factory_;
+  std::vector<std::vector<uint8_t>> states_;
+
+  mutable std::mutex mutex_;  // guards built_, error_ and next_
+  mutable std::condition_variable built_cv_;
+  bool built_{false};
+  std::exception_ptr error_;
+  mutable std::shared_ptr<const ResetPool> next_;
+  std::atomic<bool> cancelled_{false};
+  std::thread builder_;
+
+  ResetPool(std::string key, std::size_t size, int seed, int generation,
+            EnvFactory factory);
+
+  // Returns generation `generation` of the pool of `key`, starting to build
+  // it on `num_threads` threads in the background if it does not exist yet.
+  static std::shared_ptr<ResetPool> Get(const std::string& key,
+                                        std::size_t size, int seed,
+                                        int generation,
+                                        const EnvFactory& factory,
+                                        std::size_t num_threads);
+  void Build(std::size_t num_threads);
+  // Blocks until the states are built, rethrowing a generation error.
+  void Wait() const;
+  void BuildNext() const;
+};
+
+}  // namespace mujoco_dmc
+
+#endif  // ENVPOOL_MUJOCO_DMC_RESET_POOL_H_
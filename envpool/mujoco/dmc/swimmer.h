@@ -51,7 +51,12 @@ class SwimmerEnvFns {
  public:
   static decltype(auto) DefaultConfig() {
     return MakeDict("frame_skip"_.Bind(15),
-                    "task_name"_.Bind(std::string("swimmer6")));
+                    "task_name"_.Bind(std::string("swimmer6")),
+                    "from_pixels"_.Bind(false), "render_width"_.Bind(84),
+                    "render_height"_.Bind(84), "render_camera_id"_.Bind(0),
+                    "mjb_cache_dir"_.Bind(std::string("")),
+                    "model_randomization"_.Bind(std::string("")),
+                    "reset_pool_size"_.Bind(0), "reset_pool_refresh"_.Bind(0));
   }
   template <typename Config>
   static decltype(auto) StateSpec(const Config& conf) {
@@ -67,7 +72,8 @@ class SwimmerEnvFns {
     }
     return MakeDict("obs:joints"_.Bind(Spec<mjtNum>({n_bodies - 1})),
                     "obs:to_target"_.Bind(Spec<mjtNum>({2})),
-                    "obs:body_velocities"_.Bind(Spec<mjtNum>({3 * n_bodies}))
+                    "obs:body_velocities"_.Bind(Spec<mjtNum>({3 * n_bodies})),
+                    "obs:pixels"_.Bind(PixelSpec(conf))
 #ifdef ENVPOOL_TEST
                         ,
                     "info:qpos0"_.Bind(Spec<mjtNum>({n_bodies + 2})),
@@ -104,11 +110,17 @@ class SwimmerEnv : public Env<SwimmerEnvSpec>, public MujocoEnv {
         MujocoEnv(
             spec.config["base_path"_],
             GetSwimmerXML(spec.config["base_path"_], spec.config["task_name"_]),
-            spec.config["frame_skip"_], spec.config["max_episode_steps"_]),
+            spec.config["frame_skip"_], spec.config["max_episode_steps"_],
+            spec.config["mjb_cache_dir"_], spec.config["model_randomization"_],
+            spec.config["reset_pool_size"_],
+            spec.config["reset_pool_refresh"_]),
         id_head_(mj_name2id(model_, mjOBJ_GEOM, "head")),
         id_nose_(mj_name2id(model_, mjOBJ_GEOM, "nose")),
         id_target_(mj_name2id(model_, mjOBJ_GEOM, "target")),
-        id_target_light_(mj_name2id(model_, mjOBJ_LIGHT, "target_light")) {}
+        id_target_light_(mj_name2id(model_, mjOBJ_LIGHT, "target_light")) {
+    CheckRenderConfig(spec.config);
+    OpenResetPool<SwimmerEnv>(spec, &gen_);
+  }
 
   void TaskInitializeEpisode() override {
     RandomizeLimitedAndRotationalJoints(&gen_);
@@ -133,7 +145,7 @@ class SwimmerEnv : public Env<SwimmerEnvSpec>, public MujocoEnv {
   bool IsDone() override { return done_; }
 
   void Reset() override {
-    ControlReset();
+    ControlReset(&gen_);
     WriteState();
   }
 
@@ -152,6 +164,20 @@ class SwimmerEnv : public Env<SwimmerEnvSpec>, public MujocoEnv {
 
   bool TaskShouldTerminateEpisode() override { return false; }
 
+  void TaskSerialize(ByteWriter* writer) override {
+    writer->WriteArray(model_->geom_pos + id_target_ * 3, 3);
+    writer->WriteArray(model_->light_pos + id_target_light_ * 3, 3);
+  }
+
+  void TaskDeserialize(ByteReader* reader) override {
+    reader->ReadArray(model_->geom_pos + id_target_ * 3, 3);
+    reader->ReadArray(model_->light_pos + id_target_light_ * 3, 3);
+  }
+
+  void Serialize(ByteWriter* writer) override { MujocoSerialize(writer); }
+
+  void Deserialize(ByteReader* reader) override { MujocoDeserialize(reader); }
+
  private:
   void WriteState() {
     const auto& joints = Joints();
@@ -161,6 +187,7 @@ class SwimmerEnv : public Env<SwimmerEnvSpec>, public MujocoEnv {
     State state = Allocate();
     state["reward"_] = reward_;
     state["discount"_] = discount_;
+    RenderPixels(state["obs:pixels"_], spec_.config["render_camera_id"_]);
     // obs
     state["obs:joints"_].Assign(joints.data(), joints.size());
     state["obs:to_target"_].Assign(to_target.begin(), to_target.size());
@@ -16,26 +16,48 @@
 from envpool.mujoco.mujoco_gym_envpool import (
   _GymAntEnvPool,
   _GymAntEnvSpec,
+  _GymAntFloat64EnvPool,
+  _GymAntFloat64EnvSpec,
   _GymHalfCheetahEnvPool,
   _GymHalfCheetahEnvSpec,
+  _GymHalfCheetahFloat64EnvPool,
+  _GymHalfCheetahFloat64EnvSpec,
   _GymHopperEnvPool,
   _GymHopperEnvSpec,
+  _GymHopperFloat64EnvPool,
+  _GymHopperFloat64EnvSpec,
   _GymHumanoidEnvPool,
   _GymHumanoidEnvSpec,
+  _GymHumanoidFloat64EnvPool,
+  _GymHumanoidFloat64EnvSpec,
   _GymHumanoidStandupEnvPool,
   _GymHumanoidStandupEnvSpec,
+  _GymHumanoidStandupFloat64EnvPool,
+  _GymHumanoidStandupFloat64EnvSpec,
   _GymInvertedDoublePendulumEnvPool,
   _GymInvertedDoublePendulumEnvSpec,
+  _GymInvertedDoublePendulumFloat64EnvPool,
+  _GymInvertedDoublePendulumFloat64EnvSpec,
   _GymInvertedPendulumEnvPool,
   _GymInvertedPendulumEnvSpec,
+  _GymInvertedPendulumFloat64EnvPool,
+  _GymInvertedPendulumFloat64EnvSpec,
   _GymPusherEnvPool,
   _GymPusherEnvSpec,
+  _GymPusherFloat64EnvPool,
+  _GymPusherFloat64EnvSpec,
   _GymReacherEnvPool,
   _GymReacherEnvSpec,
+  _GymReacherFloat64EnvPool,
+  _GymReacherFloat64EnvSpec,
   _GymSwimmerEnvPool,
   _GymSwimmerEnvSpec,
+  _GymSwimmerFloat64EnvPool,
+  _GymSwimmerFloat64EnvSpec,
   _GymWalker2dEnvPool,
   _GymWalker2dEnvSpec,
+  _GymWalker2dFloat64EnvPool,
+  _GymWalker2dFloat64EnvSpec,
 )
 from envpool.python.api import py_env
 
@@ -91,6 +113,81 @@ from envpool.python.api import py_env
   GymWalker2dEnvSpec, GymWalker2dDMEnvPool, GymWalker2dGymEnvPool,
   GymWalker2dGymnasiumEnvPool
 ) = py_env(_GymWalker2dEnvSpec, _GymWalker2dEnvPool)
+(
+  GymAntFloat64EnvSpec,
+  GymAntFloat64DMEnvPool,
+  GymAntFloat64GymEnvPool,
+  GymAntFloat64GymnasiumEnvPool,
+) = py_env(_GymAntFloat64EnvSpec, _GymAntFloat64EnvPool)
+(
+  GymHalfCheetahFloat64EnvSpec,
+  GymHalfCheetahFloat64DMEnvPool,
+  GymHalfCheetahFloat64GymEnvPool,
+  GymHalfCheetahFloat64GymnasiumEnvPool,
+) = py_env(_GymHalfCheetahFloat64EnvSpec, _GymHalfCheetahFloat64EnvPool)
+(
+  GymHopperFloat64EnvSpec,
+  GymHopperFloat64DMEnvPool,
+  GymHopperFloat64GymEnvPool,
+  GymHopperFloat64GymnasiumEnvPool,
+) = py_env(_GymHopperFloat64EnvSpec, _GymHopperFloat64EnvPool)
+(
+  GymHumanoidFloat64EnvSpec,
+  GymHumanoidFloat64DMEnvPool,
+  GymHumanoidFloat64GymEnvPool,
+  GymHumanoidFloat64GymnasiumEnvPool,
+) = py_env(_GymHumanoidFloat64EnvSpec, _GymHumanoidFloat64EnvPool)
+(
+  GymHumanoidStandupFloat64EnvSpec,
+  GymHumanoidStandupFloat64DMEnvPool,
+  GymHumanoidStandupFloat64GymEnvPool,
+  GymHumanoidStandupFloat64GymnasiumEnvPool,
+) = py_env(
+  _GymHumanoidStandupFloat64EnvSpec,
+  _GymHumanoidStandupFloat64EnvPool,
+)
+(
+  GymInvertedDoublePendulumFloat64EnvSpec,
+  GymInvertedDoublePendulumFloat64DMEnvPool,
+  GymInvertedDoublePendulumFloat64GymEnvPool,
+  GymInvertedDoublePendulumFloat64GymnasiumEnvPool,
+) = py_env(
+  _GymInvertedDoublePendulumFloat64EnvSpec,
+  _GymInvertedDoublePendulumFloat64EnvPool,
+)
+(
+  GymInvertedPendulumFloat64EnvSpec,
+  GymInvertedPendulumFloat64DMEnvPool,
+  GymInvertedPendulumFloat64GymEnvPool,
+  GymInvertedPendulumFloat64GymnasiumEnvPool,
+) = py_env(
+  _GymInvertedPendulumFloat64EnvSpec,
+  _GymInvertedPendulumFloat64EnvPool,
+)
+(
+  GymPusherFloat64EnvSpec,
+  GymPusherFloat64DMEnvPool,
+  GymPusherFloat64GymEnvPool,
+  GymPusherFloat64GymnasiumEnvPool,
+) = py_env(_GymPusherFloat64EnvSpec, _GymPusherFloat64EnvPool)
+(
+  GymReacherFloat64EnvSpec,
+  GymReacherFloat64DMEnvPool,
+  GymReacherFloat64GymEnvPool,
+  GymReacherFloat64GymnasiumEnvPool,
+) = py_env(_GymReacherFloat64EnvSpec, _GymReacherFloat64EnvPool)
+(
+  GymSwimmerFloat64EnvSpec,
+  GymSwimmerFloat64DMEnvPool,
+  GymSwimmerFloat64GymEnvPool,
+  GymSwimmerFloat64GymnasiumEnvPool,
+) = py_env(_GymSwimmerFloat64EnvSpec, _GymSwimmerFloat64EnvPool)
+(
+  GymWalker2dFloat64EnvSpec,
+  GymWalker2dFloat64DMEnvPool,
+  GymWalker2dFloat64GymEnvPool,
+  GymWalker2dFloat64GymnasiumEnvPool,
+) = py_env(_GymWalker2dFloat64EnvSpec, _GymWalker2dFloat64EnvPool)
 
 __all__ = [
   "GymAntEnvSpec",
@@ -137,4 +234,48 @@ __all__ = [
   "GymWalker2dDMEnvPool",
   "GymWalker2dGymEnvPool",
   "GymWalker2dGymnasiumEnvPool",
+  "GymAntFloat64EnvSpec",
+  "GymAntFloat64DMEnvPool",
+  "GymAntFloat64GymEnvPool",
+  "GymAntFloat64GymnasiumEnvPool",
+  "GymHalfCheetahFloat64EnvSpec",
+  "GymHalfCheetahFloat64DMEnvPool",
+  "GymHalfCheetahFloat64GymEnvPool",
+  "GymHalfCheetahFloat64GymnasiumEnvPool",
+  "GymHopperFloat64EnvSpec",
+  "GymHopperFloat64DMEnvPool",
+  "GymHopperFloat64GymEnvPool",
+  "GymHopperFloat64GymnasiumEnvPool",
+  "GymHumanoidFloat64EnvSpec",
+  "GymHumanoidFloat64DMEnvPool",
+  "GymHumanoidFloat64GymEnvPool",
+  "GymHumanoidFloat64GymnasiumEnvPool",
+  "GymHumanoidStandupFloat64EnvSpec",
+  "GymHumanoidStandupFloat64DMEnvPool",
+  "GymHumanoidStandupFloat64GymEnvPool",
+  "GymHumanoidStandupFloat64GymnasiumEnvPool",
+  "GymInvertedDoublePendulumFloat64EnvSpec",
+  "GymInvertedDoublePendulumFloat64DMEnvPool",
+  "GymInvertedDoublePendulumFloat64GymEnvPool",
+  "GymInvertedDoublePendulumFloat64GymnasiumEnvPool",
+  "GymInvertedPendulumFloat64EnvSpec",
+  "GymInvertedPendulumFloat64DMEnvPool",
+  "GymInvertedPendulumFloat64GymEnvPool",
+  "GymInvertedPendulumFloat64GymnasiumEnvPool",
+  "GymPusherFloat64EnvSpec",
+  "GymPusherFloat64DMEnvPool",
+  "GymPusherFloat64GymEnvPool",
+  "GymPusherFloat64GymnasiumEnvPool",
+  "GymReacherFloat64EnvSpec",
+  "GymReacherFloat64DMEnvPool",
+  "GymReacherFloat64GymEnvPool",
+  "GymReacherFloat64GymnasiumEnvPool",
+  "GymSwimmerFloat64EnvSpec",
+  "GymSwimmerFloat64DMEnvPool",
+  "GymSwimmerFloat64GymEnvPool",
+  "GymSwimmerFloat64GymnasiumEnvPool",
+  "GymWalker2dFloat64EnvSpec",
+  "GymWalker2dFloat64DMEnvPool",
+  "GymWalker2dFloat64GymEnvPool",
+  "GymWalker2dFloat64GymnasiumEnvPool",
 ]
@@ -28,6 +28,7 @@
 
 namespace mujoco_gym {
 
+template <typename ObsType>
 class AntEnvFns {
  public:
   static decltype(auto) DefaultConfig() {
@@ -40,16 +41,17 @@ class AntEnvFns {
         "contact_cost_weight"_.Bind(5e-4), "healthy_reward"_.Bind(1.0),
         "healthy_z_min"_.Bind(0.2), "healthy_z_max"_.Bind(1.0),
         "contact_force_min"_.Bind(-1.0), "contact_force_max"_.Bind(1.0),
-        "reset_noise_scale"_.Bind(0.1));
+        "reset_noise_scale"_.Bind(0.1), "mjb_cache_dir"_.Bind(std::string("")),
+        "model_randomization"_.Bind(std::string("")));
   }
   template <typename Config>
   static decltype(auto) StateSpec(const Config& conf) {
-    mjtNum inf = std::numeric_limits<mjtNum>::infinity();
+    ObsType inf = std::numeric_limits<ObsType>::infinity();
     int obs_n = conf["exclude_current_positions_from_observation"_] ? 27 : 29;
     if (conf["use_contact_force"_]) {
       obs_n += 14 * 6;
     }
-    return MakeDict("obs"_.Bind(Spec<mjtNum>({obs_n}, {-inf, inf})),
+    return MakeDict("obs"_.Bind(Spec<ObsType>({obs_n}, {-inf, inf})),
 #ifdef ENVPOOL_TEST
                     "info:qpos0"_.Bind(Spec<mjtNum>({15})),
                     "info:qvel0"_.Bind(Spec<mjtNum>({14})),
@@ -70,10 +72,19 @@ class AntEnvFns {
   }
 };
 
-using AntEnvSpec = EnvSpec<AntEnvFns>;
+template <typename ObsType>
+class AntEnvT : public Env<EnvSpec<AntEnvFns<ObsType>>>, public MujocoEnv {
+ public:
+  using Base = Env<EnvSpec<AntEnvFns<ObsType>>>;
+  using typename Base::Action;
+  using typename Base::Spec;
+  using typename Base::State;
 
-class AntEnv : public Env<AntEnvSpec>, public MujocoEnv {
  protected:
+  using Base::Allocate;
+  using Base::gen_;
+
+  ObsLayout obs_layout_;
   int id_torso_;
   bool terminate_when_unhealthy_, no_pos_, use_contact_force_;
   mjtNum ctrl_cost_weight_, contact_cost_weight_;
@@ -84,11 +95,13 @@ class AntEnv : public Env<AntEnvSpec>, public MujocoEnv {
   std::normal_distribution<> dist_qvel_;
 
  public:
-  AntEnv(const Spec& spec, int env_id)
-      : Env<AntEnvSpec>(spec, env_id),
+  AntEnvT(const Spec& spec, int env_id)
+      : Base(spec, env_id),
         MujocoEnv(spec.config["base_path"_] + "/mujoco/assets_gym/ant.xml",
                   spec.config["frame_skip"_], spec.config["post_constraint"_],
-                  spec.config["max_episode_steps"_]),
+                  spec.config["max_episode_steps"_],
+                  spec.config["mjb_cache_dir"_],
+                  spec.config["model_randomization"_]),
         id_torso_(mj_name2id(model_, mjOBJ_XBODY, "torso")),
         terminate_when_unhealthy_(spec.config["terminate_when_unhealthy"_]),
         no_pos_(spec.config["exclude_current_positions_from_observation"_]),
@@ -103,7 +116,14 @@ class AntEnv : public Env<AntEnvSpec>, public MujocoEnv {
         contact_force_max_(spec.config["contact_force_max"_]),
         dist_qpos_(-spec.config["reset_noise_scale"_],
                    spec.config["reset_noise_scale"_]),
-        dist_qvel_(0, spec.config["reset_noise_scale"_]) {}
+        dist_qvel_(0, spec.config["reset_noise_scale"_]) {
+    obs_layout_.Add(&mjData::qpos, no_pos_ ? 2 : 0, model_->nq)
+        .Add(&mjData::qvel, 0, model_->nv);
+    if (use_contact_force_) {
+      obs_layout_.AddClipped(&mjData::cfrc_ext, 0, 6 * model_->nbody,
+                             contact_force_min_, contact_force_max_);
+    }
+  }
 
   void MujocoResetModel() override {
     for (int i = 0; i < model_->nq; ++i) {
@@ -123,7 +143,7 @@ class AntEnv : public Env<AntEnvSpec>, public MujocoEnv {
   void Reset() override {
     done_ = false;
     elapsed_step_ = 0;
-    MujocoReset();
+    MujocoReset(&gen_);
     WriteState(0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0);
   }
 
@@ -167,6 +187,10 @@ class AntEnv : public Env<AntEnvSpec>, public MujocoEnv {
                healthy_reward);
   }
 
+  void Serialize(ByteWriter* writer) override { MujocoSerialize(writer); }
+
+  void Deserialize(ByteReader* reader) override { MujocoDeserialize(reader); }
+
  private:
   bool IsHealthy() {
     if (data_->qpos[2] < healthy_z_min_ || data_->qpos[2] > healthy_z_max_) {
@@ -191,20 +215,7 @@ class AntEnv : public Env<AntEnvSpec>, public MujocoEnv {
     State state = Allocate();
     state["reward"_] = reward;
     // obs
-    mjtNum* obs = static_cast<mjtNum*>(state["obs"_].Data());
-    for (int i = no_pos_ ? 2 : 0; i < model_->nq; ++i) {
-      *(obs++) = data_->qpos[i];
-    }
-    for (int i = 0; i < model_->nv; ++i) {
-      *(obs++) = data_->qvel[i];
-    }
-    if (use_contact_force_) {
-      for (int i = 0; i < 6 * model_->nbody; ++i) {
-        mjtNum x = data_->cfrc_ext[i];
-        x = std::min(std::max(x, contact_force_min_), contact_force_max_);
-        *(obs++) = x;
-      }
-    }
+    obs_layout_.Write(data_, static_cast<ObsType*>(state["obs"_].Data()));
     // info
     state["info:reward_forward"_] = xv * forward_reward_weight_;
     state["info:reward_ctrl"_] = -ctrl_cost;
@@ -223,8 +234,14 @@ class AntEnv : public Env<AntEnvSpec>, public MujocoEnv {
   }
 };
 
+using AntEnv = AntEnvT<float>;
+using AntEnvSpec = AntEnv::Spec;
 using AntEnvPool = AsyncEnvPool<AntEnv>;
 
+using AntFloat64Env = AntEnvT<mjtNum>;
+using AntFloat64EnvSpec = AntFloat64Env::Spec;
+using AntFloat64EnvPool = AsyncEnvPool<AntFloat64Env>;
+
 }  // namespace mujoco_gym
 
 #endif  // ENVPOOL_MUJOCO_GYM_ANT_H_
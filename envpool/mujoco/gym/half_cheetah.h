@@ -28,6 +28,7 @@
 
 namespace mujoco_gym {
 
+template <typename ObsType>
 class HalfCheetahEnvFns {
  public:
   static decltype(auto) DefaultConfig() {
@@ -36,13 +37,15 @@ class HalfCheetahEnvFns {
                     "exclude_current_positions_from_observation"_.Bind(true),
                     "ctrl_cost_weight"_.Bind(0.1),
                     "forward_reward_weight"_.Bind(1.0),
-                    "reset_noise_scale"_.Bind(0.1));
+                    "reset_noise_scale"_.Bind(0.1),
+                    "mjb_cache_dir"_.Bind(std::string("")),
+                    "model_randomization"_.Bind(std::string("")));
   }
   template <typename Config>
   static decltype(auto) StateSpec(const Config& conf) {
-    mjtNum inf = std::numeric_limits<mjtNum>::infinity();
+    ObsType inf = std::numeric_limits<ObsType>::infinity();
     bool no_pos = conf["exclude_current_positions_from_observation"_];
-    return MakeDict("obs"_.Bind(Spec<mjtNum>({no_pos ? 17 : 18}, {-inf, inf})),
+    return MakeDict("obs"_.Bind(Spec<ObsType>({no_pos ? 17 : 18}, {-inf, inf})),
 #ifdef ENVPOOL_TEST
                     "info:qpos0"_.Bind(Spec<mjtNum>({9})),
                     "info:qvel0"_.Bind(Spec<mjtNum>({9})),
@@ -58,28 +61,42 @@ class HalfCheetahEnvFns {
   }
 };
 
-using HalfCheetahEnvSpec = EnvSpec<HalfCheetahEnvFns>;
+template <typename ObsType>
+class HalfCheetahEnvT : public Env<EnvSpec<HalfCheetahEnvFns<ObsType>>>,
+                        public MujocoEnv {
+ public:
+  using Base = Env<EnvSpec<HalfCheetahEnvFns<ObsType>>>;
+  using typename Base::Action;
+  using typename Base::Spec;
+  using typename Base::State;
 
-class HalfCheetahEnv : public Env<HalfCheetahEnvSpec>, public MujocoEnv {
  protected:
+  using Base::Allocate;
+  using Base::gen_;
+
+  ObsLayout obs_layout_;
   bool no_pos_;
   mjtNum ctrl_cost_weight_, forward_reward_weight_;
   std::uniform_real_distribution<> dist_qpos_;
   std::normal_distribution<> dist_qvel_;
 
  public:
-  HalfCheetahEnv(const Spec& spec, int env_id)
-      : Env<HalfCheetahEnvSpec>(spec, env_id),
+  HalfCheetahEnvT(const Spec& spec, int env_id)
+      : Base(spec, env_id),
         MujocoEnv(
             spec.config["base_path"_] + "/mujoco/assets_gym/half_cheetah.xml",
             spec.config["frame_skip"_], spec.config["post_constraint"_],
-            spec.config["max_episode_steps"_]),
+            spec.config["max_episode_steps"_], spec.config["mjb_cache_dir"_],
+            spec.config["model_randomization"_]),
         no_pos_(spec.config["exclude_current_positions_from_observation"_]),
         ctrl_cost_weight_(spec.config["ctrl_cost_weight"_]),
         forward_reward_weight_(spec.config["forward_reward_weight"_]),
         dist_qpos_(-spec.config["reset_noise_scale"_],
                    spec.config["reset_noise_scale"_]),
-        dist_qvel_(0, spec.config["reset_noise_scale"_]) {}
+        dist_qvel_(0, spec.config["reset_noise_scale"_]) {
+    obs_layout_.Add(&mjData::qpos, no_pos_ ? 1 : 0, model_->nq)
+        .Add(&mjData::qvel, 0, model_->nv);
+  }
 
   void MujocoResetModel() override {
     for (int i = 0; i < model_->nq; ++i) {
@@ -99,7 +116,7 @@ class HalfCheetahEnv : public Env<HalfCheetahEnvSpec>, public MujocoEnv {
   void Reset() override {
     done_ = false;
     elapsed_step_ = 0;
-    MujocoReset();
+    MujocoReset(&gen_);
     WriteState(0.0, 0.0, 0.0, 0.0);
   }
 
@@ -124,18 +141,16 @@ class HalfCheetahEnv : public Env<HalfCheetahEnvSpec>, public MujocoEnv {
     WriteState(reward, xv, ctrl_cost, x_after);
   }
 
+  void Serialize(ByteWriter* writer) override { MujocoSerialize(writer); }
+
+  void Deserialize(ByteReader* reader) override { MujocoDeserialize(reader); }
+
  private:
   void WriteState(float reward, mjtNum xv, mjtNum ctrl_cost, mjtNum x_after) {
     State state = Allocate();
     state["reward"_] = reward;
     // obs
-    mjtNum* obs = static_cast<mjtNum*>(state["obs"_].Data());
-    for (int i = no_pos_ ? 1 : 0; i < model_->nq; ++i) {
-      *(obs++) = data_->qpos[i];
-    }
-    for (int i = 0; i < model_->nv; ++i) {
-      *(obs++) = data_->qvel[i];
-    }
+    obs_layout_.Write(data_, static_cast<ObsType*>(state["obs"_].Data()));
     // info
     state["info:reward_run"_] = xv * forward_reward_weight_;
     state["info:reward_ctrl"_] = -ctrl_cost;
@@ -148,8 +163,14 @@ class HalfCheetahEnv : public Env<HalfCheetahEnvSpec>, public MujocoEnv {
   }
 };
 
+using HalfCheetahEnv = HalfCheetahEnvT<float>;
+using HalfCheetahEnvSpec = HalfCheetahEnv::Spec;
 using HalfCheetahEnvPool = AsyncEnvPool<HalfCheetahEnv>;
 
+using HalfCheetahFloat64Env = HalfCheetahEnvT<mjtNum>;
+using HalfCheetahFloat64EnvSpec = HalfCheetahFloat64Env::Spec;
+using HalfCheetahFloat64EnvPool = AsyncEnvPool<HalfCheetahFloat64Env>;
+
 }  // namespace mujoco_gym
 
 #endif  // ENVPOOL_MUJOCO_GYM_HALF_CHEETAH_H_
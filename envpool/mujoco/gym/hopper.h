@@ -28,6 +28,7 @@
 
 namespace mujoco_gym {
 
+template <typename ObsType>
 class HopperEnvFns {
  public:
   static decltype(auto) DefaultConfig() {
@@ -40,13 +41,15 @@ class HopperEnvFns {
         "velocity_max"_.Bind(10.0), "healthy_state_min"_.Bind(-100.0),
         "healthy_state_max"_.Bind(100.0), "healthy_angle_min"_.Bind(-0.2),
         "healthy_angle_max"_.Bind(0.2), "healthy_z_min"_.Bind(0.7),
-        "reset_noise_scale"_.Bind(5e-3));
+        "reset_noise_scale"_.Bind(5e-3),
+        "mjb_cache_dir"_.Bind(std::string("")),
+        "model_randomization"_.Bind(std::string("")));
   }
   template <typename Config>
   static decltype(auto) StateSpec(const Config& conf) {
-    mjtNum inf = std::numeric_limits<mjtNum>::infinity();
+    ObsType inf = std::numeric_limits<ObsType>::infinity();
     bool no_pos = conf["exclude_current_positions_from_observation"_];
-    return MakeDict("obs"_.Bind(Spec<mjtNum>({no_pos ? 11 : 12}, {-inf, inf})),
+    return MakeDict("obs"_.Bind(Spec<ObsType>({no_pos ? 11 : 12}, {-inf, inf})),
 #ifdef ENVPOOL_TEST
                     "info:qpos0"_.Bind(Spec<mjtNum>({6})),
                     "info:qvel0"_.Bind(Spec<mjtNum>({6})),
@@ -60,10 +63,20 @@ class HopperEnvFns {
   }
 };
 
-using HopperEnvSpec = EnvSpec<HopperEnvFns>;
+template <typename ObsType>
+class HopperEnvT : public Env<EnvSpec<HopperEnvFns<ObsType>>>,
+                   public MujocoEnv {
+ public:
+  using Base = Env<EnvSpec<HopperEnvFns<ObsType>>>;
+  using typename Base::Action;
+  using typename Base::Spec;
+  using typename Base::State;
 
-class HopperEnv : public Env<HopperEnvSpec>, public MujocoEnv {
  protected:
+  using Base::Allocate;
+  using Base::gen_;
+
+  ObsLayout obs_layout_;
   bool terminate_when_unhealthy_, no_pos_;
   mjtNum ctrl_cost_weight_, forward_reward_weight_;
   mjtNum healthy_reward_, healthy_z_min_;
@@ -73,11 +86,13 @@ class HopperEnv : public Env<HopperEnvSpec>, public MujocoEnv {
   std::uniform_real_distribution<> dist_;
 
  public:
-  HopperEnv(const Spec& spec, int env_id)
-      : Env<HopperEnvSpec>(spec, env_id),
+  HopperEnvT(const Spec& spec, int env_id)
+      : Base(spec, env_id),
         MujocoEnv(spec.config["base_path"_] + "/mujoco/assets_gym/hopper.xml",
                   spec.config["frame_skip"_], spec.config["post_constraint"_],
-                  spec.config["max_episode_steps"_]),
+                  spec.config["max_episode_steps"_],
+                  spec.config["mjb_cache_dir"_],
+                  spec.config["model_randomization"_]),
         terminate_when_unhealthy_(spec.config["terminate_when_unhealthy"_]),
         no_pos_(spec.config["exclude_current_positions_from_observation"_]),
         ctrl_cost_weight_(spec.config["ctrl_cost_weight"_]),
@@ -91,7 +106,11 @@ class HopperEnv : public Env<HopperEnvSpec>, public MujocoEnv {
         healthy_angle_min_(spec.config["healthy_angle_min"_]),
         healthy_angle_max_(spec.config["healthy_angle_max"_]),
         dist_(-spec.config["reset_noise_scale"_],
-              spec.config["reset_noise_scale"_]) {}
+              spec.config["reset_noise_scale"_]) {
+    obs_layout_.Add(&mjData::qpos, no_pos_ ? 1 : 0, model_->nq)
+        .AddClipped(&mjData::qvel, 0, model_->nv, velocity_min_,
+                    velocity_max_);
+  }
 
   void MujocoResetModel() override {
     for (int i = 0; i < model_->nq; ++i) {
@@ -111,7 +130,7 @@ class HopperEnv : public Env<HopperEnvSpec>, public MujocoEnv {
   void Reset() override {
     done_ = false;
     elapsed_step_ = 0;
-    MujocoReset();
+    MujocoReset(&gen_);
     WriteState(0.0, 0.0, 0.0);
   }
 
@@ -141,6 +160,10 @@ class HopperEnv : public Env<HopperEnvSpec>, public MujocoEnv {
     WriteState(reward, xv, x_after);
   }
 
+  void Serialize(ByteWriter* writer) override { MujocoSerialize(writer); }
+
+  void Deserialize(ByteReader* reader) override { MujocoDeserialize(reader); }
+
  private:
   bool IsHealthy() {
     mjtNum z = data_->qpos[1];
@@ -168,16 +191,7 @@ class HopperEnv : public Env<HopperEnvSpec>, public MujocoEnv {
     State state = Allocate();
     state["reward"_] = reward;
     // obs
-    mjtNum* obs = static_cast<mjtNum*>(state["obs"_].Data());
-    for (int i = no_pos_ ? 1 : 0; i < model_->nq; ++i) {
-      *(obs++) = data_->qpos[i];
-    }
-    for (int i = 0; i < model_->nv; ++i) {
-      mjtNum x = data_->qvel[i];
-      x = std::min(velocity_max_, x);
-      x = std::max(velocity_min_, x);
-      *(obs++) = x;
-    }
+    obs_layout_.Write(data_, static_cast<ObsType*>(state["obs"_].Data()));
     // info
     state["info:x_position"_] = x_after;
     state["info:x_velocity"_] = xv;
@@ -188,8 +202,14 @@ class HopperEnv : public Env<HopperEnvSpec>, public MujocoEnv {
   }
 };
 
+using HopperEnv = HopperEnvT<float>;
+using HopperEnvSpec = HopperEnv::Spec;
 using HopperEnvPool = AsyncEnvPool<HopperEnv>;
 
+using HopperFloat64Env = HopperEnvT<mjtNum>;
+using HopperFloat64EnvSpec = HopperFloat64Env::Spec;
+using HopperFloat64EnvPool = AsyncEnvPool<HopperFloat64Env>;
+
 }  // namespace mujoco_gym
 
 #endif  // ENVPOOL_MUJOCO_GYM_HOPPER_H_
@@ -28,6 +28,7 @@
 
 namespace mujoco_gym {
 
+template <typename ObsType>
 class HumanoidEnvFns {
  public:
   static decltype(auto) DefaultConfig() {
@@ -39,14 +40,16 @@ class HumanoidEnvFns {
         "ctrl_cost_weight"_.Bind(0.1), "healthy_reward"_.Bind(5.0),
         "healthy_z_min"_.Bind(1.0), "healthy_z_max"_.Bind(2.0),
         "contact_cost_weight"_.Bind(5e-7), "contact_cost_max"_.Bind(10.0),
-        "reset_noise_scale"_.Bind(1e-2));
+        "reset_noise_scale"_.Bind(1e-2),
+        "mjb_cache_dir"_.Bind(std::string("")),
+        "model_randomization"_.Bind(std::string("")));
   }
   template <typename Config>
   static decltype(auto) StateSpec(const Config& conf) {
-    mjtNum inf = std::numeric_limits<mjtNum>::infinity();
+    ObsType inf = std::numeric_limits<ObsType>::infinity();
     bool no_pos = conf["exclude_current_positions_from_observation"_];
     return MakeDict(
-        "obs"_.Bind(Spec<mjtNum>({no_pos ? 376 : 378}, {-inf, inf})),
+        "obs"_.Bind(Spec<ObsType>({no_pos ? 376 : 378}, {-inf, inf})),
 #ifdef ENVPOOL_TEST
         "info:qpos0"_.Bind(Spec<mjtNum>({24})),
         "info:qvel0"_.Bind(Spec<mjtNum>({23})),
@@ -67,10 +70,20 @@ class HumanoidEnvFns {
   }
 };
 
-using HumanoidEnvSpec = EnvSpec<HumanoidEnvFns>;
+template <typename ObsType>
+class HumanoidEnvT : public Env<EnvSpec<HumanoidEnvFns<ObsType>>>,
+                     public MujocoEnv {
+ public:
+  using Base = Env<EnvSpec<HumanoidEnvFns<ObsType>>>;
+  using typename Base::Action;
+  using typename Base::Spec;
+  using typename Base::State;
 
-class HumanoidEnv : public Env<HumanoidEnvSpec>, public MujocoEnv {
  protected:
+  using Base::Allocate;
+  using Base::gen_;
+
+  ObsLayout obs_layout_;
   bool terminate_when_unhealthy_, no_pos_, use_contact_force_;
   mjtNum ctrl_cost_weight_, forward_reward_weight_, healthy_reward_;
   mjtNum healthy_z_min_, healthy_z_max_;
@@ -78,11 +91,13 @@ class HumanoidEnv : public Env<HumanoidEnvSpec>, public MujocoEnv {
   std::uniform_real_distribution<> dist_;
 
  public:
-  HumanoidEnv(const Spec& spec, int env_id)
-      : Env<HumanoidEnvSpec>(spec, env_id),
+  HumanoidEnvT(const Spec& spec, int env_id)
+      : Base(spec, env_id),
         MujocoEnv(spec.config["base_path"_] + "/mujoco/assets_gym/humanoid.xml",
                   spec.config["frame_skip"_], spec.config["post_constraint"_],
-                  spec.config["max_episode_steps"_]),
+                  spec.config["max_episode_steps"_],
+                  spec.config["mjb_cache_dir"_],
+                  spec.config["model_randomization"_]),
         terminate_when_unhealthy_(spec.config["terminate_when_unhealthy"_]),
         no_pos_(spec.config["exclude_current_positions_from_observation"_]),
         use_contact_force_(spec.config["use_contact_force"_]),
@@ -94,7 +109,14 @@ class HumanoidEnv : public Env<HumanoidEnvSpec>, public MujocoEnv {
         contact_cost_weight_(spec.config["contact_cost_weight"_]),
         contact_cost_max_(spec.config["contact_cost_max"_]),
         dist_(-spec.config["reset_noise_scale"_],
-              spec.config["reset_noise_scale"_]) {}
+              spec.config["reset_noise_scale"_]) {
+    obs_layout_.Add(&mjData::qpos, no_pos_ ? 2 : 0, model_->nq)
+        .Add(&mjData::qvel, 0, model_->nv)
+        .Add(&mjData::cinert, 0, 10 * model_->nbody)
+        .Add(&mjData::cvel, 0, 6 * model_->nbody)
+        .Add(&mjData::qfrc_actuator, 0, model_->nv)
+        .Add(&mjData::cfrc_ext, 0, 6 * model_->nbody);
+  }
 
   void MujocoResetModel() override {
     for (int i = 0; i < model_->nq; ++i) {
@@ -114,7 +136,7 @@ class HumanoidEnv : public Env<HumanoidEnvSpec>, public MujocoEnv {
   void Reset() override {
     done_ = false;
     elapsed_step_ = 0;
-    MujocoReset();
+    MujocoReset(&gen_);
     WriteState(0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0);
   }
 
@@ -156,6 +178,10 @@ class HumanoidEnv : public Env<HumanoidEnvSpec>, public MujocoEnv {
                healthy_reward);
   }
 
+  void Serialize(ByteWriter* writer) override { MujocoSerialize(writer); }
+
+  void Deserialize(ByteReader* reader) override { MujocoDeserialize(reader); }
+
  private:
   bool IsHealthy() {
     return healthy_z_min_ < data_->qpos[2] && data_->qpos[2] < healthy_z_max_;
@@ -180,25 +206,7 @@ class HumanoidEnv : public Env<HumanoidEnvSpec>, public MujocoEnv {
     State state = Allocate();
     state["reward"_] = reward;
     // obs
-    mjtNum* obs = static_cast<mjtNum*>(state["obs"_].Data());
-    for (int i = no_pos_ ? 2 : 0; i < model_->nq; ++i) {
-      *(obs++) = data_->qpos[i];
-    }
-    for (int i = 0; i < model_->nv; ++i) {
-      *(obs++) = data_->qvel[i];
-    }
-    for (int i = 0; i < 10 * model_->nbody; ++i) {
-      *(obs++) = data_->cinert[i];
-    }
-    for (int i = 0; i < 6 * model_->nbody; ++i) {
-      *(obs++) = data_->cvel[i];
-    }
-    for (int i = 0; i < model_->nv; ++i) {
-      *(obs++) = data_->qfrc_actuator[i];
-    }
-    for (int i = 0; i < 6 * model_->nbody; ++i) {
-      *(obs++) = data_->cfrc_ext[i];
-    }
+    obs_layout_.Write(data_, static_cast<ObsType*>(state["obs"_].Data()));
     // info
     state["info:reward_linvel"_] = xv * forward_reward_weight_;
     state["info:reward_quadctrl"_] = -ctrl_cost;
@@ -217,8 +225,14 @@ class HumanoidEnv : public Env<HumanoidEnvSpec>, public MujocoEnv {
   }
 };
 
+using HumanoidEnv = HumanoidEnvT<float>;
+using HumanoidEnvSpec = HumanoidEnv::Spec;
 using HumanoidEnvPool = AsyncEnvPool<HumanoidEnv>;
 
+using HumanoidFloat64Env = HumanoidEnvT<mjtNum>;
+using HumanoidFloat64EnvSpec = HumanoidFloat64Env::Spec;
+using HumanoidFloat64EnvPool = AsyncEnvPool<HumanoidFloat64Env>;
+
 }  // namespace mujoco_gym
 
 #endif  // ENVPOOL_MUJOCO_GYM_HUMANOID_H_
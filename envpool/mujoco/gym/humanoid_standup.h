@@ -28,6 +28,7 @@
 
 namespace mujoco_gym {
 
+template <typename ObsType>
 class HumanoidStandupEnvFns {
  public:
   static decltype(auto) DefaultConfig() {
@@ -37,18 +38,20 @@ class HumanoidStandupEnvFns {
                     "ctrl_cost_weight"_.Bind(0.1),
                     "contact_cost_weight"_.Bind(5e-7),
                     "contact_cost_max"_.Bind(10.0), "healthy_reward"_.Bind(1.0),
-                    "reset_noise_scale"_.Bind(1e-2));
+                    "reset_noise_scale"_.Bind(1e-2),
+                    "mjb_cache_dir"_.Bind(std::string("")),
+                    "model_randomization"_.Bind(std::string("")));
   }
   template <typename Config>
   static decltype(auto) StateSpec(const Config& conf) {
-    mjtNum inf = std::numeric_limits<mjtNum>::infinity();
+    ObsType inf = std::numeric_limits<ObsType>::infinity();
     bool no_pos = conf["exclude_current_positions_from_observation"_];
     return MakeDict(
 #ifdef ENVPOOL_TEST
         "info:qpos0"_.Bind(Spec<mjtNum>({24})),
         "info:qvel0"_.Bind(Spec<mjtNum>({23})),
 #endif
-        "obs"_.Bind(Spec<mjtNum>({no_pos ? 376 : 378}, {-inf, inf})),
+        "obs"_.Bind(Spec<ObsType>({no_pos ? 376 : 378}, {-inf, inf})),
         "info:reward_linup"_.Bind(Spec<mjtNum>({-1})),
         "info:reward_quadctrl"_.Bind(Spec<mjtNum>({-1})),
         "info:reward_alive"_.Bind(Spec<mjtNum>({-1})),
@@ -60,23 +63,34 @@ class HumanoidStandupEnvFns {
   }
 };
 
-using HumanoidStandupEnvSpec = EnvSpec<HumanoidStandupEnvFns>;
+template <typename ObsType>
+class HumanoidStandupEnvT : public Env<EnvSpec<HumanoidStandupEnvFns<ObsType>>>,
+                            public MujocoEnv {
+ public:
+  using Base = Env<EnvSpec<HumanoidStandupEnvFns<ObsType>>>;
+  using typename Base::Action;
+  using typename Base::Spec;
+  using typename Base::State;
 
-class HumanoidStandupEnv : public Env<HumanoidStandupEnvSpec>,
-                           public MujocoEnv {
  protected:
+  using Base::Allocate;
+  using Base::gen_;
+
+  ObsLayout obs_layout_;
   bool no_pos_;
   mjtNum ctrl_cost_weight_, contact_cost_weight_, contact_cost_max_;
   mjtNum forward_reward_weight_, healthy_reward_;
   std::uniform_real_distribution<> dist_;
 
  public:
-  HumanoidStandupEnv(const Spec& spec, int env_id)
-      : Env<HumanoidStandupEnvSpec>(spec, env_id),
+  HumanoidStandupEnvT(const Spec& spec, int env_id)
+      : Base(spec, env_id),
         MujocoEnv(spec.config["base_path"_] +
                       "/mujoco/assets_gym/humanoidstandup.xml",
                   spec.config["frame_skip"_], spec.config["post_constraint"_],
-                  spec.config["max_episode_steps"_]),
+                  spec.config["max_episode_steps"_],
+                  spec.config["mjb_cache_dir"_],
+                  spec.config["model_randomization"_]),
         no_pos_(spec.config["exclude_current_positions_from_observation"_]),
         ctrl_cost_weight_(spec.config["ctrl_cost_weight"_]),
         contact_cost_weight_(spec.config["contact_cost_weight"_]),
@@ -84,7 +98,14 @@ class HumanoidStandupEnv : public Env<HumanoidStandupEnvSpec>,
         forward_reward_weight_(spec.config["forward_reward_weight"_]),
         healthy_reward_(spec.config["healthy_reward"_]),
         dist_(-spec.config["reset_noise_scale"_],
-              spec.config["reset_noise_scale"_]) {}
+              spec.config["reset_noise_scale"_]) {
+    obs_layout_.Add(&mjData::qpos, no_pos_ ? 2 : 0, model_->nq)
+        .Add(&mjData::qvel, 0, model_->nv)
+        .Add(&mjData::cinert, 0, 10 * model_->nbody)
+        .Add(&mjData::cvel, 0, 6 * model_->nbody)
+        .Add(&mjData::qfrc_actuator, 0, model_->nv)
+        .Add(&mjData::cfrc_ext, 0, 6 * model_->nbody);
+  }
 
   void MujocoResetModel() override {
     for (int i = 0; i < model_->nq; ++i) {
@@ -104,7 +125,7 @@ class HumanoidStandupEnv : public Env<HumanoidStandupEnvSpec>,
   void Reset() override {
     done_ = false;
     elapsed_step_ = 0;
-    MujocoReset();
+    MujocoReset(&gen_);
     WriteState(0.0, 0.0, 0.0, 0.0);
   }
 
@@ -136,31 +157,17 @@ class HumanoidStandupEnv : public Env<HumanoidStandupEnvSpec>,
     WriteState(reward, xv, ctrl_cost, contact_cost);
   }
 
+  void Serialize(ByteWriter* writer) override { MujocoSerialize(writer); }
+
+  void Deserialize(ByteReader* reader) override { MujocoDeserialize(reader); }
+
  private:
   void WriteState(float reward, mjtNum xv, mjtNum ctrl_cost,
                   mjtNum contact_cost) {
     State state = Allocate();
     state["reward"_] = reward;
     // obs
-    mjtNum* obs = static_cast<mjtNum*>(state["obs"_].Data());
-    for (int i = no_pos_ ? 2 : 0; i < model_->nq; ++i) {
-      *(obs++) = data_->qpos[i];
-    }
-    for (int i = 0; i < model_->nv; ++i) {
-      *(obs++) = data_->qvel[i];
-    }
-    for (int i = 0; i < 10 * model_->nbody; ++i) {
-      *(obs++) = data_->cinert[i];
-    }
-    for (int i = 0; i < 6 * model_->nbody; ++i) {
-      *(obs++) = data_->cvel[i];
-    }
-    for (int i = 0; i < model_->nv; ++i) {
-      *(obs++) = data_->qfrc_actuator[i];
-    }
-    for (int i = 0; i < 6 * model_->nbody; ++i) {
-      *(obs++) = data_->cfrc_ext[i];
-    }
+    obs_layout_.Write(data_, static_cast<ObsType*>(state["obs"_].Data()));
     // info
     state["info:reward_linup"_] = xv * forward_reward_weight_;
     state["info:reward_quadctrl"_] = -ctrl_cost;
@@ -173,8 +180,14 @@ class HumanoidStandupEnv : public Env<HumanoidStandupEnvSpec>,
   }
 };
 
+using HumanoidStandupEnv = HumanoidStandupEnvT<float>;
+using HumanoidStandupEnvSpec = HumanoidStandupEnv::Spec;
 using HumanoidStandupEnvPool = AsyncEnvPool<HumanoidStandupEnv>;
 
+using HumanoidStandupFloat64Env = HumanoidStandupEnvT<mjtNum>;
+using HumanoidStandupFloat64EnvSpec = HumanoidStandupFloat64Env::Spec;
+using HumanoidStandupFloat64EnvPool = AsyncEnvPool<HumanoidStandupFloat64Env>;
+
 }  // namespace mujoco_gym
 
 #endif  // ENVPOOL_MUJOCO_GYM_HUMANOID_STANDUP_H_
@@ -28,6 +28,7 @@
 
 namespace mujoco_gym {
 
+template <typename ObsType>
 class InvertedDoublePendulumEnvFns {
  public:
   static decltype(auto) DefaultConfig() {
@@ -35,17 +36,19 @@ class InvertedDoublePendulumEnvFns {
                     "post_constraint"_.Bind(true), "healthy_reward"_.Bind(10.0),
                     "healthy_z_max"_.Bind(1.0), "observation_min"_.Bind(-10.0),
                     "observation_max"_.Bind(10.0),
-                    "reset_noise_scale"_.Bind(0.1));
+                    "reset_noise_scale"_.Bind(0.1),
+                    "mjb_cache_dir"_.Bind(std::string("")),
+                    "model_randomization"_.Bind(std::string("")));
   }
   template <typename Config>
   static decltype(auto) StateSpec(const Config& conf) {
-    mjtNum inf = std::numeric_limits<mjtNum>::infinity();
+    ObsType inf = std::numeric_limits<ObsType>::infinity();
 #ifdef ENVPOOL_TEST
-    return MakeDict("obs"_.Bind(Spec<mjtNum>({11}, {-inf, inf})),
+    return MakeDict("obs"_.Bind(Spec<ObsType>({11}, {-inf, inf})),
                     "info:qpos0"_.Bind(Spec<mjtNum>({3})),
                     "info:qvel0"_.Bind(Spec<mjtNum>({3})));
 #else
-    return MakeDict("obs"_.Bind(Spec<mjtNum>({11}, {-inf, inf})));
+    return MakeDict("obs"_.Bind(Spec<ObsType>({11}, {-inf, inf})));
 #endif
   }
   template <typename Config>
@@ -54,30 +57,48 @@ class InvertedDoublePendulumEnvFns {
   }
 };
 
-using InvertedDoublePendulumEnvSpec = EnvSpec<InvertedDoublePendulumEnvFns>;
+template <typename ObsType>
+class InvertedDoublePendulumEnvT
+    : public Env<EnvSpec<InvertedDoublePendulumEnvFns<ObsType>>>,
+      public MujocoEnv {
+ public:
+  using Base = Env<EnvSpec<InvertedDoublePendulumEnvFns<ObsType>>>;
+  using typename Base::Action;
+  using typename Base::Spec;
+  using typename Base::State;
 
-class InvertedDoublePendulumEnv : public Env<InvertedDoublePendulumEnvSpec>,
-                                  public MujocoEnv {
  protected:
+  using Base::Allocate;
+  using Base::gen_;
+
+  ObsLayout obs_layout_;
   mjtNum healthy_reward_, healthy_z_max_;
   mjtNum observation_min_, observation_max_;
   std::uniform_real_distribution<> dist_qpos_;
   std::normal_distribution<> dist_qvel_;
 
  public:
-  InvertedDoublePendulumEnv(const Spec& spec, int env_id)
-      : Env<InvertedDoublePendulumEnvSpec>(spec, env_id),
+  InvertedDoublePendulumEnvT(const Spec& spec, int env_id)
+      : Base(spec, env_id),
         MujocoEnv(spec.config["base_path"_] +
                       "/mujoco/assets_gym/inverted_double_pendulum.xml",
                   spec.config["frame_skip"_], spec.config["post_constraint"_],
-                  spec.config["max_episode_steps"_]),
+                  spec.config["max_episode_steps"_],
+                  spec.config["mjb_cache_dir"_],
+                  spec.config["model_randomization"_]),
         healthy_reward_(spec.config["healthy_reward"_]),
         healthy_z_max_(spec.config["healthy_z_max"_]),
         observation_min_(spec.config["observation_min"_]),
         observation_max_(spec.config["observation_max"_]),
         dist_qpos_(-spec.config["reset_noise_scale"_],
                    spec.config["reset_noise_scale"_]),
-        dist_qvel_(0, spec.config["reset_noise_scale"_]) {}
+        dist_qvel_(0, spec.config["reset_noise_scale"_]) {
+    obs_layout_
+        .AddClipped(&mjData::qvel, 0, model_->nv, observation_min_,
+                    observation_max_)
+        .AddClipped(&mjData::qfrc_constraint, 0, model_->nv,
+                    observation_min_, observation_max_);
+  }
 
   void MujocoResetModel() override {
     for (int i = 0; i < model_->nq; ++i) {
@@ -97,7 +118,7 @@ class InvertedDoublePendulumEnv : public Env<InvertedDoublePendulumEnvSpec>,
   void Reset() override {
     done_ = false;
     elapsed_step_ = 0;
-    MujocoReset();
+    MujocoReset(&gen_);
     WriteState(0.0);
   }
 
@@ -121,6 +142,10 @@ class InvertedDoublePendulumEnv : public Env<InvertedDoublePendulumEnvSpec>,
     WriteState(reward);
   }
 
+  void Serialize(ByteWriter* writer) override { MujocoSerialize(writer); }
+
+  void Deserialize(ByteReader* reader) override { MujocoDeserialize(reader); }
+
  private:
   bool IsHealthy() { return data_->site_xpos[2] > healthy_z_max_; }
 
@@ -128,24 +153,13 @@ class InvertedDoublePendulumEnv : public Env<InvertedDoublePendulumEnvSpec>,
     State state = Allocate();
     state["reward"_] = reward;
     // obs
-    mjtNum* obs = static_cast<mjtNum*>(state["obs"_].Data());
-    *(obs++) = data_->qpos[0];
-    *(obs++) = std::sin(data_->qpos[1]);
-    *(obs++) = std::sin(data_->qpos[2]);
-    *(obs++) = std::cos(data_->qpos[1]);
-    *(obs++) = std::cos(data_->qpos[2]);
-    for (int i = 0; i < model_->nv; ++i) {
-      mjtNum x = data_->qvel[i];
-      x = std::min(observation_max_, x);
-      x = std::max(observation_min_, x);
-      *(obs++) = x;
-    }
-    for (int i = 0; i < model_->nv; ++i) {
-      mjtNum x = data_->qfrc_constraint[i];
-      x = std::min(observation_max_, x);
-      x = std::max(observation_min_, x);
-      *(obs++) = x;
-    }
+    auto* obs = static_cast<ObsType*>(state["obs"_].Data());
+    *(obs++) = static_cast<ObsType>(data_->qpos[0]);
+    *(obs++) = static_cast<ObsType>(std::sin(data_->qpos[1]));
+    *(obs++) = static_cast<ObsType>(std::sin(data_->qpos[2]));
+    *(obs++) = static_cast<ObsType>(std::cos(data_->qpos[1]));
+    *(obs++) = static_cast<ObsType>(std::cos(data_->qpos[2]));
+    obs_layout_.Write(data_, obs);
     // info
 #ifdef ENVPOOL_TEST
     state["info:qpos0"_].Assign(qpos0_, model_->nq);
@@ -154,8 +168,16 @@ class InvertedDoublePendulumEnv : public Env<InvertedDoublePendulumEnvSpec>,
   }
 };
 
+using InvertedDoublePendulumEnv = InvertedDoublePendulumEnvT<float>;
+using InvertedDoublePendulumEnvSpec = InvertedDoublePendulumEnv::Spec;
 using InvertedDoublePendulumEnvPool = AsyncEnvPool<InvertedDoublePendulumEnv>;
 
+using InvertedDoublePendulumFloat64Env = InvertedDoublePendulumEnvT<mjtNum>;
+using InvertedDoublePendulumFloat64EnvSpec =
+    InvertedDoublePendulumFloat64Env::Spec;
+using InvertedDoublePendulumFloat64EnvPool =
+    AsyncEnvPool<InvertedDoublePendulumFloat64Env>;
+
 }  // namespace mujoco_gym
 
 #endif  // ENVPOOL_MUJOCO_GYM_INVERTED_DOUBLE_PENDULUM_H_
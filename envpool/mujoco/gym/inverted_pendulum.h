@@ -28,23 +28,26 @@
 
 namespace mujoco_gym {
 
+template <typename ObsType>
 class InvertedPendulumEnvFns {
  public:
   static decltype(auto) DefaultConfig() {
     return MakeDict("reward_threshold"_.Bind(950.0), "frame_skip"_.Bind(2),
                     "post_constraint"_.Bind(true), "healthy_reward"_.Bind(1.0),
                     "healthy_z_min"_.Bind(-0.2), "healthy_z_max"_.Bind(0.2),
-                    "reset_noise_scale"_.Bind(0.01));
+                    "reset_noise_scale"_.Bind(0.01),
+                    "mjb_cache_dir"_.Bind(std::string("")),
+                    "model_randomization"_.Bind(std::string("")));
   }
   template <typename Config>
   static decltype(auto) StateSpec(const Config& conf) {
-    mjtNum inf = std::numeric_limits<mjtNum>::infinity();
+    ObsType inf = std::numeric_limits<ObsType>::infinity();
 #ifdef ENVPOOL_TEST
-    return MakeDict("obs"_.Bind(Spec<mjtNum>({4}, {-inf, inf})),
+    return MakeDict("obs"_.Bind(Spec<ObsType>({4}, {-inf, inf})),
                     "info:qpos0"_.Bind(Spec<mjtNum>({2})),
                     "info:qvel0"_.Bind(Spec<mjtNum>({2})));
 #else
-    return MakeDict("obs"_.Bind(Spec<mjtNum>({4}, {-inf, inf})));
+    return MakeDict("obs"_.Bind(Spec<ObsType>({4}, {-inf, inf})));
 #endif
   }
   template <typename Config>
@@ -53,26 +56,41 @@ class InvertedPendulumEnvFns {
   }
 };
 
-using InvertedPendulumEnvSpec = EnvSpec<InvertedPendulumEnvFns>;
+template <typename ObsType>
+class InvertedPendulumEnvT
+    : public Env<EnvSpec<InvertedPendulumEnvFns<ObsType>>>,
+      public MujocoEnv {
+ public:
+  using Base = Env<EnvSpec<InvertedPendulumEnvFns<ObsType>>>;
+  using typename Base::Action;
+  using typename Base::Spec;
+  using typename Base::State;
 
-class InvertedPendulumEnv : public Env<InvertedPendulumEnvSpec>,
-                            public MujocoEnv {
  protected:
+  using Base::Allocate;
+  using Base::gen_;
+
+  ObsLayout obs_layout_;
   mjtNum healthy_reward_, healthy_z_min_, healthy_z_max_;
   std::uniform_real_distribution<> dist_;
 
  public:
-  InvertedPendulumEnv(const Spec& spec, int env_id)
-      : Env<InvertedPendulumEnvSpec>(spec, env_id),
+  InvertedPendulumEnvT(const Spec& spec, int env_id)
+      : Base(spec, env_id),
         MujocoEnv(spec.config["base_path"_] +
                       "/mujoco/assets_gym/inverted_pendulum.xml",
                   spec.config["frame_skip"_], spec.config["post_constraint"_],
-                  spec.config["max_episode_steps"_]),
+                  spec.config["max_episode_steps"_],
+                  spec.config["mjb_cache_dir"_],
+                  spec.config["model_randomization"_]),
         healthy_reward_(spec.config["healthy_reward"_]),
         healthy_z_min_(spec.config["healthy_z_min"_]),
         healthy_z_max_(spec.config["healthy_z_max"_]),
         dist_(-spec.config["reset_noise_scale"_],
-              spec.config["reset_noise_scale"_]) {}
+              spec.config["reset_noise_scale"_]) {
+    obs_layout_.Add(&mjData::qpos, 0, model_->nq)
+        .Add(&mjData::qvel, 0, model_->nv);
+  }
 
   void MujocoResetModel() override {
     for (int i = 0; i < model_->nq; ++i) {
@@ -92,7 +110,7 @@ class InvertedPendulumEnv : public Env<InvertedPendulumEnvSpec>,
   void Reset() override {
     done_ = false;
     elapsed_step_ = 0;
-    MujocoReset();
+    MujocoReset(&gen_);
     WriteState(0.0);
   }
 
@@ -106,6 +124,10 @@ class InvertedPendulumEnv : public Env<InvertedPendulumEnvSpec>,
     WriteState(1.0);
   }
 
+  void Serialize(ByteWriter* writer) override { MujocoSerialize(writer); }
+
+  void Deserialize(ByteReader* reader) override { MujocoDeserialize(reader); }
+
  private:
   bool IsHealthy() {
     if (data_->qpos[1] < healthy_z_min_ || data_->qpos[1] > healthy_z_max_) {
@@ -128,13 +150,7 @@ class InvertedPendulumEnv : public Env<InvertedPendulumEnvSpec>,
     State state = Allocate();
     state["reward"_] = reward;
     // obs
-    mjtNum* obs = static_cast<mjtNum*>(state["obs"_].Data());
-    for (int i = 0; i < model_->nq; ++i) {
-      *(obs++) = data_->qpos[i];
-    }
-    for (int i = 0; i < model_->nv; ++i) {
-      *(obs++) = data_->qvel[i];
-    }
+    obs_layout_.Write(data_, static_cast<ObsType*>(state["obs"_].Data()));
     // info
 #ifdef ENVPOOL_TEST
     state["info:qpos0"_].Assign(qpos0_, model_->nq);
@@ -143,8 +159,16 @@ class InvertedPendulumEnv : public Env<InvertedPendulumEnvSpec>,
   }
 };
 
+using InvertedPendulumEnv = InvertedPendulumEnvT<float>;
+using InvertedPendulumEnvSpec = InvertedPendulumEnv::Spec;
 using InvertedPendulumEnvPool = AsyncEnvPool<InvertedPendulumEnv>;
 
+using InvertedPendulumFloat64Env = InvertedPendulumEnvT<mjtNum>;
+using InvertedPendulumFloat64EnvSpec =
+    InvertedPendulumFloat64Env::Spec;
+using InvertedPendulumFloat64EnvPool =
+    AsyncEnvPool<InvertedPendulumFloat64Env>;
+
 }  // namespace mujoco_gym
 
 #endif  // ENVPOOL_MUJOCO_GYM_INVERTED_PENDULUM_H_
@@ -20,16 +20,130 @@
 #include <mjxmacro.h>
 #include <mujoco.h>
 
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <stdexcept>
 #include <string>
+#include <type_traits>
+#include <vector>
+
+#include "envpool/core/serialization.h"
+#include "envpool/mujoco/model_cache.h"
+#include "envpool/mujoco/model_randomizer.h"
 
 namespace mujoco_gym {
 
+/**
+ * Returns the model of `xml`, compiling it on first use (see
+ * `mujoco_common::LoadModel`, which also saves it under `cache_dir` unless
+ * empty). Gym tasks never write to their model, so every env of the process
+ * built from the same file shares one read-only copy. While it is held, the
+ * file and its assets are not read again, so edits made meanwhile only reach
+ * later processes.
+ */
+inline std::shared_ptr<const mjModel> LoadSharedModel(
+    const std::string& xml, const std::string& cache_dir) {
+  // by path first, so that only the first env of a file reads it and its
+  // assets to build the key
+  static std::mutex mutex;
+  static std::map<std::string, std::weak_ptr<const mjModel>> cache;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  auto model = cache[xml].lock();
+  if (model == nullptr) {
+    model = mujoco_common::LoadModel(
+        mujoco_common::XmlFileKey(xml), cache_dir, [&](char* error, int size) {
+          return mj_loadXML(xml.c_str(), nullptr, error, size);
+        });
+    cache[xml] = model;
+  }
+  return model;
+}
+
+/**
+ * How an observation is gathered from mjData: an ordered list of runs
+ * [begin, end) of mjData arrays, each copied as is or clipped to
+ * [low, high]. A task lists its runs once in its constructor, where the model
+ * sizes are known; `Write` then fills the `obs` slice with one straight
+ * convert loop per run, which the compiler vectorizes, instead of indexing
+ * mjData element by element at every step.
+ */
+class ObsLayout {
+ protected:
+  struct Run {
+    mjtNum* mjData::*field;
+    int begin, end;
+    bool clip;
+    mjtNum low, high;
+  };
+  std::vector<Run> runs_;
+  int size_{0};
+
+ public:
+  ObsLayout& Add(mjtNum* mjData::*field, int begin, int end) {
+    runs_.push_back(Run{field, begin, end, false, 0, 0});
+    size_ += end - begin;
+    return *this;
+  }
+
+  ObsLayout& AddClipped(mjtNum* mjData::*field, int begin, int end,
+                        mjtNum low, mjtNum high) {
+    runs_.push_back(Run{field, begin, end, true, low, high});
+    size_ += end - begin;
+    return *this;
+  }
+
+  [[nodiscard]] int Size() const { return size_; }
+
+  // Writes every run to `obs` and returns the end of the written range, for
+  // tasks that append computed entries after the copied ones.
+  template <typename T>
+  T* Write(const mjData* data, T* obs) const {
+    for (const Run& run : runs_) {
+      const mjtNum* src = data->*run.field + run.begin;
+      const int n = run.end - run.begin;
+      if (run.clip) {
+        const mjtNum low = run.low;
+        const mjtNum high = run.high;
+        for (int i = 0; i < n; ++i) {
+          obs[i] = static_cast<T>(std::min(std::max(src[i], low), high));
+        }
+      } else if constexpr (std::is_same_v<T, mjtNum>) {
+        std::memcpy(obs, src, sizeof(mjtNum) * n);
+      } else {
+        for (int i = 0; i < n; ++i) {
+          obs[i] = static_cast<T>(src[i]);
+        }
+      }
+      obs += n;
+    }
+    return obs;
+  }
+};
+
 class MujocoEnv {
  private:
-  std::array<char, 1000> error_;
+  std::shared_ptr<const mjModel> shared_model_;
+  mujoco_common::ModelRandomizer randomizer_;
+  // With randomization, a copy of the shared model struct whose randomized
+  // arrays belong to this env; all other arrays stay shared.
+  std::unique_ptr<mjModel> overlay_model_;
+
+  const mjModel* MakeOverlayModel() {
+    if (randomizer_.Empty()) {
+      return shared_model_.get();
+    }
+    overlay_model_ = std::make_unique<mjModel>(*shared_model_);
+    randomizer_.Redirect(overlay_model_.get());
+    return overlay_model_.get();
+  }
 
  protected:
-  mjModel* model_;
+  const mjModel* model_;
   mjData* data_;
   mjtNum *init_qpos_, *init_qvel_;
 #ifdef ENVPOOL_TEST
@@ -41,9 +155,14 @@ class MujocoEnv {
   bool done_{true};
 
  public:
+  // `randomization` is a `mujoco_common::ModelRandomizer` spec, applied at
+  // every reset.
   MujocoEnv(const std::string& xml, int frame_skip, bool post_constraint,
-            int max_episode_steps)
-      : model_(mj_loadXML(xml.c_str(), nullptr, error_.begin(), 1000)),
+            int max_episode_steps, const std::string& cache_dir,
+            const std::string& randomization)
+      : shared_model_(LoadSharedModel(xml, cache_dir)),
+        randomizer_(shared_model_.get(), randomization),
+        model_(MakeOverlayModel()),
         data_(mj_makeData(model_)),
         init_qpos_(new mjtNum[model_->nq]),
         init_qvel_(new mjtNum[model_->nv]),
@@ -61,7 +180,6 @@ class MujocoEnv {
 
   ~MujocoEnv() {
     mj_deleteData(data_);
-    mj_deleteModel(model_);
     delete[] init_qpos_;
     delete[] init_qvel_;
 #ifdef ENVPOOL_TEST
@@ -70,7 +188,10 @@ class MujocoEnv {
 #endif
   }
 
-  void MujocoReset() {
+  void MujocoReset(std::mt19937* gen) {
+    if (overlay_model_ != nullptr) {
+      randomizer_.Randomize(overlay_model_.get(), gen);
+    }
     mj_resetData(model_, data_);
     MujocoResetModel();
     mj_forward(model_, data_);
@@ -91,6 +212,34 @@ class MujocoEnv {
       mj_rnePostConstraint(model_, data_);
     }
   }
+
+  // Only the integration state of mjData and the randomized model values are
+  // stored, everything else is recomputed by mj_forward on restore.
+  void MujocoSerialize(ByteWriter* writer) {
+    writer->Write(elapsed_step_);
+    writer->Write(done_);
+    writer->Write(data_->time);
+    writer->WriteArray(data_->qpos, model_->nq);
+    writer->WriteArray(data_->qvel, model_->nv);
+    writer->WriteArray(data_->act, model_->na);
+    writer->WriteArray(data_->qacc_warmstart, model_->nv);
+    randomizer_.Serialize(model_, writer);
+  }
+
+  void MujocoDeserialize(ByteReader* reader) {
+    reader->Read(&elapsed_step_);
+    reader->Read(&done_);
+    reader->Read(&data_->time);
+    reader->ReadArray(data_->qpos, model_->nq);
+    reader->ReadArray(data_->qvel, model_->nv);
+    reader->ReadArray(data_->act, model_->na);
+    reader->ReadArray(data_->qacc_warmstart, model_->nv);
+    randomizer_.Deserialize(overlay_model_.get(), reader);
+    mj_forward(model_, data_);
+    if (post_constraint_) {
+      mj_rnePostConstraint(model_, data_);
+    }
+  }
 };
 
 }  // namespace mujoco_gym
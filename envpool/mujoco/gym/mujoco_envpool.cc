@@ -62,6 +62,47 @@ using GymSwimmerEnvPool = PyEnvPool<mujoco_gym::SwimmerEnvPool>;
 using GymWalker2dEnvSpec = PyEnvSpec<mujoco_gym::Walker2dEnvSpec>;
 using GymWalker2dEnvPool = PyEnvPool<mujoco_gym::Walker2dEnvPool>;
 
+using GymAntFloat64EnvSpec = PyEnvSpec<mujoco_gym::AntFloat64EnvSpec>;
+using GymAntFloat64EnvPool = PyEnvPool<mujoco_gym::AntFloat64EnvPool>;
+
+using GymHalfCheetahFloat64EnvSpec =
+    PyEnvSpec<mujoco_gym::HalfCheetahFloat64EnvSpec>;
+using GymHalfCheetahFloat64EnvPool =
+    PyEnvPool<mujoco_gym::HalfCheetahFloat64EnvPool>;
+
+using GymHopperFloat64EnvSpec = PyEnvSpec<mujoco_gym::HopperFloat64EnvSpec>;
+using GymHopperFloat64EnvPool = PyEnvPool<mujoco_gym::HopperFloat64EnvPool>;
+
+using GymHumanoidFloat64EnvSpec = PyEnvSpec<mujoco_gym::HumanoidFloat64EnvSpec>;
+using GymHumanoidFloat64EnvPool = PyEnvPool<mujoco_gym::HumanoidFloat64EnvPool>;
+
+using GymHumanoidStandupFloat64EnvSpec =
+    PyEnvSpec<mujoco_gym::HumanoidStandupFloat64EnvSpec>;
+using GymHumanoidStandupFloat64EnvPool =
+    PyEnvPool<mujoco_gym::HumanoidStandupFloat64EnvPool>;
+
+using GymInvertedDoublePendulumFloat64EnvSpec =
+    PyEnvSpec<mujoco_gym::InvertedDoublePendulumFloat64EnvSpec>;
+using GymInvertedDoublePendulumFloat64EnvPool =
+    PyEnvPool<mujoco_gym::InvertedDoublePendulumFloat64EnvPool>;
+
+using GymInvertedPendulumFloat64EnvSpec =
+    PyEnvSpec<mujoco_gym::InvertedPendulumFloat64EnvSpec>;
+using GymInvertedPendulumFloat64EnvPool =
+    PyEnvPool<mujoco_gym::InvertedPendulumFloat64EnvPool>;
+
+using GymPusherFloat64EnvSpec = PyEnvSpec<mujoco_gym::PusherFloat64EnvSpec>;
+using GymPusherFloat64EnvPool = PyEnvPool<mujoco_gym::PusherFloat64EnvPool>;
+
+using GymReacherFloat64EnvSpec = PyEnvSpec<mujoco_gym::ReacherFloat64EnvSpec>;
+using GymReacherFloat64EnvPool = PyEnvPool<mujoco_gym::ReacherFloat64EnvPool>;
+
+using GymSwimmerFloat64EnvSpec = PyEnvSpec<mujoco_gym::SwimmerFloat64EnvSpec>;
+using GymSwimmerFloat64EnvPool = PyEnvPool<mujoco_gym::SwimmerFloat64EnvPool>;
+
+using GymWalker2dFloat64EnvSpec = PyEnvSpec<mujoco_gym::Walker2dFloat64EnvSpec>;
+using GymWalker2dFloat64EnvPool = PyEnvPool<mujoco_gym::Walker2dFloat64EnvPool>;
+
 PYBIND11_MODULE(mujoco_gym_envpool, m) {
   REGISTER(m, GymAntEnvSpec, GymAntEnvPool)
   REGISTER(m, GymHalfCheetahEnvSpec, GymHalfCheetahEnvPool)
@@ -75,4 +116,18 @@ PYBIND11_MODULE(mujoco_gym_envpool, m) {
   REGISTER(m, GymReacherEnvSpec, GymReacherEnvPool)
   REGISTER(m, GymSwimmerEnvSpec, GymSwimmerEnvPool)
   REGISTER(m, GymWalker2dEnvSpec, GymWalker2dEnvPool)
+  REGISTER(m, GymAntFloat64EnvSpec, GymAntFloat64EnvPool)
+  REGISTER(m, GymHalfCheetahFloat64EnvSpec, GymHalfCheetahFloat64EnvPool)
+  REGISTER(m, GymHopperFloat64EnvSpec, GymHopperFloat64EnvPool)
+  REGISTER(m, GymHumanoidFloat64EnvSpec, GymHumanoidFloat64EnvPool)
+  REGISTER(m, GymHumanoidStandupFloat64EnvSpec,
+           GymHumanoidStandupFloat64EnvPool)
+  REGISTER(m, GymInvertedDoublePendulumFloat64EnvSpec,
+           GymInvertedDoublePendulumFloat64EnvPool)
+  REGISTER(m, GymInvertedPendulumFloat64EnvSpec,
+           GymInvertedPendulumFloat64EnvPool)
+  REGISTER(m, GymPusherFloat64EnvSpec, GymPusherFloat64EnvPool)
+  REGISTER(m, GymReacherFloat64EnvSpec, GymReacherFloat64EnvPool)
+  REGISTER(m, GymSwimmerFloat64EnvSpec, GymSwimmerFloat64EnvPool)
+  REGISTER(m, GymWalker2dFloat64EnvSpec, GymWalker2dFloat64EnvPool)
 }
@@ -17,6 +17,7 @@ import numpy as np
 from absl.testing import absltest
 
 import envpool.mujoco.gym.registration  # noqa: F401
+from envpool.python.testing import check_snapshot_restore
 from envpool.registration import make_gym
 
 
@@ -42,6 +43,18 @@ class _MujocoGymDeterministicTest(absltest.TestCase):
       self.assertTrue(np.all(obs0 <= obs_max), obs0)
       self.assertTrue(np.all(obs2 <= obs_max), obs2)
 
+  def test_snapshot_restore(self) -> None:
+    num_envs = 4
+    env = make_gym("HalfCheetah-v4", num_envs=num_envs, seed=0)
+    env.reset()
+    act_space = env.action_space
+    actions = [
+      np.array([act_space.sample() for _ in range(num_envs)])
+      for _ in range(10)
+    ]
+    env.step(actions[0])
+    check_snapshot_restore(env, actions)
+
   def test_ant(self) -> None:
     self.check("Ant-v4")
 
@@ -15,7 +15,12 @@
 #include <glog/logging.h>
 #include <gtest/gtest.h>
 
+#include <cstring>
+#include <filesystem>
+#include <fstream>
 #include <random>
+#include <stdexcept>
+#include <string>
 #include <vector>
 
 #include "envpool/mujoco/gym/half_cheetah.h"
@@ -51,3 +56,114 @@ TEST(MjcEnvPoolTest, CheckAction) {
   envpool.Send(action);
   state_vec = envpool.Recv();
 }
+
+TEST(MjcEnvPoolTest, MjbCache) {
+  std::filesystem::path cache_dir =
+      std::filesystem::temp_directory_path() / "envpool_mjb_cache_test";
+  std::filesystem::remove_all(cache_dir);
+  auto config = mujoco_gym::HalfCheetahEnvSpec::kDefaultConfig;
+  int num_envs = 4;
+  config["num_envs"_] = num_envs;
+  Array all_env_ids(Spec<int>({num_envs}));
+  for (int i = 0; i < num_envs; ++i) {
+    all_env_ids[i] = i;
+  }
+  auto reset_obs = [&](const std::string& dir) {
+    config["mjb_cache_dir"_] = dir;
+    mujoco_gym::HalfCheetahEnvSpec spec(config);
+    mujoco_gym::HalfCheetahEnvPool envpool(spec);
+    envpool.Reset(all_env_ids);
+    return envpool.Recv();
+  };
+  auto compiled = reset_obs("");
+  // the first pool compiles and saves the model, the second one loads it
+  reset_obs(cache_dir.string());
+  int num_files = 0;
+  for (const auto& entry : std::filesystem::directory_iterator(cache_dir)) {
+    EXPECT_EQ(entry.path().extension(), ".mjb");
+    ++num_files;
+  }
+  EXPECT_EQ(num_files, 1);
+  auto loaded = reset_obs(cache_dir.string());
+  ASSERT_EQ(compiled.size(), loaded.size());
+  for (std::size_t k = 0; k < compiled.size(); ++k) {
+    EXPECT_EQ(std::memcmp(compiled[k].Data(), loaded[k].Data(),
+                          compiled[k].size * compiled[k].element_size),
+              0);
+  }
+  std::filesystem::remove_all(cache_dir);
+}
+
+TEST(MjcEnvPoolTest, MjbCacheKeyCoversAssets) {
+  std::filesystem::path dir =
+      std::filesystem::temp_directory_path() / "envpool_mjb_cache_key_test";
+  std::filesystem::remove_all(dir);
+  std::filesystem::create_directories(dir / "meshes");
+  auto write = [&](const std::string& name, const std::string& content) {
+    std::ofstream(dir / name) << content;
+  };
+  write("model.xml",
+        "<mujoco>\n"
+        "  <compiler meshdir=\"meshes\"/>\n"
+        "  <include file=\"part.xml\"/>\n"
+        "</mujoco>\n");
+  write("part.xml", "<mujocoinclude><asset><mesh file='box.stl'/></asset>"
+                    "</mujocoinclude>\n");
+  write("meshes/box.stl", "solid box");
+  write("unused.stl", "solid unused");
+  const std::string xml = (dir / "model.xml").string();
+  auto key = mujoco_common::XmlFileKey(xml);
+  EXPECT_EQ(key, mujoco_common::XmlFileKey(xml));
+  write("unused.stl", "solid unused, edited");
+  EXPECT_EQ(key, mujoco_common::XmlFileKey(xml));
+  write("meshes/box.stl", "solid box, edited");
+  auto mesh_key = mujoco_common::XmlFileKey(xml);
+  EXPECT_NE(key, mesh_key);
+  write("part.xml", "<mujocoinclude><asset><mesh file='box.stl'/></asset>"
+                    "</mujocoinclude>\n\n");
+  EXPECT_NE(mesh_key, mujoco_common::XmlFileKey(xml));
+  std::filesystem::remove_all(dir);
+}
+
+TEST(MjcEnvPoolTest, ModelRandomization) {
+  auto config = mujoco_gym::HalfCheetahEnvSpec::kDefaultConfig;
+  int num_envs = 4;
+  config["num_envs"_] = num_envs;
+  Array all_env_ids(Spec<int>({num_envs}));
+  for (int i = 0; i < num_envs; ++i) {
+    all_env_ids[i] = i;
+  }
+  auto final_obs = [&](const std::string& randomization) {
+    config["model_randomization"_] = randomization;
+    mujoco_gym::HalfCheetahEnvSpec spec(config);
+    mujoco_gym::HalfCheetahEnvPool envpool(spec);
+    envpool.Reset(all_env_ids);
+    auto states = envpool.Recv();
+    for (int step = 0; step < 10; ++step) {
+      std::vector<Array> raw_action({Array(Spec<int>({num_envs})),
+                                     Array(Spec<int>({num_envs})),
+                                     Array(Spec<double>({num_envs, 6}))});
+      MjcAction action(raw_action);
+      for (int i = 0; i < num_envs; ++i) {
+        action["env_id"_][i] = i;
+        action["players.env_id"_][i] = i;
+        for (int j = 0; j < 6; ++j) {
+          action["action"_][i][j] = 0.5;
+        }
+      }
+      envpool.Send(action);
+      states = envpool.Recv();
+    }
+    MjcState state(states);
+    const Array& obs = state["obs"_];
+    auto* data = static_cast<const float*>(obs.Data());
+    return std::vector<float>(data, data + obs.size);
+  };
+  auto nominal = final_obs("");
+  auto randomized = final_obs("body_mass scale 0.5 1.5");
+  // draws come from the env's seeded generator
+  EXPECT_EQ(randomized, final_obs("body_mass scale 0.5 1.5"));
+  EXPECT_NE(randomized, nominal);
+  EXPECT_THROW(final_obs("body_mass gaussian 0 1"), std::runtime_error);
+  EXPECT_THROW(final_obs("no_such_field uniform 0 1"), std::runtime_error);
+}
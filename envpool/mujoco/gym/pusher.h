@@ -28,6 +28,7 @@
 
 namespace mujoco_gym {
 
+template <typename ObsType>
 class PusherEnvFns {
  public:
   static decltype(auto) DefaultConfig() {
@@ -37,12 +38,14 @@ class PusherEnvFns {
         "dist_cost_weight"_.Bind(1.0), "near_cost_weight"_.Bind(0.5),
         "reset_qvel_scale"_.Bind(0.005), "cylinder_x_min"_.Bind(-0.3),
         "cylinder_x_max"_.Bind(0.0), "cylinder_y_min"_.Bind(-0.2),
-        "cylinder_y_max"_.Bind(0.2), "cylinder_dist_min"_.Bind(0.17));
+        "cylinder_y_max"_.Bind(0.2), "cylinder_dist_min"_.Bind(0.17),
+        "mjb_cache_dir"_.Bind(std::string("")),
+        "model_randomization"_.Bind(std::string("")));
   }
   template <typename Config>
   static decltype(auto) StateSpec(const Config& conf) {
-    mjtNum inf = std::numeric_limits<mjtNum>::infinity();
-    return MakeDict("obs"_.Bind(Spec<mjtNum>({23}, {-inf, inf})),
+    ObsType inf = std::numeric_limits<ObsType>::infinity();
+    return MakeDict("obs"_.Bind(Spec<ObsType>({23}, {-inf, inf})),
 #ifdef ENVPOOL_TEST
                     "info:qpos0"_.Bind(Spec<mjtNum>({11})),
                     "info:qvel0"_.Bind(Spec<mjtNum>({11})),
@@ -56,21 +59,33 @@ class PusherEnvFns {
   }
 };
 
-using PusherEnvSpec = EnvSpec<PusherEnvFns>;
+template <typename ObsType>
+class PusherEnvT : public Env<EnvSpec<PusherEnvFns<ObsType>>>,
+                   public MujocoEnv {
+ public:
+  using Base = Env<EnvSpec<PusherEnvFns<ObsType>>>;
+  using typename Base::Action;
+  using typename Base::Spec;
+  using typename Base::State;
 
-class PusherEnv : public Env<PusherEnvSpec>, public MujocoEnv {
  protected:
+  using Base::Allocate;
+  using Base::gen_;
+
+  ObsLayout obs_layout_;
   int id_tips_arm_, id_object_, id_goal_;
   mjtNum ctrl_cost_weight_, dist_cost_weight_, near_cost_weight_;
   mjtNum cylinder_dist_min_;
   std::uniform_real_distribution<> dist_qpos_x_, dist_qpos_y_, dist_qvel_;
 
  public:
-  PusherEnv(const Spec& spec, int env_id)
-      : Env<PusherEnvSpec>(spec, env_id),
+  PusherEnvT(const Spec& spec, int env_id)
+      : Base(spec, env_id),
         MujocoEnv(spec.config["base_path"_] + "/mujoco/assets_gym/pusher.xml",
                   spec.config["frame_skip"_], spec.config["post_constraint"_],
-                  spec.config["max_episode_steps"_]),
+                  spec.config["max_episode_steps"_],
+                  spec.config["mjb_cache_dir"_],
+                  spec.config["model_randomization"_]),
         id_tips_arm_(mj_name2id(model_, mjOBJ_XBODY, "tips_arm")),
         id_object_(mj_name2id(model_, mjOBJ_XBODY, "object")),
         id_goal_(mj_name2id(model_, mjOBJ_XBODY, "goal")),
@@ -83,7 +98,13 @@ class PusherEnv : public Env<PusherEnvSpec>, public MujocoEnv {
         dist_qpos_y_(spec.config["cylinder_y_min"_],
                      spec.config["cylinder_y_max"_]),
         dist_qvel_(-spec.config["reset_qvel_scale"_],
-                   spec.config["reset_qvel_scale"_]) {}
+                   spec.config["reset_qvel_scale"_]) {
+    obs_layout_.Add(&mjData::qpos, 0, 7)
+        .Add(&mjData::qvel, 0, 7)
+        .Add(&mjData::xpos, id_tips_arm_ * 3, id_tips_arm_ * 3 + 3)
+        .Add(&mjData::xpos, id_object_ * 3, id_object_ * 3 + 3)
+        .Add(&mjData::xpos, id_goal_ * 3, id_goal_ * 3 + 3);
+  }
 
   void MujocoResetModel() override {
     for (int i = 0; i < model_->nq - 4; ++i) {
@@ -115,7 +136,7 @@ class PusherEnv : public Env<PusherEnvSpec>, public MujocoEnv {
   void Reset() override {
     done_ = false;
     elapsed_step_ = 0;
-    MujocoReset();
+    MujocoReset(&gen_);
     WriteState(0.0, 0.0, 0.0);
   }
 
@@ -140,6 +161,10 @@ class PusherEnv : public Env<PusherEnvSpec>, public MujocoEnv {
     WriteState(reward, ctrl_cost, dist_cost);
   }
 
+  void Serialize(ByteWriter* writer) override { MujocoSerialize(writer); }
+
+  void Deserialize(ByteReader* reader) override { MujocoDeserialize(reader); }
+
  private:
   mjtNum GetDist(int off0, int off1) {
     mjtNum x = data_->xpos[off0 * 3 + 0] - data_->xpos[off1 * 3 + 0];
@@ -152,22 +177,7 @@ class PusherEnv : public Env<PusherEnvSpec>, public MujocoEnv {
     State state = Allocate();
     state["reward"_] = reward;
     // obs
-    mjtNum* obs = static_cast<mjtNum*>(state["obs"_].Data());
-    for (int i = 0; i < 7; ++i) {
-      *(obs++) = data_->qpos[i];
-    }
-    for (int i = 0; i < 7; ++i) {
-      *(obs++) = data_->qvel[i];
-    }
-    for (int i = 0; i < 3; ++i) {
-      *(obs++) = data_->xpos[id_tips_arm_ * 3 + i];
-    }
-    for (int i = 0; i < 3; ++i) {
-      *(obs++) = data_->xpos[id_object_ * 3 + i];
-    }
-    for (int i = 0; i < 3; ++i) {
-      *(obs++) = data_->xpos[id_goal_ * 3 + i];
-    }
+    obs_layout_.Write(data_, static_cast<ObsType*>(state["obs"_].Data()));
     // info
     state["info:reward_dist"_] = -dist_cost;
     state["info:reward_ctrl"_] = -ctrl_cost;
@@ -178,8 +188,14 @@ class PusherEnv : public Env<PusherEnvSpec>, public MujocoEnv {
   }
 };
 
+using PusherEnv = PusherEnvT<float>;
+using PusherEnvSpec = PusherEnv::Spec;
 using PusherEnvPool = AsyncEnvPool<PusherEnv>;
 
+using PusherFloat64Env = PusherEnvT<mjtNum>;
+using PusherFloat64EnvSpec = PusherFloat64Env::Spec;
+using PusherFloat64EnvPool = AsyncEnvPool<PusherFloat64Env>;
+
 }  // namespace mujoco_gym
 
 #endif  // ENVPOOL_MUJOCO_GYM_PUSHER_H_
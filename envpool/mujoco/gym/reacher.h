@@ -28,6 +28,7 @@
 
 namespace mujoco_gym {
 
+template <typename ObsType>
 class ReacherEnvFns {
  public:
   static decltype(auto) DefaultConfig() {
@@ -35,12 +36,14 @@ class ReacherEnvFns {
         "reward_threshold"_.Bind(-3.75), "frame_skip"_.Bind(2),
         "post_constraint"_.Bind(true), "ctrl_cost_weight"_.Bind(1.0),
         "dist_cost_weight"_.Bind(1.0), "reset_qpos_scale"_.Bind(0.1),
-        "reset_qvel_scale"_.Bind(0.005), "reset_goal_scale"_.Bind(0.2));
+        "reset_qvel_scale"_.Bind(0.005), "reset_goal_scale"_.Bind(0.2),
+        "mjb_cache_dir"_.Bind(std::string("")),
+        "model_randomization"_.Bind(std::string("")));
   }
   template <typename Config>
   static decltype(auto) StateSpec(const Config& conf) {
-    mjtNum inf = std::numeric_limits<mjtNum>::infinity();
-    return MakeDict("obs"_.Bind(Spec<mjtNum>({11}, {-inf, inf})),
+    ObsType inf = std::numeric_limits<ObsType>::infinity();
+    return MakeDict("obs"_.Bind(Spec<ObsType>({11}, {-inf, inf})),
 #ifdef ENVPOOL_TEST
                     "info:qpos0"_.Bind(Spec<mjtNum>({4})),
                     "info:qvel0"_.Bind(Spec<mjtNum>({4})),
@@ -54,20 +57,32 @@ class ReacherEnvFns {
   }
 };
 
-using ReacherEnvSpec = EnvSpec<ReacherEnvFns>;
+template <typename ObsType>
+class ReacherEnvT : public Env<EnvSpec<ReacherEnvFns<ObsType>>>,
+                    public MujocoEnv {
+ public:
+  using Base = Env<EnvSpec<ReacherEnvFns<ObsType>>>;
+  using typename Base::Action;
+  using typename Base::Spec;
+  using typename Base::State;
 
-class ReacherEnv : public Env<ReacherEnvSpec>, public MujocoEnv {
  protected:
+  using Base::Allocate;
+  using Base::gen_;
+
+  ObsLayout obs_layout_;
   int id_fingertip_, id_target_;
   mjtNum ctrl_cost_weight_, dist_cost_weight_, reset_goal_scale_;
   std::uniform_real_distribution<> dist_qpos_, dist_qvel_, dist_goal_;
 
  public:
-  ReacherEnv(const Spec& spec, int env_id)
-      : Env<ReacherEnvSpec>(spec, env_id),
+  ReacherEnvT(const Spec& spec, int env_id)
+      : Base(spec, env_id),
         MujocoEnv(spec.config["base_path"_] + "/mujoco/assets_gym/reacher.xml",
                   spec.config["frame_skip"_], spec.config["post_constraint"_],
-                  spec.config["max_episode_steps"_]),
+                  spec.config["max_episode_steps"_],
+                  spec.config["mjb_cache_dir"_],
+                  spec.config["model_randomization"_]),
         id_fingertip_(mj_name2id(model_, mjOBJ_XBODY, "fingertip")),
         id_target_(mj_name2id(model_, mjOBJ_XBODY, "target")),
         ctrl_cost_weight_(spec.config["ctrl_cost_weight"_]),
@@ -78,7 +93,9 @@ class ReacherEnv : public Env<ReacherEnvSpec>, public MujocoEnv {
         dist_qvel_(-spec.config["reset_qvel_scale"_],
                    spec.config["reset_qvel_scale"_]),
         dist_goal_(-spec.config["reset_goal_scale"_],
-                   spec.config["reset_goal_scale"_]) {}
+                   spec.config["reset_goal_scale"_]) {
+    obs_layout_.Add(&mjData::qpos, 2, model_->nq).Add(&mjData::qvel, 0, 2);
+  }
 
   void MujocoResetModel() override {
     for (int i = 0; i < model_->nq - 2; ++i) {
@@ -108,7 +125,7 @@ class ReacherEnv : public Env<ReacherEnvSpec>, public MujocoEnv {
   void Reset() override {
     done_ = false;
     elapsed_step_ = 0;
-    MujocoReset();
+    MujocoReset(&gen_);
     WriteState(0.0, 0.0, 0.0);
   }
 
@@ -134,6 +151,10 @@ class ReacherEnv : public Env<ReacherEnvSpec>, public MujocoEnv {
     WriteState(reward, ctrl_cost, dist_cost);
   }
 
+  void Serialize(ByteWriter* writer) override { MujocoSerialize(writer); }
+
+  void Deserialize(ByteReader* reader) override { MujocoDeserialize(reader); }
+
  private:
   std::array<mjtNum, 3> GetDist() {
     // self.get_body_com("fingertip") - self.get_body_com("target")
@@ -147,21 +168,16 @@ class ReacherEnv : public Env<ReacherEnvSpec>, public MujocoEnv {
     State state = Allocate();
     state["reward"_] = reward;
     // obs
-    mjtNum* obs = static_cast<mjtNum*>(state["obs"_].Data());
-    *(obs++) = std::cos(data_->qpos[0]);
-    *(obs++) = std::cos(data_->qpos[1]);
-    *(obs++) = std::sin(data_->qpos[0]);
-    *(obs++) = std::sin(data_->qpos[1]);
-    for (int i = 2; i < model_->nq; ++i) {
-      *(obs++) = data_->qpos[i];
-    }
-    for (int i = 0; i < 2; ++i) {
-      *(obs++) = data_->qvel[i];
-    }
+    auto* obs = static_cast<ObsType*>(state["obs"_].Data());
+    *(obs++) = static_cast<ObsType>(std::cos(data_->qpos[0]));
+    *(obs++) = static_cast<ObsType>(std::cos(data_->qpos[1]));
+    *(obs++) = static_cast<ObsType>(std::sin(data_->qpos[0]));
+    *(obs++) = static_cast<ObsType>(std::sin(data_->qpos[1]));
+    obs = obs_layout_.Write(data_, obs);
     const auto& dist = GetDist();
-    *(obs++) = dist[0];
-    *(obs++) = dist[1];
-    *(obs++) = dist[2];
+    *(obs++) = static_cast<ObsType>(dist[0]);
+    *(obs++) = static_cast<ObsType>(dist[1]);
+    *(obs++) = static_cast<ObsType>(dist[2]);
     // info
     state["info:reward_dist"_] = -dist_cost;
     state["info:reward_ctrl"_] = -ctrl_cost;
@@ -172,8 +188,14 @@ class ReacherEnv : public Env<ReacherEnvSpec>, public MujocoEnv {
   }
 };
 
+using ReacherEnv = ReacherEnvT<float>;
+using ReacherEnvSpec = ReacherEnv::Spec;
 using ReacherEnvPool = AsyncEnvPool<ReacherEnv>;
 
+using ReacherFloat64Env = ReacherEnvT<mjtNum>;
+using ReacherFloat64EnvSpec = ReacherFloat64Env::Spec;
+using ReacherFloat64EnvPool = AsyncEnvPool<ReacherFloat64Env>;
+
 }  // namespace mujoco_gym
 
 #endif  // ENVPOOL_MUJOCO_GYM_REACHER_H_
@@ -55,3 +55,14 @@ for task, version, post_constraint, max_episode_steps in gym_mujoco_envs:
     max_episode_steps=max_episode_steps,
     **extra_args,
   )
+  register(
+    task_id=f"{task}Float64-{version}",
+    import_path="envpool.mujoco.gym",
+    spec_cls=f"Gym{task}Float64EnvSpec",
+    dm_cls=f"Gym{task}Float64DMEnvPool",
+    gym_cls=f"Gym{task}Float64GymEnvPool",
+    gymnasium_cls=f"Gym{task}Float64GymnasiumEnvPool",
+    post_constraint=post_constraint,
+    max_episode_steps=max_episode_steps,
+    **extra_args,
+  )
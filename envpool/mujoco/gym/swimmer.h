@@ -28,6 +28,7 @@
 
 namespace mujoco_gym {
 
+template <typename ObsType>
 class SwimmerEnvFns {
  public:
   static decltype(auto) DefaultConfig() {
@@ -36,13 +37,15 @@ class SwimmerEnvFns {
                     "exclude_current_positions_from_observation"_.Bind(true),
                     "forward_reward_weight"_.Bind(1.0),
                     "ctrl_cost_weight"_.Bind(1e-4),
-                    "reset_noise_scale"_.Bind(0.1));
+                    "reset_noise_scale"_.Bind(0.1),
+                    "mjb_cache_dir"_.Bind(std::string("")),
+                    "model_randomization"_.Bind(std::string("")));
   }
   template <typename Config>
   static decltype(auto) StateSpec(const Config& conf) {
-    mjtNum inf = std::numeric_limits<mjtNum>::infinity();
+    ObsType inf = std::numeric_limits<ObsType>::infinity();
     bool no_pos = conf["exclude_current_positions_from_observation"_];
-    return MakeDict("obs"_.Bind(Spec<mjtNum>({no_pos ? 8 : 10}, {-inf, inf})),
+    return MakeDict("obs"_.Bind(Spec<ObsType>({no_pos ? 8 : 10}, {-inf, inf})),
 #ifdef ENVPOOL_TEST
                     "info:qpos0"_.Bind(Spec<mjtNum>({5})),
                     "info:qvel0"_.Bind(Spec<mjtNum>({5})),
@@ -61,25 +64,40 @@ class SwimmerEnvFns {
   }
 };
 
-using SwimmerEnvSpec = EnvSpec<SwimmerEnvFns>;
+template <typename ObsType>
+class SwimmerEnvT : public Env<EnvSpec<SwimmerEnvFns<ObsType>>>,
+                    public MujocoEnv {
+ public:
+  using Base = Env<EnvSpec<SwimmerEnvFns<ObsType>>>;
+  using typename Base::Action;
+  using typename Base::Spec;
+  using typename Base::State;
 
-class SwimmerEnv : public Env<SwimmerEnvSpec>, public MujocoEnv {
  protected:
+  using Base::Allocate;
+  using Base::gen_;
+
+  ObsLayout obs_layout_;
   bool no_pos_;
   mjtNum ctrl_cost_weight_, forward_reward_weight_;
   std::uniform_real_distribution<> dist_;
 
  public:
-  SwimmerEnv(const Spec& spec, int env_id)
-      : Env<SwimmerEnvSpec>(spec, env_id),
+  SwimmerEnvT(const Spec& spec, int env_id)
+      : Base(spec, env_id),
         MujocoEnv(spec.config["base_path"_] + "/mujoco/assets_gym/swimmer.xml",
                   spec.config["frame_skip"_], spec.config["post_constraint"_],
-                  spec.config["max_episode_steps"_]),
+                  spec.config["max_episode_steps"_],
+                  spec.config["mjb_cache_dir"_],
+                  spec.config["model_randomization"_]),
         no_pos_(spec.config["exclude_current_positions_from_observation"_]),
         ctrl_cost_weight_(spec.config["ctrl_cost_weight"_]),
         forward_reward_weight_(spec.config["forward_reward_weight"_]),
         dist_(-spec.config["reset_noise_scale"_],
-              spec.config["reset_noise_scale"_]) {}
+              spec.config["reset_noise_scale"_]) {
+    obs_layout_.Add(&mjData::qpos, no_pos_ ? 2 : 0, model_->nq)
+        .Add(&mjData::qvel, 0, model_->nv);
+  }
 
   void MujocoResetModel() override {
     for (int i = 0; i < model_->nq; ++i) {
@@ -99,7 +117,7 @@ class SwimmerEnv : public Env<SwimmerEnvSpec>, public MujocoEnv {
   void Reset() override {
     done_ = false;
     elapsed_step_ = 0;
-    MujocoReset();
+    MujocoReset(&gen_);
     WriteState(0.0, 0.0, 0.0, 0.0, 0.0, 0.0);
   }
 
@@ -128,19 +146,17 @@ class SwimmerEnv : public Env<SwimmerEnvSpec>, public MujocoEnv {
     WriteState(reward, xv, yv, ctrl_cost, x_after, y_after);
   }
 
+  void Serialize(ByteWriter* writer) override { MujocoSerialize(writer); }
+
+  void Deserialize(ByteReader* reader) override { MujocoDeserialize(reader); }
+
  private:
   void WriteState(float reward, mjtNum xv, mjtNum yv, mjtNum ctrl_cost,
                   mjtNum x_after, mjtNum y_after) {
     State state = Allocate();
     state["reward"_] = reward;
     // obs
-    mjtNum* obs = static_cast<mjtNum*>(state["obs"_].Data());
-    for (int i = no_pos_ ? 2 : 0; i < model_->nq; ++i) {
-      *(obs++) = data_->qpos[i];
-    }
-    for (int i = 0; i < model_->nv; ++i) {
-      *(obs++) = data_->qvel[i];
-    }
+    obs_layout_.Write(data_, static_cast<ObsType*>(state["obs"_].Data()));
     // info
     state["info:reward_fwd"_] = xv * forward_reward_weight_;
     state["info:reward_ctrl"_] = -ctrl_cost;
@@ -157,8 +173,14 @@ class SwimmerEnv : public Env<SwimmerEnvSpec>, public MujocoEnv {
   }
 };
 
+using SwimmerEnv = SwimmerEnvT<float>;
+using SwimmerEnvSpec = SwimmerEnv::Spec;
 using SwimmerEnvPool = AsyncEnvPool<SwimmerEnv>;
 
+using SwimmerFloat64Env = SwimmerEnvT<mjtNum>;
+using SwimmerFloat64EnvSpec = SwimmerFloat64Env::Spec;
+using SwimmerFloat64EnvPool = AsyncEnvPool<SwimmerFloat64Env>;
+
 }  // namespace mujoco_gym
 
 #endif  // ENVPOOL_MUJOCO_GYM_SWIMMER_H_
@@ -28,6 +28,7 @@
 
 namespace mujoco_gym {
 
+template <typename ObsType>
 class Walker2dEnvFns {
  public:
   static decltype(auto) DefaultConfig() {
@@ -39,13 +40,15 @@ class Walker2dEnvFns {
         "healthy_z_min"_.Bind(0.8), "healthy_z_max"_.Bind(2.0),
         "healthy_angle_min"_.Bind(-1.0), "healthy_angle_max"_.Bind(1.0),
         "velocity_min"_.Bind(-10.0), "velocity_max"_.Bind(10.0),
-        "reset_noise_scale"_.Bind(0.005));
+        "reset_noise_scale"_.Bind(0.005),
+        "mjb_cache_dir"_.Bind(std::string("")),
+        "model_randomization"_.Bind(std::string("")));
   }
   template <typename Config>
   static decltype(auto) StateSpec(const Config& conf) {
-    mjtNum inf = std::numeric_limits<mjtNum>::infinity();
+    ObsType inf = std::numeric_limits<ObsType>::infinity();
     bool no_pos = conf["exclude_current_positions_from_observation"_];
-    return MakeDict("obs"_.Bind(Spec<mjtNum>({no_pos ? 17 : 18}, {-inf, inf})),
+    return MakeDict("obs"_.Bind(Spec<ObsType>({no_pos ? 17 : 18}, {-inf, inf})),
 #ifdef ENVPOOL_TEST
                     "info:qpos0"_.Bind(Spec<mjtNum>({9})),
                     "info:qvel0"_.Bind(Spec<mjtNum>({9})),
@@ -59,10 +62,20 @@ class Walker2dEnvFns {
   }
 };
 
-using Walker2dEnvSpec = EnvSpec<Walker2dEnvFns>;
+template <typename ObsType>
+class Walker2dEnvT : public Env<EnvSpec<Walker2dEnvFns<ObsType>>>,
+                     public MujocoEnv {
+ public:
+  using Base = Env<EnvSpec<Walker2dEnvFns<ObsType>>>;
+  using typename Base::Action;
+  using typename Base::Spec;
+  using typename Base::State;
 
-class Walker2dEnv : public Env<Walker2dEnvSpec>, public MujocoEnv {
  protected:
+  using Base::Allocate;
+  using Base::gen_;
+
+  ObsLayout obs_layout_;
   bool terminate_when_unhealthy_, no_pos_;
   mjtNum ctrl_cost_weight_, forward_reward_weight_;
   mjtNum healthy_reward_, healthy_z_min_, healthy_z_max_;
@@ -71,11 +84,13 @@ class Walker2dEnv : public Env<Walker2dEnvSpec>, public MujocoEnv {
   std::uniform_real_distribution<> dist_;
 
  public:
-  Walker2dEnv(const Spec& spec, int env_id)
-      : Env<Walker2dEnvSpec>(spec, env_id),
+  Walker2dEnvT(const Spec& spec, int env_id)
+      : Base(spec, env_id),
         MujocoEnv(spec.config["base_path"_] + "/mujoco/assets_gym/walker2d.xml",
                   spec.config["frame_skip"_], spec.config["post_constraint"_],
-                  spec.config["max_episode_steps"_]),
+                  spec.config["max_episode_steps"_],
+                  spec.config["mjb_cache_dir"_],
+                  spec.config["model_randomization"_]),
         terminate_when_unhealthy_(spec.config["terminate_when_unhealthy"_]),
         no_pos_(spec.config["exclude_current_positions_from_observation"_]),
         ctrl_cost_weight_(spec.config["ctrl_cost_weight"_]),
@@ -88,7 +103,11 @@ class Walker2dEnv : public Env<Walker2dEnvSpec>, public MujocoEnv {
         velocity_min_(spec.config["velocity_min"_]),
         velocity_max_(spec.config["velocity_max"_]),
         dist_(-spec.config["reset_noise_scale"_],
-              spec.config["reset_noise_scale"_]) {}
+              spec.config["reset_noise_scale"_]) {
+    obs_layout_.Add(&mjData::qpos, no_pos_ ? 1 : 0, model_->nq)
+        .AddClipped(&mjData::qvel, 0, model_->nv, velocity_min_,
+                    velocity_max_);
+  }
 
   void MujocoResetModel() override {
     for (int i = 0; i < model_->nq; ++i) {
@@ -108,7 +127,7 @@ class Walker2dEnv : public Env<Walker2dEnvSpec>, public MujocoEnv {
   void Reset() override {
     done_ = false;
     elapsed_step_ = 0;
-    MujocoReset();
+    MujocoReset(&gen_);
     WriteState(0.0, 0.0, 0.0);
   }
 
@@ -138,6 +157,10 @@ class Walker2dEnv : public Env<Walker2dEnvSpec>, public MujocoEnv {
     WriteState(reward, xv, x_after);
   }
 
+  void Serialize(ByteWriter* writer) override { MujocoSerialize(writer); }
+
+  void Deserialize(ByteReader* reader) override { MujocoDeserialize(reader); }
+
  private:
   bool IsHealthy() {
     if (data_->qpos[1] < healthy_z_min_ || data_->qpos[1] > healthy_z_max_) {
@@ -154,16 +177,7 @@ class Walker2dEnv : public Env<Walker2dEnvSpec>, public MujocoEnv {
     State state = Allocate();
     state["reward"_] = reward;
     // obs
-    mjtNum* obs = static_cast<mjtNum*>(state["obs"_].Data());
-    for (int i = no_pos_ ? 1 : 0; i < model_->nq; ++i) {
-      *(obs++) = data_->qpos[i];
-    }
-    for (int i = 0; i < model_->nv; ++i) {
-      mjtNum x = data_->qvel[i];
-      x = std::min(velocity_max_, x);
-      x = std::max(velocity_min_, x);
-      *(obs++) = x;
-    }
+    obs_layout_.Write(data_, static_cast<ObsType*>(state["obs"_].Data()));
     // info
     state["info:x_position"_] = x_after;
     state["info:x_velocity"_] = xv;
@@ -174,8 +188,14 @@ class Walker2dEnv : public Env<Walker2dEnvSpec>, public MujocoEnv {
   }
 };
 
+using Walker2dEnv = Walker2dEnvT<float>;
+using Walker2dEnvSpec = Walker2dEnv::Spec;
 using Walker2dEnvPool = AsyncEnvPool<Walker2dEnv>;
 
+using Walker2dFloat64Env = Walker2dEnvT<mjtNum>;
+using Walker2dFloat64EnvSpec = Walker2dFloat64Env::Spec;
+using Walker2dFloat64EnvPool = AsyncEnvPool<Walker2dFloat64Env>;
+
 }  // namespace mujoco_gym
 
 #endif  // ENVPOOL_MUJOCO_GYM_WALKER2D_H_
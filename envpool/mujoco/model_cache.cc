@@ -0,0 +1,221 @@
+// Copyright 2023 Garena Online Private Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "envpool/mujoco/model_cache.h"
+
+#include <glog/logging.h>
+#include <unistd.h>
+
+#include <array>
+#include <cctype>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace mujoco_common {
+
+uint64_t HashKey(const std::string& data) {
+  uint64_t hash = 14695981039346656037ULL;
+  for (unsigned char c : data) {
+    hash ^= c;
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+namespace {
+
+bool ReadFile(const std::filesystem::path& path, std::string* content) {
+  std::ifstream ifs(path, std::ios::binary);
+  if (!ifs) {
+    return false;
+  }
+  std::stringstream ss;
+  ss << ifs.rdbuf();
+  *content = ss.str();
+  return true;
+}
+
+// The (element name, value) of every attribute of `xml` named `name`, or
+// starting with it and followed by letters if `prefix`, e.g. `fileright` for
+// "file". Comments are not skipped, which can only add to a key.
+std::vector<std::pair<std::string, std::string>> Attributes(
+    const std::string& xml, const std::string& name, bool prefix) {
+  auto is_space = [](char c) {
+    return std::isspace(static_cast<unsigned char>(c)) != 0;
+  };
+  std::vector<std::pair<std::string, std::string>> attributes;
+  for (auto pos = xml.find(name); pos != std::string::npos;
+       pos = xml.find(name, pos + 1)) {
+    if (pos == 0 || !is_space(xml[pos - 1])) {
+      continue;
+    }
+    std::size_t i = pos + name.size();
+    while (prefix && i < xml.size() &&
+           std::isalpha(static_cast<unsigned char>(xml[i])) != 0) {
+      ++i;
+    }
+    while (i < xml.size() && is_space(xml[i])) {
+      ++i;
+    }
+    if (i == xml.size() || xml[i] != '=') {
+      continue;
+    }
+    ++i;
+    while (i < xml.size() && is_space(xml[i])) {
+      ++i;
+    }
+    if (i == xml.size() || (xml[i] != '"' && xml[i] != '\'')) {
+      continue;
+    }
+    auto end = xml.find(xml[i], i + 1);
+    auto open = xml.rfind('<', pos);
+    if (end == std::string::npos || open == std::string::npos) {
+      break;
+    }
+    auto element_end = open + 1;
+    while (element_end < pos && !is_space(xml[element_end])) {
+      ++element_end;
+    }
+    attributes.emplace_back(xml.substr(open + 1, element_end - open - 1),
+                            xml.substr(i + 1, end - i - 1));
+  }
+  return attributes;
+}
+
+void DeleteModel(const mjModel* model) {
+  mj_deleteModel(const_cast<mjModel*>(model));
+}
+
+std::string MjbPath(const std::string& key, const std::string& cache_dir) {
+  // MJB files are only readable by the MuJoCo build that wrote them.
+  const uint64_t hash = HashKey(std::to_string(mj_version()) + "#" +
+                                std::to_string(sizeof(mjtNum)) + "#" + key);
+  std::array<char, 17> hex;
+  std::snprintf(hex.data(), hex.size(), "%016llx",
+                static_cast<unsigned long long>(hash));  // NOLINT
+  return (std::filesystem::path(cache_dir) / (std::string(hex.data()) + ".mjb"))
+      .string();
+}
+
+void SaveMjb(const mjModel* model, const std::string& path) {
+  std::error_code ec;
+  std::filesystem::create_directories(
+      std::filesystem::path(path).parent_path(), ec);
+  // Write under a unique name and rename, so that concurrent processes never
+  // read a partial file.
+  const std::string tmp =
+      path + "." + std::to_string(getpid()) + "." +
+      std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+  mj_saveModel(model, tmp.c_str(), nullptr, 0);
+  std::filesystem::rename(tmp, path, ec);
+  if (ec) {
+    std::filesystem::remove(tmp, ec);
+    LOG(WARNING) << "Cannot write the MuJoCo model cache " << path;
+  }
+}
+
+}  // namespace
+
+std::string XmlFileKey(const std::string& xml) {
+  const std::filesystem::path model_dir =
+      std::filesystem::path(xml).parent_path();
+  std::string key = xml + "\n";
+  std::set<std::string> visited;
+  auto add = [&](const std::filesystem::path& path, std::string* content) {
+    if (!visited.insert(path.lexically_normal().string()).second ||
+        !ReadFile(path, content)) {
+      return false;
+    }
+    key += path.string() + "\n" + std::to_string(content->size()) + "\n" +
+           *content + "\n";
+    return true;
+  };
+  // asset directories of the compiler, relative to the model directory
+  std::vector<std::filesystem::path> asset_dirs = {model_dir};
+  std::vector<std::filesystem::path> pending = {xml};
+  std::string text;
+  std::string asset;
+  while (!pending.empty()) {
+    std::filesystem::path path = pending.back();
+    pending.pop_back();
+    if (!add(path, &text)) {
+      continue;
+    }
+    for (const char* dir : {"meshdir", "texturedir", "assetdir"}) {
+      for (const auto& attribute : Attributes(text, dir, false)) {
+        asset_dirs.push_back(model_dir / attribute.second);
+      }
+    }
+    for (const auto& [element, file] : Attributes(text, "file", true)) {
+      if (element == "include") {
+        // includes are relative to the main model file
+        pending.push_back(model_dir / file);
+        continue;
+      }
+      // any directory the asset may be found in, which can only add to a key
+      for (const auto& dir : asset_dirs) {
+        add(dir / file, &asset);
+      }
+    }
+  }
+  return key;
+}
+
+std::shared_ptr<const mjModel> LoadModel(const std::string& key,
+                                         const std::string& cache_dir,
+                                         const ModelCompiler& compile) {
+  static std::mutex mutex;
+  static std::map<std::string, std::weak_ptr<const mjModel>> cache;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  auto model = cache[key].lock();
+  if (model != nullptr) {
+    return model;
+  }
+  mjModel* raw = nullptr;
+  std::string path;
+  if (!cache_dir.empty()) {
+    path = MjbPath(key, cache_dir);
+    if (std::filesystem::exists(path)) {
+      raw = mj_loadModel(path.c_str(), nullptr);
+    }
+  }
+  if (raw == nullptr) {
+    std::array<char, 1000> error;
+    error[0] = '\0';
+    raw = compile(error.data(), static_cast<int>(error.size()));
+    if (raw == nullptr) {
+      throw std::runtime_error(std::string("Cannot compile MuJoCo model: ") +
+                               error.data());
+    }
+    if (!path.empty()) {
+      SaveMjb(raw, path);
+    }
+  }
+  model = std::shared_ptr<const mjModel>(raw, DeleteModel);
+  cache[key] = model;
+  return model;
+}
+
+}  // namespace mujoco_common
@@ -0,0 +1,63 @@
+/*
+ * Copyright 2023 Garena Online Private Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ENVPOOL_MUJOCO_MODEL_CACHE_H_
+#define ENVPOOL_MUJOCO_MODEL_CACHE_H_
+
+#include <mujoco.h>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace mujoco_common {
+
+// Compiles a model from its XML, writing a message into `error` on failure.
+using ModelCompiler = std::function<mjModel*(char* error, int error_size)>;
+
+/**
+ * Returns the compiled model identified by `key`, which must hold everything
+ * the model depends on: the processed XML text, the assets it includes and
+ * any parameters of the XML transforms. `compile` runs at most once per key
+ * and process; the model stays in memory while any caller holds it.
+ *
+ * If `cache_dir` is not empty, compiled models are also saved there as MJB
+ * files named after a hash of the key (and the MuJoCo version), and later
+ * processes load them with `mj_loadModel` instead of compiling. Failing to
+ * read or write the directory only costs a compile.
+ *
+ * The returned model is shared, copy it with `mj_copyModel` before writing.
+ */
+std::shared_ptr<const mjModel> LoadModel(const std::string& key,
+                                         const std::string& cache_dir,
+                                         const ModelCompiler& compile);
+
+/**
+ * Returns a key for `LoadModel` of the XML file `xml`: its path and text and
+ * the path and content of every file it references, i.e. included XML files,
+ * followed recursively, and the meshes, textures, height fields and skins
+ * looked up in the model directory and its compiler `meshdir`, `texturedir`
+ * and `assetdir`. Editing any of them therefore changes the key.
+ */
+std::string XmlFileKey(const std::string& xml);
+
+// FNV-1a hash of `data`, stable across runs and platforms.
+uint64_t HashKey(const std::string& data);
+
+}  // namespace mujoco_common
+
+#endif  // ENVPOOL_MUJOCO_MODEL_CACHE_H_
@@ -0,0 +1,247 @@
+// Copyright 2023 Garena Online Private Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "envpool/mujoco/model_randomizer.h"
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace mujoco_common {
+
+namespace {
+
+// An mjModel array of `rows` x `cols` values. Row r belongs to the object of
+// type `objtype` with id `owner[r]`, or id r if there is no `owner` array.
+struct FieldInfo {
+  const char* name;
+  mjtNum* mjModel::*array;
+  int mjModel::*rows;
+  int cols;
+  mjtObj objtype;
+  int* mjModel::*owner;
+};
+
+// Physical parameters that can be randomized.
+const FieldInfo kFields[] = {
+    {"body_pos", &mjModel::body_pos, &mjModel::nbody, 3, mjOBJ_BODY, nullptr},
+    {"body_ipos", &mjModel::body_ipos, &mjModel::nbody, 3, mjOBJ_BODY,
+     nullptr},
+    {"body_mass", &mjModel::body_mass, &mjModel::nbody, 1, mjOBJ_BODY,
+     nullptr},
+    {"body_inertia", &mjModel::body_inertia, &mjModel::nbody, 3, mjOBJ_BODY,
+     nullptr},
+    {"jnt_stiffness", &mjModel::jnt_stiffness, &mjModel::njnt, 1, mjOBJ_JOINT,
+     nullptr},
+    {"jnt_range", &mjModel::jnt_range, &mjModel::njnt, 2, mjOBJ_JOINT,
+     nullptr},
+    {"dof_damping", &mjModel::dof_damping, &mjModel::nv, 1, mjOBJ_JOINT,
+     &mjModel::dof_jntid},
+    {"dof_armature", &mjModel::dof_armature, &mjModel::nv, 1, mjOBJ_JOINT,
+     &mjModel::dof_jntid},
+    {"dof_frictionloss", &mjModel::dof_frictionloss, &mjModel::nv, 1,
+     mjOBJ_JOINT, &mjModel::dof_jntid},
+    {"geom_size", &mjModel::geom_size, &mjModel::ngeom, 3, mjOBJ_GEOM,
+     nullptr},
+    {"geom_friction", &mjModel::geom_friction, &mjModel::ngeom, 3, mjOBJ_GEOM,
+     nullptr},
+    {"geom_solref", &mjModel::geom_solref, &mjModel::ngeom, mjNREF,
+     mjOBJ_GEOM, nullptr},
+    {"geom_solimp", &mjModel::geom_solimp, &mjModel::ngeom, mjNIMP,
+     mjOBJ_GEOM, nullptr},
+    {"geom_margin", &mjModel::geom_margin, &mjModel::ngeom, 1, mjOBJ_GEOM,
+     nullptr},
+    {"tendon_stiffness", &mjModel::tendon_stiffness, &mjModel::ntendon, 1,
+     mjOBJ_TENDON, nullptr},
+    {"tendon_damping", &mjModel::tendon_damping, &mjModel::ntendon, 1,
+     mjOBJ_TENDON, nullptr},
+    {"tendon_frictionloss", &mjModel::tendon_frictionloss, &mjModel::ntendon,
+     1, mjOBJ_TENDON, nullptr},
+    {"actuator_gear", &mjModel::actuator_gear, &mjModel::nu, 6,
+     mjOBJ_ACTUATOR, nullptr},
+    {"actuator_gainprm", &mjModel::actuator_gainprm, &mjModel::nu, mjNGAIN,
+     mjOBJ_ACTUATOR, nullptr},
+    {"actuator_biasprm", &mjModel::actuator_biasprm, &mjModel::nu, mjNBIAS,
+     mjOBJ_ACTUATOR, nullptr},
+    {"actuator_ctrlrange", &mjModel::actuator_ctrlrange, &mjModel::nu, 2,
+     mjOBJ_ACTUATOR, nullptr},
+    {"actuator_forcerange", &mjModel::actuator_forcerange, &mjModel::nu, 2,
+     mjOBJ_ACTUATOR, nullptr},
+};
+
+[[noreturn]] void BadTerm(const std::string& term, const std::string& why) {
+  throw std::runtime_error("Bad model randomization term \"" + term +
+                           "\": " + why);
+}
+
+}  // namespace
+
+ModelRandomizer::ModelRandomizer(const mjModel* nominal,
+                                 const std::string& spec)
+    : nominal_model_(nominal) {
+  std::string line;
+  std::istringstream terms(spec);
+  while (std::getline(terms, line, ';')) {
+    std::istringstream lines(line);
+    std::string text;
+    while (std::getline(lines, text)) {
+      std::istringstream tokens(text);
+      std::string target;
+      std::string distribution;
+      std::string extra;
+      Term term;
+      if (!(tokens >> target)) {
+        continue;  // blank
+      }
+      if (!(tokens >> distribution >> term.low >> term.high) ||
+          (tokens >> extra)) {
+        BadTerm(text, "expected <field> <distribution> <low> <high>");
+      }
+      if (distribution == "uniform") {
+        term.distribution = Distribution::kUniform;
+      } else if (distribution == "scale") {
+        term.distribution = Distribution::kScale;
+      } else if (distribution == "shift") {
+        term.distribution = Distribution::kShift;
+      } else {
+        BadTerm(text, "unknown distribution " + distribution);
+      }
+      if (term.low > term.high) {
+        BadTerm(text, "low is greater than high");
+      }
+
+      // <field>[<column>]@<name>
+      std::string object;
+      std::size_t at = target.find('@');
+      if (at != std::string::npos) {
+        object = target.substr(at + 1);
+        target.resize(at);
+      }
+      int column = -1;
+      std::size_t bracket = target.find('[');
+      if (bracket != std::string::npos) {
+        if (target.back() != ']') {
+          BadTerm(text, "missing ]");
+        }
+        try {
+          column = std::stoi(
+              target.substr(bracket + 1, target.size() - bracket - 2));
+        } catch (const std::exception&) {
+          BadTerm(text, "bad column");
+        }
+        target.resize(bracket);
+      }
+      const FieldInfo* info = nullptr;
+      for (const auto& field : kFields) {
+        if (target == field.name) {
+          info = &field;
+        }
+      }
+      if (info == nullptr) {
+        BadTerm(text, "unknown or unsupported field " + target);
+      }
+      if (column >= info->cols) {
+        BadTerm(text, "column out of range");
+      }
+      int object_id = -1;
+      if (!object.empty()) {
+        object_id = mj_name2id(nominal, info->objtype, object.c_str());
+        if (object_id < 0) {
+          BadTerm(text, "no object named " + object);
+        }
+      }
+
+      term.field = info->array;
+      const int rows = nominal->*(info->rows);
+      const mjtNum* values = nominal->*(info->array);
+      for (int r = 0; r < rows; ++r) {
+        const int owner =
+            info->owner == nullptr ? r : (nominal->*(info->owner))[r];
+        if (object_id >= 0 && owner != object_id) {
+          continue;
+        }
+        for (int c = 0; c < info->cols; ++c) {
+          if (column < 0 || c == column) {
+            term.elements.push_back(r * info->cols + c);
+            term.nominal.push_back(values[r * info->cols + c]);
+          }
+        }
+      }
+      terms_.push_back(std::move(term));
+    }
+  }
+}
+
+void ModelRandomizer::Redirect(mjModel* model) {
+  buffers_.clear();
+  for (const auto& info : kFields) {
+    bool used = false;
+    for (const auto& term : terms_) {
+      used = used || term.field == info.array;
+    }
+    if (!used) {
+      continue;
+    }
+    const mjtNum* values = nominal_model_->*(info.array);
+    buffers_.push_back(Buffer{
+        info.array,
+        std::vector<mjtNum>(
+            values, values + (nominal_model_->*(info.rows)) * info.cols)});
+    model->*(info.array) = buffers_.back().values.data();
+  }
+}
+
+void ModelRandomizer::Randomize(mjModel* model, std::mt19937* gen) const {
+  for (const auto& term : terms_) {
+    std::uniform_real_distribution<mjtNum> dist(term.low, term.high);
+    mjtNum* values = model->*(term.field);
+    for (std::size_t i = 0; i < term.elements.size(); ++i) {
+      const mjtNum u = dist(*gen);
+      switch (term.distribution) {
+        case Distribution::kUniform:
+          values[term.elements[i]] = u;
+          break;
+        case Distribution::kScale:
+          values[term.elements[i]] = term.nominal[i] * u;
+          break;
+        case Distribution::kShift:
+          values[term.elements[i]] = term.nominal[i] + u;
+          break;
+      }
+    }
+  }
+}
+
+void ModelRandomizer::Serialize(const mjModel* model,
+                                ByteWriter* writer) const {
+  for (const auto& term : terms_) {
+    const mjtNum* values = model->*(term.field);
+    for (int element : term.elements) {
+      writer->Write(values[element]);
+    }
+  }
+}
+
+void ModelRandomizer::Deserialize(mjModel* model, ByteReader* reader) const {
+  for (const auto& term : terms_) {
+    mjtNum* values = model->*(term.field);
+    for (int element : term.elements) {
+      reader->Read(&values[element]);
+    }
+  }
+}
+
+}  // namespace mujoco_common
@@ -0,0 +1,92 @@
+/*
+ * Copyright 2023 Garena Online Private Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ENVPOOL_MUJOCO_MODEL_RANDOMIZER_H_
+#define ENVPOOL_MUJOCO_MODEL_RANDOMIZER_H_
+
+#include <mujoco.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "envpool/core/serialization.h"
+
+namespace mujoco_common {
+
+/**
+ * Per-episode domain randomization of mjModel parameters, configured by a
+ * string of terms separated by ';' or newlines:
+ *
+ *   <field>[<column>]@<name> <distribution> <low> <high>
+ *
+ * e.g. "body_mass scale 0.8 1.2; geom_friction[0]@floor uniform 0.5 1.5".
+ * `field` is one of the fields listed in model_randomizer.cc; `[column]`
+ * selects one column of a multi-column field and `@name` the rows of one
+ * named object (for dof fields, the dofs of a joint), both default to all.
+ * Distributions draw u ~ U(low, high) per element and set it to u
+ * ("uniform"), nominal * u ("scale") or nominal + u ("shift"). Values are
+ * drawn in term and element order, so they are deterministic under the env
+ * seed. Derived constants (e.g. body_subtreemass) are not recomputed, as when
+ * writing to the model in dm_control.
+ */
+class ModelRandomizer {
+ public:
+  ModelRandomizer() = default;
+  // Parses `spec` against `nominal`, whose values the distributions start
+  // from. Throws std::runtime_error on a malformed term.
+  ModelRandomizer(const mjModel* nominal, const std::string& spec);
+
+  [[nodiscard]] bool Empty() const { return terms_.empty(); }
+
+  /**
+   * Points the randomized fields of `model`, a shallow copy of the nominal
+   * model struct, at buffers owned by this object, so that an env only owns
+   * the randomized arrays and shares every other array of the model.
+   */
+  void Redirect(mjModel* model);
+
+  // Draws new values of the randomized elements of `model`.
+  void Randomize(mjModel* model, std::mt19937* gen) const;
+
+  // Writes or restores the current values of the randomized elements.
+  void Serialize(const mjModel* model, ByteWriter* writer) const;
+  void Deserialize(mjModel* model, ByteReader* reader) const;
+
+ protected:
+  enum class Distribution { kUniform, kScale, kShift };
+
+  struct Term {
+    mjtNum* mjModel::*field;
+    std::vector<int> elements;  // offsets into the field's array
+    std::vector<mjtNum> nominal;
+    Distribution distribution;
+    mjtNum low, high;
+  };
+
+  struct Buffer {
+    mjtNum* mjModel::*field;
+    std::vector<mjtNum> values;
+  };
+
+  std::vector<Term> terms_;
+  std::vector<Buffer> buffers_;  // filled by Redirect
+  const mjModel* nominal_model_{nullptr};
+};
+
+}  // namespace mujoco_common
+
+#endif  // ENVPOOL_MUJOCO_MODEL_RANDOMIZER_H_
@@ -0,0 +1,85 @@
+// Copyright 2023 Garena Online Private Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures the time to construct MuJoCo pools of `num_envs` envs:
+//   compile:  one env, which compiles the XML (what every env used to pay);
+//   memory:   the pool, compiling once and copying the model per env;
+//   mjb:      the pool again in a fresh state, loading the MJB file saved by a
+//             previous pool from `mjb_cache_dir`.
+//
+// Usage: mujoco_startup_benchmark [num_envs] [mjb_cache_dir]
+
+#include <chrono>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include "envpool/mujoco/dmc/cheetah.h"
+#include "envpool/mujoco/dmc/humanoid.h"
+#include "envpool/mujoco/dmc/humanoid_CMU.h"
+#include "envpool/mujoco/gym/ant.h"
+#include "envpool/mujoco/gym/humanoid.h"
+
+template <typename Pool>
+double Construct(int num_envs, const std::string& cache_dir) {
+  auto config = Pool::Spec::kDefaultConfig;
+  config["num_envs"_] = num_envs;
+  config["mjb_cache_dir"_] = cache_dir;
+  typename Pool::Spec spec(config);
+  auto start = std::chrono::steady_clock::now();
+  {
+    Pool pool(spec);
+  }
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return elapsed.count();
+}
+
+template <typename Pool>
+void Measure(const std::string& name, int num_envs,
+             const std::string& cache_dir) {
+  // Each pool is destroyed before the next one, which drops the in-memory
+  // model, so every row starts without a compiled model in the process.
+  std::filesystem::remove_all(cache_dir);
+  const double compile = Construct<Pool>(1, "");
+  const double memory = Construct<Pool>(num_envs, "");
+  Construct<Pool>(1, cache_dir);
+  const double mjb = Construct<Pool>(num_envs, cache_dir);
+  std::cout << std::left << std::setw(20) << name << std::right << std::fixed
+            << std::setprecision(3) << std::setw(10) << compile
+            << std::setw(14) << compile * num_envs << std::setw(10) << memory
+            << std::setw(10) << mjb << std::endl;
+}
+
+int main(int argc, char** argv) {
+  const int num_envs = argc > 1 ? std::stoi(argv[1]) : 1000;
+  const std::string cache_dir =
+      argc > 2 ? argv[2]
+               : (std::filesystem::temp_directory_path() / "envpool_mjb_bench")
+                     .string();
+  std::cout << "seconds to build " << num_envs << " envs" << std::endl;
+  std::cout << std::left << std::setw(20) << "task" << std::right
+            << std::setw(10) << "compile" << std::setw(14) << "x num_envs"
+            << std::setw(10) << "memory" << std::setw(10) << "mjb"
+            << std::endl;
+  Measure<mujoco_dmc::HumanoidCMUEnvPool>("dmc humanoid_CMU", num_envs,
+                                          cache_dir);
+  Measure<mujoco_dmc::HumanoidEnvPool>("dmc humanoid", num_envs, cache_dir);
+  Measure<mujoco_dmc::CheetahEnvPool>("dmc cheetah", num_envs, cache_dir);
+  Measure<mujoco_gym::HumanoidEnvPool>("gym Humanoid", num_envs, cache_dir);
+  Measure<mujoco_gym::AntEnvPool>("gym Ant", num_envs, cache_dir);
+  std::filesystem::remove_all(cache_dir);
+  return 0;
+}
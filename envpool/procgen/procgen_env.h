@@ -17,6 +17,11 @@
 #ifndef ENVPOOL_PROCGEN_PROCGEN_ENV_H_
 #define ENVPOOL_PROCGEN_PROCGEN_ENV_H_
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include <cstdint>
 #include <limits>
 #include <memory>
 #include <string>
@@ -56,6 +61,41 @@ std::size_t HashStrUint32(const std::string& str) {
   return hash;
 }
 
+// Converts a kRes x kRes x 3 frame to 3 x kRes x kRes.
+inline void HwcToChw(const uint8_t* hwc, uint8_t* chw) {
+  uint8_t* r = chw;
+  uint8_t* g = r + kRes * kRes;
+  uint8_t* b = g + kRes * kRes;
+  int i = 0;
+#ifdef __SSE2__
+  // 16 pixels at a time: four rounds of interleaving the low and high halves
+  // of the three registers sort the 48 bytes into one register per channel,
+  // as OpenCV's SSE2 v_load_deinterleave does
+  for (; i + 16 <= kRes * kRes; i += 16) {
+    const auto* p = reinterpret_cast<const __m128i*>(hwc + i * 3);
+    __m128i v0 = _mm_loadu_si128(p);
+    __m128i v1 = _mm_loadu_si128(p + 1);
+    __m128i v2 = _mm_loadu_si128(p + 2);
+    for (int round = 0; round < 4; ++round) {
+      __m128i t0 = _mm_unpacklo_epi8(v0, _mm_unpackhi_epi64(v1, v1));
+      __m128i t1 = _mm_unpacklo_epi8(_mm_unpackhi_epi64(v0, v0), v2);
+      __m128i t2 = _mm_unpacklo_epi8(v1, _mm_unpackhi_epi64(v2, v2));
+      v0 = t0;
+      v1 = t1;
+      v2 = t2;
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(r + i), v0);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(g + i), v1);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(b + i), v2);
+  }
+#endif
+  for (; i < kRes * kRes; ++i) {
+    r[i] = hwc[i * 3];
+    g[i] = hwc[i * 3 + 1];
+    b[i] = hwc[i * 3 + 2];
+  }
+}
+
 class ProcgenEnvFns {
  public:
   static decltype(auto) DefaultConfig() {
@@ -165,44 +205,51 @@ class ProcgenEnv : public Env<ProcgenEnvSpec> {
   }
 
   void Reset() override {
-    game_->step_data.done = false;
-    game_->step_data.reward = 0.0;
-    game_->step_data.level_complete = false;
-    game_->reset();
-    game_->observe();
-    WriteObs();
+    Run([this] {
+      game_->step_data.done = false;
+      game_->step_data.reward = 0.0;
+      game_->step_data.level_complete = false;
+      game_->reset();
+      game_->observe();
+    });
   }
 
   void Step(const Action& action) override {
     game_->action = action["action"_];
-    game_->step();
-    WriteObs();
+    Run([this] { game_->step(); });
   }
 
   bool IsDone() override { return done_ != 0; }
 
  private:
-  void WriteObs() {
-    State state = Allocate();
+  // Runs the game and writes what it observed into a newly allocated state.
+  // With the game's HWC layout, the state is allocated first and the game
+  // renders straight into it, so `done_` is only known after `Allocate` and
+  // is written again with `WriteDone`.
+  template <typename Play>
+  void Run(const Play& play) {
     if (channel_first_) {
-      // convert from HWC to CHW
-      auto* data = static_cast<uint8_t*>(state["obs"_].Data());
-      auto* buffer = static_cast<uint8_t*>(obs_.Data());
-      for (int i = 0; i < 3; ++i) {
-        for (int j = 0; j < kRes; ++j) {
-          for (int k = 0; k < kRes; ++k) {
-            data[i * kRes * kRes + j * kRes + k] =
-                buffer[j * kRes * 3 + k * 3 + i];
-          }
-        }
-      }
-    } else {
-      state["obs"_].Assign(obs_);
+      play();
+      State state = Allocate();
+      HwcToChw(static_cast<const uint8_t*>(obs_.Data()),
+               static_cast<uint8_t*>(state["obs"_].Data()));
+      WriteInfo(&state);
+      return;
     }
-    state["reward"_] = reward_;
-    state["info:prev_level_seed"_] = prev_level_seed_;
-    state["info:prev_level_complete"_] = prev_level_complete_;
-    state["info:level_seed"_] = level_seed_;
+    State state = Allocate();
+    game_->obs_bufs[0] = state["obs"_].Data();
+    play();
+    // the slice belongs to the pool once the state is returned
+    game_->obs_bufs[0] = obs_.Data();
+    WriteDone(&state);
+    WriteInfo(&state);
+  }
+
+  void WriteInfo(State* state) {
+    (*state)["reward"_] = reward_;
+    (*state)["info:prev_level_seed"_] = prev_level_seed_;
+    (*state)["info:prev_level_complete"_] = prev_level_complete_;
+    (*state)["info:level_seed"_] = level_seed_;
   }
 };
 
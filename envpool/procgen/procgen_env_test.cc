@@ -62,3 +62,46 @@ TEST(PRocgenEnvTest, BasicStep) {
     envpool.Send(action);
   }
 }
+
+TEST(PRocgenEnvTest, ChannelLast) {
+  // the HWC observation, which the game writes straight into the state,
+  // must be the transpose of the CHW one
+  auto config = procgen::ProcgenEnvSpec::kDefaultConfig;
+  config["num_envs"_] = 1;
+  config["seed"_] = 0;
+  config["env_name"_] = "bigfish";
+  procgen::ProcgenEnvSpec chw_spec(config);
+  config["channel_first"_] = false;
+  procgen::ProcgenEnvSpec hwc_spec(config);
+  procgen::ProcgenEnvPool chw_envpool(chw_spec);
+  procgen::ProcgenEnvPool hwc_envpool(hwc_spec);
+  TArray env_ids(Spec<int>({1}));
+  env_ids[0] = 0;
+  chw_envpool.Reset(env_ids);
+  hwc_envpool.Reset(env_ids);
+  std::mt19937 gen(0);
+  for (int i = 0; i < 1000; ++i) {
+    ProcgenState chw_state(chw_envpool.Recv());
+    ProcgenState hwc_state(hwc_envpool.Recv());
+    EXPECT_EQ(hwc_state["obs"_].Shape(),
+              std::vector<std::size_t>({1, 64, 64, 3}));
+    auto* chw = static_cast<uint8_t*>(chw_state["obs"_].Data());
+    auto* hwc = static_cast<uint8_t*>(hwc_state["obs"_].Data());
+    for (int c = 0; c < 3; ++c) {
+      for (int j = 0; j < 64 * 64; ++j) {
+        ASSERT_EQ(chw[c * 64 * 64 + j], hwc[j * 3 + c]) << i;
+      }
+    }
+    EXPECT_EQ(static_cast<bool>(chw_state["done"_][0]),
+              static_cast<bool>(hwc_state["done"_][0]));
+    EXPECT_EQ(static_cast<int>(chw_state["step_type"_][0]),
+              static_cast<int>(hwc_state["step_type"_][0]));
+    ProcgenAction action;
+    action["env_id"_] = chw_state["info:env_id"_];
+    action["players.env_id"_] = chw_state["info:env_id"_];
+    action["action"_] = TArray(Spec<int>({1}));
+    action["action"_][0] = static_cast<int>(gen() % 15);
+    chw_envpool.Send(action);
+    hwc_envpool.Send(action);
+  }
+}
@@ -0,0 +1,69 @@
+// Copyright 2023 Garena Online Private Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures the time of one step of a single procgen env, including rendering
+// and writing the observation, for both observation layouts, averaged over
+// `num_steps` random steps.
+//
+// Usage: procgen_step_benchmark [num_steps]
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "envpool/procgen/procgen_env.h"
+
+void Measure(const std::string& env_name, bool channel_first, int num_steps) {
+  auto config = procgen::ProcgenEnvSpec::kDefaultConfig;
+  config["num_envs"_] = 1;
+  config["num_threads"_] = 1;
+  config["env_name"_] = env_name;
+  config["channel_first"_] = channel_first;
+  procgen::ProcgenEnvSpec spec(config);
+  procgen::ProcgenEnvPool envpool(spec);
+  TArray env_ids(Spec<int>({1}));
+  env_ids[0] = 0;
+  envpool.Reset(env_ids);
+  procgen::ProcgenEnv::Action action;
+  std::mt19937 gen(0);
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < num_steps; ++i) {
+    procgen::ProcgenEnv::State state(envpool.Recv());
+    action["env_id"_] = state["info:env_id"_];
+    action["players.env_id"_] = state["info:env_id"_];
+    action["action"_] = TArray(Spec<int>({1}));
+    action["action"_][0] = static_cast<int>(gen() % 15);
+    envpool.Send(action);
+  }
+  envpool.Recv();
+  std::chrono::duration<double, std::micro> elapsed =
+      std::chrono::steady_clock::now() - start;
+  std::cout << std::left << std::setw(12) << env_name << std::setw(8)
+            << (channel_first ? "CHW" : "HWC") << std::right << std::fixed
+            << std::setprecision(1) << std::setw(12)
+            << elapsed.count() / num_steps << std::endl;
+}
+
+int main(int argc, char** argv) {
+  const int num_steps = argc > 1 ? std::stoi(argv[1]) : 10000;
+  std::cout << std::left << std::setw(12) << "task" << std::setw(8) << "obs"
+            << std::right << std::setw(12) << "us/step" << std::endl;
+  for (const std::string env_name : {"bigfish", "coinrun"}) {
+    Measure(env_name, true, num_steps);
+    Measure(env_name, false, num_steps);
+  }
+  return 0;
+}
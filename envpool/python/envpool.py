@@ -156,6 +156,32 @@ class EnvPoolMixin(ABC):
       reset=True, return_info=self.config["gym_reset_return_info"]
     )
 
+  def snapshot(
+    self: EnvPool,
+    env_id: Optional[np.ndarray] = None,
+  ) -> List[bytes]:
+    """Serialize the state of envs in env_id into flat byte buffers.
+
+    Only call this on envs that are not stepping, e.g. right after recv in
+    sync mode.
+    """
+    if env_id is None:
+      env_id = self.all_env_ids
+    return self._snapshot(np.asarray(env_id, dtype=np.int32))
+
+  def restore(
+    self: EnvPool,
+    snapshots: List[bytes],
+    env_id: Optional[np.ndarray] = None,
+  ) -> None:
+    """Restore envs in env_id from buffers returned by snapshot.
+
+    No observation is emitted: reuse the one received with the snapshot.
+    """
+    if env_id is None:
+      env_id = self.all_env_ids
+    self._restore(np.asarray(env_id, dtype=np.int32), list(snapshots))
+
   @property
   def config(self: EnvPool) -> Dict[str, Any]:
     """Config dict of this class."""
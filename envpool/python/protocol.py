@@ -157,6 +157,12 @@ class EnvPool(Protocol):
   def _reset(self, env_id: np.ndarray) -> None:
     """Cpp private _reset method."""
 
+  def _snapshot(self, env_id: np.ndarray) -> List[bytes]:
+    """Cpp private _snapshot method."""
+
+  def _restore(self, env_id: np.ndarray, snapshots: List[bytes]) -> None:
+    """Cpp private _restore method."""
+
   def _from(
     self,
     action: Union[Dict[str, Any], np.ndarray],
@@ -231,5 +237,15 @@ class EnvPool(Protocol):
   ) -> Union[TimeStep, Tuple]:
     """Envpool reset interface."""
 
+  def snapshot(self, env_id: Optional[np.ndarray] = None) -> List[bytes]:
+    """Envpool snapshot interface."""
+
+  def restore(
+    self,
+    snapshots: List[bytes],
+    env_id: Optional[np.ndarray] = None,
+  ) -> None:
+    """Envpool restore interface."""
+
   def xla(self) -> Tuple[Any, Callable, Callable, Callable]:
     """Get the xla functions."""
@@ -0,0 +1,59 @@
+# Copyright 2023 Garena Online Private Limited
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+"""Checks shared by the tests of several env families."""
+
+from typing import Any, List, Optional, Sequence, Tuple
+
+import numpy as np
+import optree
+from dm_env import TimeStep
+
+
+def _observation_and_reward(
+  result: Any, obs_keys: Optional[Sequence[str]]
+) -> Tuple[List[np.ndarray], np.ndarray]:
+  if isinstance(result, TimeStep):
+    obs, rew = result.observation, result.reward
+  else:
+    obs, rew = result[0], result[1]
+  if obs_keys is None:
+    return optree.tree_leaves(obs), rew
+  if isinstance(obs, dict):
+    return [obs[k] for k in obs_keys], rew
+  return [getattr(obs, k) for k in obs_keys], rew
+
+
+def check_snapshot_restore(
+  env: Any,
+  actions: Sequence[Any],
+  obs_keys: Optional[Sequence[str]] = None,
+  atol: float = 0.0,
+) -> None:
+  """Check that env replays actions the same way after a restore.
+
+  The envs are snapshotted in their current state, stepped through actions,
+  restored and stepped through them again; both runs must give the same
+  observations and rewards. obs_keys selects the observation entries to
+  compare, e.g. to leave out the info a dm_env observation also carries;
+  every entry is compared by default.
+  """
+  snapshots = env.snapshot()
+  first = [_observation_and_reward(env.step(a), obs_keys) for a in actions]
+  env.restore(snapshots)
+  second = [_observation_and_reward(env.step(a), obs_keys) for a in actions]
+  for (obs0, rew0), (obs1, rew1) in zip(first, second):
+    assert len(obs0) == len(obs1)
+    for o0, o1 in zip(obs0, obs1):
+      np.testing.assert_allclose(o0, o1, atol=atol)
+    np.testing.assert_allclose(rew0, rew1, atol=atol)
@@ -12,9 +12,18 @@
 # See the License for the specific language governing permissions and
 # limitations under the License.
 
+from typing import Optional
+
 from envpool.python.api import py_env
+from envpool.python.protocol import EnvPool
 
-from .sokoban_envpool import _SokobanEnvPool, _SokobanEnvSpec
+from .sokoban_envpool import (
+  _LevelSampler,
+  _SokobanBatchEnvPool,
+  _SokobanBatchEnvSpec,
+  _SokobanEnvPool,
+  _SokobanEnvSpec,
+)
 
 (
   SokobanEnvSpec,
@@ -23,9 +32,38 @@ from .sokoban_envpool import _SokobanEnvPool, _SokobanEnvSpec
   SokobanGymnasiumEnvPool,
 ) = py_env(_SokobanEnvSpec, _SokobanEnvPool)
 
+(
+  SokobanBatchEnvSpec,
+  SokobanBatchDMEnvPool,
+  SokobanBatchGymEnvPool,
+  SokobanBatchGymnasiumEnvPool,
+) = py_env(_SokobanBatchEnvSpec, _SokobanBatchEnvPool)
+
+
+def level_sampler(env: EnvPool) -> Optional[_LevelSampler]:
+  """Return the level sampler the envs of ``env`` draw levels from.
+
+  None unless ``env`` was made with ``level_sampler`` set. The sampler is
+  shared by every env made with the same ``levels_dir``, ``seed`` and
+  ``level_sampler_id``; its ``stats()`` are per-level numpy arrays, and
+  ``reseed(seed)`` restarts every env's level draws from ``seed``.
+  """
+  config = env.spec.config
+  if not config.level_sampler:
+    return None
+  return _LevelSampler.find(
+    config.levels_dir, config.seed, config.level_sampler_id
+  )
+
+
 __all__ = [
   "SokobanEnvSpec",
   "SokobanDMEnvPool",
   "SokobanGymEnvPool",
   "SokobanGymnasiumEnvPool",
+  "SokobanBatchEnvSpec",
+  "SokobanBatchDMEnvPool",
+  "SokobanBatchGymEnvPool",
+  "SokobanBatchGymnasiumEnvPool",
+  "level_sampler",
 ]
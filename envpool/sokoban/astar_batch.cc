@@ -0,0 +1,200 @@
+// Copyright 2023-2024 FAR AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Multi-threaded counterpart of `astar_log`: solves every level of a level
+// file or directory with `SokobanSolver` and appends one CSV line per level,
+// in level order, in the same format as `astar_log`. Levels already present in
+// the log are skipped, so an interrupted run can be resumed. Search mode
+// "push" (`SokobanSolver::SolvePushes`) finds equally short solutions with far
+// fewer nodes; "step" searches single steps like `astar_log`, with the same
+// solution lengths but a different heuristic, so its search step counts differ.
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "envpool/sokoban/level_loader.h"
+#include "envpool/sokoban/sokoban_solver.h"
+
+namespace sokoban {
+
+// Level indices already in the log written by a previous run.
+std::unordered_set<int> ReadSolvedLevels(const std::string& log_file_name) {
+  std::unordered_set<int> solved;
+  std::ifstream log_file_in(log_file_name);
+  std::string line;
+  std::getline(log_file_in, line);  // skip header
+  while (std::getline(log_file_in, line)) {
+    if (!line.empty()) {
+      solved.insert(std::stoi(line.substr(0, line.find(','))));
+    }
+  }
+  return solved;
+}
+
+std::string FormatLogLine(int level_idx, const SolveResult& result) {
+  std::stringstream line;
+  line << level_idx << ",";
+  switch (result.status) {
+    case SolveStatus::kSolved:
+      for (int action : result.actions) {
+        line << action;
+      }
+      line << "," << result.actions.size();
+      break;
+    case SolveStatus::kUnsolvable:
+      line << "SEARCH_STATE_FAILED,-1";
+      break;
+    case SolveStatus::kOutOfNodes:
+      line << "SEARCH_STATE_OUT_OF_MEMORY,-1";
+      break;
+  }
+  line << "," << result.search_steps << std::endl;
+  return line.str();
+}
+
+void RunAStarBatch(const std::string& level_path,
+                   const std::string& log_file_name, int num_threads,
+                   int total_levels_to_run, std::size_t max_nodes,
+                   bool pushes) {
+  const int dim_room = 10;
+  std::vector<TaggedSokobanLevel> levels = ReadAllLevels(level_path);
+  const int n_levels =
+      std::min(static_cast<int>(levels.size()), total_levels_to_run);
+
+  const bool new_log = !std::filesystem::exists(log_file_name) ||
+                       std::filesystem::file_size(log_file_name) == 0;
+  std::unordered_set<int> solved;
+  if (!new_log) {
+    solved = ReadSolvedLevels(log_file_name);
+  }
+  std::vector<int> todo;
+  for (int i = 0; i < n_levels; i++) {
+    if (solved.count(i) == 0) {
+      todo.push_back(i);
+    }
+  }
+  std::cout << "Solving " << todo.size() << " of " << n_levels
+            << " levels from " << level_path << " with " << num_threads
+            << " threads, logging to " << log_file_name << std::endl;
+
+  std::ofstream log_file_out(log_file_name, std::ios_base::app);
+  if (new_log) {
+    log_file_out << "Level,Actions,Steps,SearchSteps" << std::endl;
+  }
+
+  // Workers claim levels in order and park the line in `lines`; the main
+  // thread writes lines as soon as all earlier levels are done. The first
+  // error of a worker, e.g. a level the solver cannot take, stops the batch
+  // and is rethrown here once the lines before it are written.
+  std::vector<std::optional<std::string>> lines(todo.size());
+  std::atomic<std::size_t> next_todo{0};
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::exception_ptr error;
+  std::size_t error_index = todo.size();
+  std::vector<std::thread> workers;
+  for (int t = 0; t < num_threads; t++) {
+    workers.emplace_back([&] {
+      SokobanSolver::Arena arena;
+      for (std::size_t i = next_todo++; i < todo.size(); i = next_todo++) {
+        try {
+          SokobanSolver solver(dim_room, levels[todo[i]].data);
+          std::string line = FormatLogLine(
+              todo[i], pushes ? solver.SolvePushes(max_nodes, &arena)
+                              : solver.Solve(max_nodes, &arena));
+          std::lock_guard<std::mutex> lock(mutex);
+          lines[i] = std::move(line);
+        } catch (...) {
+          std::lock_guard<std::mutex> lock(mutex);
+          if (i < error_index) {
+            error = std::current_exception();
+            error_index = i;
+          }
+          next_todo = todo.size();
+        }
+        cv.notify_one();
+      }
+    });
+  }
+  for (std::size_t i = 0; i < todo.size(); i++) {
+    std::string line;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      cv.wait(lock, [&] { return lines[i].has_value() || error_index <= i; });
+      if (!lines[i].has_value()) {
+        break;
+      }
+      line = std::move(*lines[i]);
+      lines[i].reset();
+    }
+    log_file_out << line;
+    log_file_out.flush();
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+}  // namespace sokoban
+
+int main(int argc, char** argv) {
+  if (argc < 3) {
+    std::cout << "Usage: " << argv[0]
+              << " level_file_or_dir log_file_name [num_threads]"
+                 " [total_levels_to_run] [max_nodes] [step|push]"
+              << std::endl;
+    return 1;
+  }
+  int num_threads = static_cast<int>(std::thread::hardware_concurrency());
+  int total_levels_to_run = std::numeric_limits<int>::max();
+  std::size_t max_nodes = 10000000;
+  if (argc > 3) {
+    num_threads = std::stoi(argv[3]);
+  }
+  if (argc > 4) {
+    total_levels_to_run = std::stoi(argv[4]);
+  }
+  if (argc > 5) {
+    max_nodes = std::stoull(argv[5]);
+  }
+  std::string mode = argc > 6 ? argv[6] : "step";
+  if (mode != "step" && mode != "push") {
+    std::cout << "Unknown search mode " << mode << std::endl;
+    return 1;
+  }
+  try {
+    sokoban::RunAStarBatch(argv[1], argv[2], std::max(num_threads, 1),
+                           total_levels_to_run, max_nodes, mode == "push");
+  } catch (const std::exception& e) {
+    std::cout << "Error: " << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
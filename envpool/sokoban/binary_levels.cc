@@ -0,0 +1,177 @@
+// Copyright 2023-2024 FAR AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "envpool/sokoban/binary_levels.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace sokoban {
+
+static_assert(sizeof(BinaryLevelHeader) == 32,
+              "BinaryLevelHeader must not have padding");
+
+BinaryLevelFile::BinaryLevelFile(const std::filesystem::path& path) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    std::stringstream msg;
+    msg << "Could not open level file " << path << std::endl;
+    throw std::runtime_error(msg.str());
+  }
+  struct stat st {};
+  if (fstat(fd, &st) != 0 ||
+      static_cast<std::size_t>(st.st_size) < sizeof(BinaryLevelHeader)) {
+    close(fd);
+    std::stringstream msg;
+    msg << "Level file " << path << " is too small." << std::endl;
+    throw std::runtime_error(msg.str());
+  }
+  map_size_ = static_cast<std::size_t>(st.st_size);
+  map_ = mmap(nullptr, map_size_, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (map_ == MAP_FAILED) {
+    map_ = nullptr;
+    std::stringstream msg;
+    msg << "Could not mmap level file " << path << std::endl;
+    throw std::runtime_error(msg.str());
+  }
+
+  const auto* base = static_cast<const uint8_t*>(map_);
+  header_ = reinterpret_cast<const BinaryLevelHeader*>(base);
+  std::stringstream msg;
+  if (std::memcmp(header_->magic, kBinaryLevelMagic,
+                  sizeof(kBinaryLevelMagic)) != 0) {
+    msg << "Level file " << path << " is not a binary level file.";
+  } else if (header_->version != kBinaryLevelVersion) {
+    msg << "Level file " << path << " has version " << header_->version
+        << ", expected " << kBinaryLevelVersion << ".";
+  } else if (header_->bytes_per_level !=
+             (header_->dim_room * header_->dim_room + 1) / 2) {
+    msg << "Level file " << path << " has bytes_per_level="
+        << header_->bytes_per_level << " for dim_room=" << header_->dim_room;
+  } else if (map_size_ != sizeof(BinaryLevelHeader) +
+                              header_->num_levels *
+                                  (2 * sizeof(int32_t) +
+                                   header_->bytes_per_level)) {
+    msg << "Level file " << path << " is truncated.";
+  }
+  if (!msg.str().empty()) {
+    munmap(map_, map_size_);
+    map_ = nullptr;
+    throw std::runtime_error(msg.str());
+  }
+  index_ = reinterpret_cast<const int32_t*>(base + sizeof(BinaryLevelHeader));
+  cells_ = reinterpret_cast<const uint8_t*>(index_ + 2 * header_->num_levels);
+}
+
+BinaryLevelFile::~BinaryLevelFile() {
+  if (map_ != nullptr) {
+    munmap(map_, map_size_);
+  }
+}
+
+std::shared_ptr<const BinaryLevelFile> BinaryLevelFile::Open(
+    const std::filesystem::path& path) {
+  static std::mutex mutex;
+  static std::map<std::string, std::weak_ptr<const BinaryLevelFile>> cache;
+
+  std::string key = std::filesystem::canonical(path).string();
+  std::lock_guard<std::mutex> lock(mutex);
+  auto file = cache[key].lock();
+  if (file == nullptr) {
+    file = std::shared_ptr<const BinaryLevelFile>(new BinaryLevelFile(key));
+    cache[key] = file;
+  }
+  return file;
+}
+
+void BinaryLevelFile::GetLevel(std::size_t i, SokobanLevel* out) const {
+  if (i >= Size()) {
+    std::stringstream msg;
+    msg << "Level " << i << " out of range, file has " << Size() << " levels.";
+    throw std::runtime_error(msg.str());
+  }
+  const std::size_t n_cells = header_->dim_room * header_->dim_room;
+  const uint8_t* packed = cells_ + i * header_->bytes_per_level;
+  out->resize(n_cells);
+  for (std::size_t c = 0; c < n_cells; c++) {
+    (*out)[c] = (packed[c / 2] >> (4 * (c % 2))) & 0xF;
+  }
+}
+
+bool IsBinaryLevelFile(const std::filesystem::path& path) {
+  if (!std::filesystem::is_regular_file(path)) {
+    return false;
+  }
+  std::ifstream file(path, std::ios::binary);
+  char magic[sizeof(kBinaryLevelMagic)]{};
+  file.read(magic, sizeof(magic));
+  return file.gcount() == sizeof(magic) &&
+         std::memcmp(magic, kBinaryLevelMagic, sizeof(magic)) == 0;
+}
+
+void WriteBinaryLevels(const std::filesystem::path& path, int dim_room,
+                       int num_files,
+                       const std::vector<TaggedSokobanLevel>& levels) {
+  BinaryLevelHeader header{};
+  std::memcpy(header.magic, kBinaryLevelMagic, sizeof(kBinaryLevelMagic));
+  header.version = kBinaryLevelVersion;
+  header.dim_room = dim_room;
+  header.num_levels = levels.size();
+  header.num_files = num_files;
+  header.bytes_per_level = (dim_room * dim_room + 1) / 2;
+
+  std::vector<int32_t> index;
+  index.reserve(2 * levels.size());
+  std::vector<uint8_t> cells(levels.size() * header.bytes_per_level, 0);
+  for (std::size_t i = 0; i < levels.size(); i++) {
+    const auto& level = levels[i];
+    if (level.data.size() != static_cast<std::size_t>(dim_room * dim_room)) {
+      std::stringstream msg;
+      msg << "Level " << level.level_idx << " of file " << level.file_idx
+          << " is not " << dim_room << "x" << dim_room << "." << std::endl;
+      throw std::runtime_error(msg.str());
+    }
+    index.push_back(level.file_idx);
+    index.push_back(level.level_idx);
+    uint8_t* packed = cells.data() + i * header.bytes_per_level;
+    for (std::size_t c = 0; c < level.data.size(); c++) {
+      packed[c / 2] |= (level.data[c] & 0xF) << (4 * (c % 2));
+    }
+  }
+
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  out.write(reinterpret_cast<const char*>(index.data()),
+            static_cast<std::streamsize>(index.size() * sizeof(int32_t)));
+  out.write(reinterpret_cast<const char*>(cells.data()),
+            static_cast<std::streamsize>(cells.size()));
+  if (!out) {
+    std::stringstream msg;
+    msg << "Could not write level file " << path << std::endl;
+    throw std::runtime_error(msg.str());
+  }
+}
+
+}  // namespace sokoban
@@ -0,0 +1,95 @@
+/*
+ * Copyright 2023-2024 FAR AI
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ENVPOOL_SOKOBAN_BINARY_LEVELS_H_
+#define ENVPOOL_SOKOBAN_BINARY_LEVELS_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+#include "envpool/sokoban/level_loader.h"
+
+namespace sokoban {
+
+/**
+ * Packed level file, written by `convert_levels`. Layout (little endian):
+ *
+ *   BinaryLevelHeader
+ *   int32_t file_idx, level_idx       x num_levels  (where the level came from)
+ *   uint8_t cells[bytes_per_level]    x num_levels  (two cells per byte)
+ *
+ * Cells are the `kWall`..`kPlayerOnTarget` codes, low nibble first.
+ */
+struct BinaryLevelHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t dim_room;
+  uint64_t num_levels;
+  uint32_t num_files;
+  uint32_t bytes_per_level;
+};
+
+constexpr char kBinaryLevelMagic[8] = {'S', 'O', 'K', 'O',
+                                       'B', 'I', 'N', '\0'};
+constexpr uint32_t kBinaryLevelVersion = 1;
+
+/**
+ * Read-only view of a packed level file. The file is mmap'ed once per process
+ * and shared by every env that opens the same path, so `GetLevel` is an index
+ * lookup plus unpacking 50 bytes for a 10x10 level.
+ */
+class BinaryLevelFile {
+ protected:
+  void* map_{nullptr};
+  std::size_t map_size_{0};
+  const BinaryLevelHeader* header_{nullptr};
+  const int32_t* index_{nullptr};
+  const uint8_t* cells_{nullptr};
+
+  explicit BinaryLevelFile(const std::filesystem::path& path);
+
+ public:
+  ~BinaryLevelFile();
+  BinaryLevelFile(const BinaryLevelFile&) = delete;
+  BinaryLevelFile& operator=(const BinaryLevelFile&) = delete;
+
+  static std::shared_ptr<const BinaryLevelFile> Open(
+      const std::filesystem::path& path);
+
+  [[nodiscard]] std::size_t Size() const { return header_->num_levels; }
+  [[nodiscard]] int DimRoom() const {
+    return static_cast<int>(header_->dim_room);
+  }
+  [[nodiscard]] int FileIdx(std::size_t i) const { return index_[2 * i]; }
+  [[nodiscard]] int LevelIdx(std::size_t i) const { return index_[2 * i + 1]; }
+  // Unpacks level `i` into `out`, reusing its storage.
+  void GetLevel(std::size_t i, SokobanLevel* out) const;
+};
+
+// Whether `path` is a regular file that starts with `kBinaryLevelMagic`.
+bool IsBinaryLevelFile(const std::filesystem::path& path);
+
+// Writes `levels` (all `dim_room` x `dim_room`) in the packed format.
+void WriteBinaryLevels(const std::filesystem::path& path, int dim_room,
+                       int num_files,
+                       const std::vector<TaggedSokobanLevel>& levels);
+
+}  // namespace sokoban
+
+#endif  // ENVPOOL_SOKOBAN_BINARY_LEVELS_H_
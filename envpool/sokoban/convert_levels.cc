@@ -0,0 +1,77 @@
+// Copyright 2023-2024 FAR AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "envpool/sokoban/binary_levels.h"
+#include "envpool/sokoban/level_loader.h"
+
+namespace sokoban {
+
+// Packs every level under `levels_dir` into `out_path`. Files are visited in
+// the same sorted order as `LevelLoader`, so the stored file/level indices
+// match what the text loader reports in `info`.
+void ConvertLevels(const std::filesystem::path& levels_dir,
+                   const std::filesystem::path& out_path) {
+  std::vector<std::filesystem::path> files = ListLevelFiles(levels_dir);
+  std::vector<TaggedSokobanLevel> levels;
+  int dim_room = -1;
+  for (std::size_t file_idx = 0; file_idx < files.size(); file_idx++) {
+    std::vector<SokobanLevel> file_levels = ReadLevelFile(files[file_idx]);
+    for (std::size_t level_idx = 0; level_idx < file_levels.size();
+         level_idx++) {
+      SokobanLevel& level = file_levels[level_idx];
+      int level_dim = 0;
+      while (level_dim * level_dim < static_cast<int>(level.size())) {
+        level_dim++;
+      }
+      if (dim_room == -1) {
+        dim_room = level_dim;
+      } else if (level_dim != dim_room) {
+        std::stringstream msg;
+        msg << "Level " << level_idx << " of " << files[file_idx] << " is "
+            << level_dim << "x" << level_dim << ", expected " << dim_room
+            << "x" << dim_room << std::endl;
+        throw std::runtime_error(msg.str());
+      }
+      levels.push_back(TaggedSokobanLevel{static_cast<int>(file_idx),
+                                          static_cast<int>(level_idx),
+                                          std::move(level)});
+    }
+  }
+  if (levels.empty()) {
+    throw std::runtime_error("No levels found.");
+  }
+  WriteBinaryLevels(out_path, dim_room, static_cast<int>(files.size()),
+                    levels);
+  std::cout << "Wrote " << levels.size() << " levels from " << files.size()
+            << " files to " << out_path << std::endl;
+}
+
+}  // namespace sokoban
+
+int main(int argc, char** argv) {
+  if (argc != 3) {
+    std::cout << "Usage: " << argv[0] << " levels_dir_or_file out_file"
+              << std::endl;
+    return 1;
+  }
+  sokoban::ConvertLevels(argv[1], argv[2]);
+  return 0;
+}
@@ -0,0 +1,95 @@
+// Copyright 2023-2024 FAR AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "envpool/sokoban/level_loader.h"
+#include "envpool/sokoban/sokoban_world.h"
+#include "envpool/sokoban/solution_index.h"
+
+namespace sokoban {
+
+// `astar_log` writes actions as up, right, down, left digits.
+constexpr std::array<uint8_t, 4> kAStarToEnvAction = {
+    kActPushUp, kActPushRight, kActPushDown, kActPushLeft};
+
+// Turns an `astar_log` or `astar_batch` CSV for the levels under `levels_path`
+// into a solution index. The log numbers levels in sequential load order,
+// which `ReadAllLevels` maps back to the file/level indices envs report.
+void ConvertSolutions(const std::filesystem::path& levels_path,
+                      const std::filesystem::path& log_path,
+                      const std::filesystem::path& out_path) {
+  std::vector<TaggedSokobanLevel> levels = ReadAllLevels(levels_path);
+  std::ifstream log(log_path);
+  if (!log) {
+    std::stringstream msg;
+    msg << "Could not open " << log_path << std::endl;
+    throw std::runtime_error(msg.str());
+  }
+  std::vector<TaggedSolution> solutions;
+  std::string line;
+  std::getline(log, line);  // skip header
+  while (std::getline(log, line)) {
+    if (line.empty()) {
+      continue;
+    }
+    std::stringstream fields(line);
+    std::string level_field, actions_field;
+    std::getline(fields, level_field, ',');
+    std::getline(fields, actions_field, ',');
+    const std::size_t level = std::stoul(level_field);
+    if (level >= levels.size()) {
+      std::stringstream msg;
+      msg << "Level " << level << " of " << log_path << " is not in "
+          << levels_path << ", which has " << levels.size() << " levels."
+          << std::endl;
+      throw std::runtime_error(msg.str());
+    }
+    TaggedSolution solution{levels[level].file_idx, levels[level].level_idx,
+                            true, {}};
+    for (char c : actions_field) {
+      if (c < '0' || c > '3') {
+        solution.solved = false;  // SEARCH_STATE_FAILED etc.
+        solution.actions.clear();
+        break;
+      }
+      solution.actions.push_back(kAStarToEnvAction[c - '0']);
+    }
+    solutions.push_back(std::move(solution));
+  }
+  const std::size_t num_solutions = solutions.size();
+  WriteSolutionIndex(out_path, std::move(solutions));
+  std::cout << "Wrote " << num_solutions << " solutions to " << out_path
+            << std::endl;
+}
+
+}  // namespace sokoban
+
+int main(int argc, char** argv) {
+  if (argc != 4) {
+    std::cout << "Usage: " << argv[0]
+              << " levels_dir_or_file astar_log_csv out_file" << std::endl;
+    return 1;
+  }
+  sokoban::ConvertSolutions(argv[1], argv[2], argv[3]);
+  return 0;
+}
@@ -15,14 +15,19 @@
 #include "level_loader.h"
 
 #include <algorithm>
+#include <array>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <iterator>
+#include <map>
+#include <mutex>
+#include <numeric>
 #include <sstream>
 #include <stdexcept>
 #include <string>
 
+#include "envpool/sokoban/binary_levels.h"
 #include "envpool/sokoban/utils.h"
 
 namespace sokoban {
@@ -36,21 +41,20 @@ LevelLoader::LevelLoader(const std::filesystem::path& base_path,
       num_envs_(num_envs),
       cur_level_(env_id),
       verbose(verbose) {
-  if (std::filesystem::is_regular_file(base_path)) {
-    level_file_paths_.push_back(base_path);
-  } else {
-    for (const auto& entry : std::filesystem::directory_iterator(base_path)) {
-      if (entry.is_regular_file()) {
-        level_file_paths_.push_back(entry.path());
-      }
+  if (IsBinaryLevelFile(base_path)) {
+    binary_levels_ = BinaryLevelFile::Open(base_path);
+    if (binary_levels_->Size() == 0) {
+      std::stringstream msg;
+      msg << "No levels in binary level file " << base_path << std::endl;
+      throw std::runtime_error(msg.str());
+    }
+    if (verbose >= 1) {
+      std::cout << "***Mapped " << binary_levels_->Size() << " levels from "
+                << base_path << std::endl;
     }
-    std::sort(
-        level_file_paths_.begin(), level_file_paths_.end(),
-        [](const std::filesystem::path& a, const std::filesystem::path& b) {
-          return a.filename().string() < b.filename().string();
-        });
+  } else {
+    store_ = LevelStore::Open(base_path);
   }
-  cur_file_ = level_file_paths_.begin();
   if (n_levels_to_load_ > 0 && n_levels_to_load_ % num_envs_ != 0) {
     throw std::runtime_error(
         "n_levels_to_load must be a multiple of num_envs.");
@@ -112,24 +116,28 @@ void PrintLevel(std::ostream& os, const SokobanLevel& vec) {
   }
 }
 
-void LevelLoader::LoadFile(std::mt19937& gen) {
-  std::filesystem::path file_path;
-  if (load_sequentially_) {
-    if (cur_file_ == level_file_paths_.end()) {
-      throw std::runtime_error("No more files to load.");
+std::vector<std::filesystem::path> ListLevelFiles(
+    const std::filesystem::path& base_path) {
+  std::vector<std::filesystem::path> paths;
+  if (std::filesystem::is_regular_file(base_path)) {
+    paths.push_back(base_path);
+    return paths;
+  }
+  for (const auto& entry : std::filesystem::directory_iterator(base_path)) {
+    if (entry.is_regular_file()) {
+      paths.push_back(entry.path());
     }
-    cur_level_file_++;
-    file_path = *cur_file_;
-    cur_file_++;
-  } else {
-    cur_level_file_ = SafeUniformInt(static_cast<size_t>(0),
-                                     level_file_paths_.size() - 1, gen);
-    file_path = level_file_paths_.at(cur_level_file_);
   }
-  std::ifstream file(file_path);
+  std::sort(paths.begin(), paths.end(),
+            [](const std::filesystem::path& a, const std::filesystem::path& b) {
+              return a.filename().string() < b.filename().string();
+            });
+  return paths;
+}
 
-  levels_.clear();
-  int cur_level_idx = 0;
+std::vector<SokobanLevel> ReadLevelFile(const std::filesystem::path& path) {
+  std::ifstream file(path);
+  std::vector<SokobanLevel> levels;
   std::string line;
   while (std::getline(file, line)) {
     if (line.empty()) {
@@ -165,37 +173,316 @@ void LevelLoader::LoadFile(std::mt19937& gen) {
             << "x" << dim_room << std::endl;
         throw std::runtime_error(msg.str());
       }
-      levels_.emplace_back(
-          std::make_pair(cur_level_idx++, std::move(cur_level)));
+      levels.push_back(std::move(cur_level));
+    }
+  }
+  return levels;
+}
+
+std::vector<TaggedSokobanLevel> ReadAllLevels(
+    const std::filesystem::path& base_path) {
+  std::vector<TaggedSokobanLevel> levels;
+  if (IsBinaryLevelFile(base_path)) {
+    auto file = BinaryLevelFile::Open(base_path);
+    levels.resize(file->Size());
+    for (std::size_t i = 0; i < file->Size(); i++) {
+      levels[i].file_idx = file->FileIdx(i);
+      levels[i].level_idx = file->LevelIdx(i);
+      file->GetLevel(i, &levels[i].data);
+    }
+    return levels;
+  }
+  std::vector<std::filesystem::path> files = ListLevelFiles(base_path);
+  for (std::size_t file_idx = 0; file_idx < files.size(); file_idx++) {
+    std::vector<SokobanLevel> file_levels = ReadLevelFile(files[file_idx]);
+    for (std::size_t level_idx = 0; level_idx < file_levels.size();
+         level_idx++) {
+      levels.push_back(TaggedSokobanLevel{static_cast<int>(file_idx),
+                                          static_cast<int>(level_idx),
+                                          std::move(file_levels[level_idx])});
     }
   }
+  return levels;
+}
+
+LevelStore::LevelStore(const std::filesystem::path& base_path)
+    : paths_(ListLevelFiles(base_path)), files_(paths_.size()) {}
+
+LevelStore::~LevelStore() {
+  {
+    std::lock_guard<std::mutex> lock(prefetch_.mutex);
+    prefetch_.stop = true;
+  }
+  prefetch_.cv.notify_all();
+  if (prefetch_.thread.joinable()) {
+    prefetch_.thread.join();
+  }
+}
+
+std::shared_ptr<const LevelStore> LevelStore::Open(
+    const std::filesystem::path& base_path) {
+  static std::mutex mutex;
+  static std::map<std::string, std::weak_ptr<const LevelStore>> cache;
+
+  std::string key = std::filesystem::canonical(base_path).string();
+  std::lock_guard<std::mutex> lock(mutex);
+  auto store = cache[key].lock();
+  if (store == nullptr) {
+    store = std::shared_ptr<const LevelStore>(new LevelStore(key));
+    cache[key] = store;
+  }
+  return store;
+}
+
+std::shared_ptr<const std::vector<SokobanLevel>> LevelStore::Levels(
+    std::size_t i) const {
+  FileSlot& file = files_.at(i);
+  std::shared_ptr<const FileLevels> levels;
+  {
+    std::lock_guard<std::mutex> lock(file.mutex);
+    levels = file.levels.lock();
+    if (levels == nullptr) {
+      levels = std::make_shared<const FileLevels>(ReadLevelFile(paths_.at(i)));
+      file.levels = levels;
+    }
+  }
+  std::lock_guard<std::mutex> lock(recent_mutex_);
+  auto it = std::find_if(recent_.begin(), recent_.end(),
+                         [i](const auto& entry) { return entry.first == i; });
+  if (it != recent_.end()) {
+    recent_.erase(it);
+  }
+  recent_.emplace_front(i, levels);
+  if (recent_.size() > kCachedFiles) {
+    recent_.pop_back();
+  }
+  return levels;
+}
+
+bool LevelStore::InWindow(std::size_t i) const {
+  for (const auto& [file, levels] : prefetch_.held) {
+    if (file <= i && i <= file + kPrefetchFiles && !levels.expired()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void LevelStore::Evict() const {
+  for (auto it = prefetch_.held.begin(); it != prefetch_.held.end();) {
+    it = it->second.expired() ? prefetch_.held.erase(it) : std::next(it);
+  }
+  for (auto it = prefetch_.ready.begin(); it != prefetch_.ready.end();) {
+    const bool keep =
+        InWindow(it->first) || prefetch_.requested.count(it->first) != 0;
+    it = keep ? std::next(it) : prefetch_.ready.erase(it);
+  }
+}
+
+bool LevelStore::NextToDecode(std::size_t* i) const {
+  auto missing = [&](std::size_t file) {
+    if (prefetch_.ready.count(file) != 0 || prefetch_.errors.count(file) != 0) {
+      return false;
+    }
+    auto held = prefetch_.held.find(file);
+    return held == prefetch_.held.end() || held->second.expired();
+  };
+  // Files loaders wait for come first, then the files after held ones.
+  for (std::size_t file : prefetch_.requested) {
+    if (missing(file)) {
+      *i = file;
+      return true;
+    }
+  }
+  for (const auto& [file, levels] : prefetch_.held) {
+    if (levels.expired()) {
+      continue;
+    }
+    const std::size_t end = std::min(file + kPrefetchFiles + 1, paths_.size());
+    for (std::size_t next = file + 1; next < end; next++) {
+      if (missing(next)) {
+        *i = next;
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+std::shared_ptr<const std::vector<SokobanLevel>> LevelStore::Stream(
+    std::size_t i) const {
+  if (i >= paths_.size()) {
+    std::stringstream msg;
+    msg << "Level file " << i << " out of range, there are " << paths_.size()
+        << " files." << std::endl;
+    throw std::runtime_error(msg.str());
+  }
+  std::unique_lock<std::mutex> lock(prefetch_.mutex);
+  if (!prefetch_.thread.joinable()) {
+    prefetch_.thread = std::thread([this] { PrefetchLoop(); });
+  }
+  std::shared_ptr<const FileLevels> levels;
+  for (;;) {
+    auto error = prefetch_.errors.find(i);
+    if (error != prefetch_.errors.end()) {
+      std::rethrow_exception(error->second);
+    }
+    auto ready = prefetch_.ready.find(i);
+    auto held = prefetch_.held.find(i);
+    if (ready != prefetch_.ready.end()) {
+      levels = ready->second;
+    } else if (held != prefetch_.held.end()) {
+      levels = held->second.lock();
+    }
+    if (levels != nullptr) {
+      break;
+    }
+    // A miss, at the start or when looping back to the first file.
+    prefetch_.requested.insert(i);
+    prefetch_.cv.notify_all();
+    prefetch_.cv.wait(lock);
+  }
+  prefetch_.requested.erase(i);
+  prefetch_.held[i] = levels;
+  Evict();
+  prefetch_.cv.notify_all();  // new files to prefetch after `i`
+  return levels;
+}
+
+void LevelStore::PrefetchLoop() const {
+  std::unique_lock<std::mutex> lock(prefetch_.mutex);
+  while (!prefetch_.stop) {
+    std::size_t next;
+    if (!NextToDecode(&next)) {
+      prefetch_.cv.wait(lock);
+      continue;
+    }
+    lock.unlock();
+    std::shared_ptr<const FileLevels> levels;
+    std::exception_ptr error;
+    try {
+      levels = std::make_shared<const FileLevels>(ReadLevelFile(paths_[next]));
+    } catch (...) {
+      error = std::current_exception();
+    }
+    lock.lock();
+    if (error != nullptr) {
+      prefetch_.errors[next] = error;
+    } else if (InWindow(next) || prefetch_.requested.count(next) != 0) {
+      // Otherwise loaders moved on while the file was decoded.
+      prefetch_.ready[next] = std::move(levels);
+    }
+    prefetch_.cv.notify_all();
+  }
+}
+
+void LevelStore::CountLevels() const {
+  std::call_once(counted_, [&] {
+    offsets_.assign(paths_.size() + 1, 0);
+    for (std::size_t i = 0; i < paths_.size(); i++) {
+      offsets_[i + 1] = offsets_[i] + Levels(i)->size();
+    }
+  });
+}
+
+std::size_t LevelStore::NumLevels() const {
+  CountLevels();
+  return offsets_.back();
+}
+
+std::pair<std::size_t, std::size_t> LevelStore::Locate(std::size_t i) const {
+  CountLevels();
+  if (i >= offsets_.back()) {
+    std::stringstream msg;
+    msg << "Level " << i << " out of range, there are " << offsets_.back()
+        << " levels." << std::endl;
+    throw std::runtime_error(msg.str());
+  }
+  // The last file whose first level is at or before i; empty files share
+  // their offset with the next file and are skipped.
+  const auto file =
+      std::upper_bound(offsets_.begin(), offsets_.end(), i) - offsets_.begin();
+  return {file - 1, i - offsets_[file - 1]};
+}
+
+void LevelLoader::LoadFile(std::mt19937& gen) {
+  if (load_sequentially_) {
+    if (cur_file_ >= store_->NumFiles()) {
+      throw std::runtime_error("No more files to load.");
+    }
+    cur_level_file_++;
+    cur_file_++;
+  } else {
+    cur_level_file_ = SafeUniformInt(static_cast<size_t>(0),
+                                     store_->NumFiles() - 1, gen);
+  }
+  const std::filesystem::path& file_path = store_->Path(cur_level_file_);
+  file_levels_ = load_sequentially_ ? store_->Stream(cur_level_file_)
+                                    : store_->Levels(cur_level_file_);
+  level_order_.resize(file_levels_->size());
+  std::iota(level_order_.begin(), level_order_.end(), 0);
   if (!load_sequentially_) {
-    std::shuffle(levels_.begin(), levels_.end(), gen);
+    std::shuffle(level_order_.begin(), level_order_.end(), gen);
   }
-  if (levels_.empty()) {
+  if (level_order_.empty()) {
     std::stringstream msg;
     msg << "No levels loaded from file '" << file_path << std::endl;
     throw std::runtime_error(msg.str());
   }
 
   if (verbose >= 1) {
-    std::cout << "***Loaded " << levels_.size() << " levels from " << file_path
-              << std::endl;
+    std::cout << "***Loaded " << level_order_.size() << " levels from "
+              << file_path << std::endl;
     if (verbose >= 2) {
-      PrintLevel(std::cout, levels_.at(0).second);
+      PrintLevel(std::cout, file_levels_->at(level_order_.at(0)));
       std::cout << std::endl;
-      PrintLevel(std::cout, levels_.at(1).second);
+      PrintLevel(std::cout, file_levels_->at(level_order_.at(1)));
       std::cout << std::endl;
     }
   }
 }
 
+TaggedSokobanLevel LevelLoader::GetBinaryLevel(std::mt19937& gen) {
+  const auto n_levels = static_cast<int64_t>(binary_levels_->Size());
+  int64_t idx;
+  if (load_sequentially_) {
+    if (n_levels_to_load_ > 0 && levels_loaded_ >= n_levels_to_load_) {
+      levels_loaded_ = 0;
+      cur_level_ = env_id_;
+    }
+    if (cur_level_ >= n_levels) {
+      throw std::runtime_error("No more levels to load.");
+    }
+    idx = cur_level_;
+    cur_level_ += num_envs_;
+  } else {
+    // Sample with replacement; with n_levels_to_load, only from the first
+    // n_levels_to_load levels of the file.
+    int64_t n_levels_to_sample = n_levels;
+    if (n_levels_to_load_ > 0) {
+      n_levels_to_sample = std::min(
+          n_levels_to_sample, static_cast<int64_t>(n_levels_to_load_) *
+                                  static_cast<int64_t>(num_envs_));
+    }
+    idx = SafeUniformInt(static_cast<int64_t>(0), n_levels_to_sample - 1, gen);
+  }
+  levels_loaded_++;
+
+  TaggedSokobanLevel tagged_level{binary_levels_->FileIdx(idx),
+                                  binary_levels_->LevelIdx(idx), {}};
+  binary_levels_->GetLevel(idx, &tagged_level.data);
+  return tagged_level;
+}
+
 TaggedSokobanLevel LevelLoader::GetLevel(std::mt19937& gen) {
+  if (binary_levels_ != nullptr) {
+    return GetBinaryLevel(gen);
+  }
   if (n_levels_to_load_ > 0 && levels_loaded_ >= n_levels_to_load_) {
     // std::cerr << "Warning: All levels loaded. Looping around now." <<
     // std::endl;
     levels_loaded_ = 0;
-    cur_file_ = level_file_paths_.begin();
+    cur_file_ = 0;
     cur_level_file_ = -1;
     LoadFile(gen);
     // re-start from the `env_id`th level, like we do in the constructor.
@@ -203,17 +490,37 @@ TaggedSokobanLevel LevelLoader::GetLevel(std::mt19937& gen) {
   }
   // Load new files until the current level index is within the loaded levels
   // this is required when new files have lesser levels than the number of envs
-  while (cur_level_ >= levels_.size()) {
-    cur_level_ -= levels_.size();
+  while (cur_level_ >= static_cast<int>(level_order_.size())) {
+    cur_level_ -= static_cast<int>(level_order_.size());
     LoadFile(gen);
   }
   // no need for bound checks since it is checked in the while loop above
-  auto out = levels_.begin() + cur_level_;
+  const int level_idx = level_order_[cur_level_];
   cur_level_ += num_envs_;
   levels_loaded_++;
 
-  TaggedSokobanLevel tagged_level{cur_level_file_, out->first, out->second};
+  TaggedSokobanLevel tagged_level{cur_level_file_, level_idx,
+                                  (*file_levels_)[level_idx]};
   return tagged_level;
 }
 
+TaggedSokobanLevel LevelLoader::GetLevelAt(std::size_t i) const {
+  if (binary_levels_ != nullptr) {
+    TaggedSokobanLevel tagged_level{-1, -1, {}};
+    binary_levels_->GetLevel(i, &tagged_level.data);  // checks the range
+    tagged_level.file_idx = binary_levels_->FileIdx(i);
+    tagged_level.level_idx = binary_levels_->LevelIdx(i);
+    return tagged_level;
+  }
+  const auto [file_idx, level_idx] = store_->Locate(i);
+  return TaggedSokobanLevel{static_cast<int>(file_idx),
+                            static_cast<int>(level_idx),
+                            (*store_->Levels(file_idx))[level_idx]};
+}
+
+std::size_t LevelLoader::NumLevels() const {
+  return binary_levels_ != nullptr ? binary_levels_->Size()
+                                   : store_->NumLevels();
+}
+
 }  // namespace sokoban
@@ -17,8 +17,16 @@
 #ifndef ENVPOOL_SOKOBAN_LEVEL_LOADER_H_
 #define ENVPOOL_SOKOBAN_LEVEL_LOADER_H_
 
+#include <condition_variable>
+#include <deque>
+#include <exception>
 #include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <random>
+#include <set>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -40,6 +48,101 @@ struct TaggedSokobanLevel {
   SokobanLevel data;
 };
 
+class BinaryLevelFile;
+
+/**
+ * Immutable text levels shared by every `LevelLoader` in the process that was
+ * opened on the same `base_path`. Through `Levels`, a file is parsed when an
+ * env asks for it and no one holds it, and kept while a loader holds it or it
+ * is among the `kCachedFiles` most recently asked for. Through `Stream`, files
+ * are decoded ahead of use by a background thread and dropped once every
+ * loader has moved past them.
+ */
+class LevelStore {
+ protected:
+  using FileLevels = std::vector<SokobanLevel>;
+  struct FileSlot {
+    std::mutex mutex;  // held while the file is parsed
+    std::weak_ptr<const FileLevels> levels;
+  };
+  std::vector<std::filesystem::path> paths_;
+  mutable std::vector<FileSlot> files_;
+  // The files `Levels` returned last, most recent first.
+  mutable std::mutex recent_mutex_;
+  mutable std::deque<std::pair<std::size_t, std::shared_ptr<const FileLevels>>>
+      recent_;
+
+  // State of the `Stream` prefetch thread, all guarded by `mutex`. `held`
+  // tracks the files loaders hold, which are their current files; `ready`
+  // keeps decoded files up to `kPrefetchFiles` past any of them, plus files
+  // a loader is waiting for in `requested`.
+  struct Prefetch {
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::thread thread;
+    bool stop{false};
+    std::map<std::size_t, std::shared_ptr<const FileLevels>> ready;
+    std::map<std::size_t, std::weak_ptr<const FileLevels>> held;
+    std::set<std::size_t> requested;
+    std::map<std::size_t, std::exception_ptr> errors;
+  };
+  mutable Prefetch prefetch_;
+  void PrefetchLoop() const;
+  // Whether file `i` is within `kPrefetchFiles` after a held file.
+  [[nodiscard]] bool InWindow(std::size_t i) const;
+  // Forgets released files and drops decoded files no loader will need soon.
+  void Evict() const;
+  // A file to decode next, or false if there is none.
+  bool NextToDecode(std::size_t* i) const;
+  // offsets_[i] is the number of levels in the files before file i.
+  mutable std::once_flag counted_;
+  mutable std::vector<std::size_t> offsets_;
+  void CountLevels() const;
+
+  explicit LevelStore(const std::filesystem::path& base_path);
+
+ public:
+  // Files `Stream` decodes ahead of the latest one asked for.
+  static constexpr std::size_t kPrefetchFiles = 4;
+  // Files `Levels` keeps parsed after no loader holds them.
+  static constexpr std::size_t kCachedFiles = 64;
+
+  ~LevelStore();
+  LevelStore(const LevelStore&) = delete;
+  LevelStore& operator=(const LevelStore&) = delete;
+
+  static std::shared_ptr<const LevelStore> Open(
+      const std::filesystem::path& base_path);
+
+  [[nodiscard]] std::size_t NumFiles() const { return paths_.size(); }
+  [[nodiscard]] const std::filesystem::path& Path(std::size_t i) const {
+    return paths_.at(i);
+  }
+  // Levels of file `i` in file order. Memory is bounded by the files callers
+  // hold and `kCachedFiles` others. Thread-safe.
+  std::shared_ptr<const std::vector<SokobanLevel>> Levels(
+      std::size_t i) const;
+  // Levels of file `i`, for loaders that read the files in order. Usually
+  // returns a file the prefetch thread already decoded; memory is bounded by
+  // the files loaders hold and the `kPrefetchFiles` after each, whatever the
+  // number of files. Thread-safe.
+  std::shared_ptr<const std::vector<SokobanLevel>> Stream(
+      std::size_t i) const;
+  // Total number of levels. Parses every file on the first call, keeping
+  // only the counts.
+  [[nodiscard]] std::size_t NumLevels() const;
+  // File and position in it of level `i`, numbered as in `ReadAllLevels`.
+  [[nodiscard]] std::pair<std::size_t, std::size_t> Locate(
+      std::size_t i) const;
+};
+
+/**
+ * Hands out levels to one env. `base_path` is a directory of text level files,
+ * a single text file, or a packed file written by `convert_levels`. Level data
+ * lives in a `LevelStore` or `BinaryLevelFile` shared by the whole process;
+ * the loader itself only keeps a cursor and the visiting order of the current
+ * file.
+ */
 class LevelLoader {
  protected:
   bool load_sequentially_;
@@ -47,22 +150,44 @@ class LevelLoader {
   int levels_loaded_{0};
   int env_id_{0};
   int num_envs_{1};
-  std::vector<std::pair<int, SokobanLevel>> levels_{0};
+  std::shared_ptr<const LevelStore> store_;
+  // Levels of the current file.
+  std::shared_ptr<const std::vector<SokobanLevel>> file_levels_;
+  std::vector<int> level_order_;
   int cur_level_{-1}, cur_level_file_{-1};
-  std::vector<std::filesystem::path> level_file_paths_{0};
-  std::vector<std::filesystem::path>::iterator cur_file_;
+  std::size_t cur_file_{0};
+  std::shared_ptr<const BinaryLevelFile> binary_levels_;
   void LoadFile(std::mt19937& gen);
+  TaggedSokobanLevel GetBinaryLevel(std::mt19937& gen);
 
  public:
   int verbose;
 
   TaggedSokobanLevel GetLevel(std::mt19937& gen);
+  // Level `i` in `ReadAllLevels` order, for a caller choosing levels itself,
+  // such as a `LevelSampler`. Leaves the loader's own cursor alone.
+  TaggedSokobanLevel GetLevelAt(std::size_t i) const;
+  [[nodiscard]] std::size_t NumLevels() const;
   explicit LevelLoader(const std::filesystem::path& base_path,
                        bool load_sequentially, int n_levels_to_load,
                        int env_id = 0, int num_envs = 1, int verbose = 0);
 };
 
 void PrintLevel(std::ostream& os, const SokobanLevel& vec);
+
+// Regular files under `base_path` sorted by name, or `base_path` itself.
+std::vector<std::filesystem::path> ListLevelFiles(
+    const std::filesystem::path& base_path);
+
+// Parses every level of a text level file, in file order.
+std::vector<SokobanLevel> ReadLevelFile(const std::filesystem::path& path);
+
+// Every level under `base_path`, text or packed, in the order a sequential
+// `LevelLoader` with one env visits them. Position in the result is the level
+// number `astar_log` reports.
+std::vector<TaggedSokobanLevel> ReadAllLevels(
+    const std::filesystem::path& base_path);
+
 }  // namespace sokoban
 
 #endif  // ENVPOOL_SOKOBAN_LEVEL_LOADER_H_
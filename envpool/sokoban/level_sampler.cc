@@ -0,0 +1,233 @@
+// Copyright 2023-2024 FAR AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "envpool/sokoban/level_sampler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+namespace sokoban {
+
+SumTree::SumTree(std::size_t size) {
+  while (capacity_ < size) {
+    capacity_ *= 2;
+  }
+  nodes_.assign(2 * capacity_, 0.0);
+}
+
+void SumTree::Set(std::size_t i, double weight) {
+  std::size_t node = capacity_ + i;
+  nodes_[node] = weight;
+  for (node /= 2; node >= 1; node /= 2) {
+    nodes_[node] = nodes_[2 * node] + nodes_[2 * node + 1];
+  }
+}
+
+std::size_t SumTree::Find(double u) const {
+  std::size_t node = 1;
+  while (node < capacity_) {
+    const double left = nodes_[2 * node];
+    // Fall through to the right only onto a non-empty subtree, so rounding
+    // in the sums never lands on a zero-weight leaf.
+    if (u < left || nodes_[2 * node + 1] <= 0.0) {
+      node = 2 * node;
+    } else {
+      u -= left;
+      node = 2 * node + 1;
+    }
+  }
+  return node - capacity_;
+}
+
+SamplerMode ParseSamplerMode(const std::string& mode) {
+  if (mode == "uniform") {
+    return SamplerMode::kUniform;
+  }
+  if (mode == "unsolved") {
+    return SamplerMode::kUnsolved;
+  }
+  if (mode == "learnability") {
+    return SamplerMode::kLearnability;
+  }
+  std::stringstream msg;
+  msg << "Unknown level_sampler '" << mode
+      << "', expected 'uniform', 'unsolved' or 'learnability'." << std::endl;
+  throw std::runtime_error(msg.str());
+}
+
+LevelSampler::LevelSampler(std::string key, SamplerMode mode,
+                           double temperature, std::size_t size,
+                           uint64_t seed)
+    : key_(std::move(key)),
+      mode_(mode),
+      temperature_(temperature),
+      size_(size),
+      stats_(new LevelStats[size]),
+      tree_(size),
+      seed_(seed) {
+  if (size == 0) {
+    throw std::runtime_error("LevelSampler needs at least one level.");
+  }
+  if (!(temperature > 0.0)) {
+    throw std::runtime_error("level_sampler_temperature must be positive.");
+  }
+  for (std::size_t i = 0; i < size_; i++) {
+    tree_.Set(i, Priority(i));
+  }
+}
+
+double LevelSampler::Priority(std::size_t i) const {
+  const LevelStats& stats = stats_[i];
+  const uint32_t episodes = stats.episodes.load(std::memory_order_relaxed);
+  if (episodes == 0 || mode_ == SamplerMode::kUniform) {
+    return 1.0;
+  }
+  const double p =
+      std::min(1.0, static_cast<double>(
+                        stats.solved.load(std::memory_order_relaxed)) /
+                        episodes);
+  const double score = mode_ == SamplerMode::kUnsolved ? 1.0 - p : p * (1 - p);
+  return std::max(std::pow(score, 1.0 / temperature_), kMinPriority);
+}
+
+std::string LevelSampler::Key(const std::filesystem::path& levels_dir,
+                              uint64_t seed, const std::string& id) {
+  return std::filesystem::canonical(levels_dir).string() + "#" +
+         std::to_string(seed) + "#" + id;
+}
+
+namespace {
+
+// Open samplers by key; entries expire with the last env holding them.
+struct SamplerCache {
+  std::mutex mutex;
+  std::map<std::string, std::weak_ptr<LevelSampler>> samplers;
+};
+
+SamplerCache& Cache() {
+  static SamplerCache cache;
+  return cache;
+}
+
+void SeedStream(uint64_t seed, SamplerStream* stream) {
+  std::seed_seq seq{static_cast<uint32_t>(seed),
+                    static_cast<uint32_t>(seed >> 32),
+                    static_cast<uint32_t>(stream->env_id)};
+  stream->gen.seed(seq);
+}
+
+}  // namespace
+
+std::shared_ptr<LevelSampler> LevelSampler::Open(
+    const std::filesystem::path& levels_dir, uint64_t seed,
+    const std::string& id, SamplerMode mode, double temperature,
+    std::size_t size) {
+  std::string key = Key(levels_dir, seed, id);
+  SamplerCache& cache = Cache();
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  auto sampler = cache.samplers[key].lock();
+  if (sampler == nullptr) {
+    sampler = std::shared_ptr<LevelSampler>(
+        new LevelSampler(key, mode, temperature, size, seed));
+    cache.samplers[key] = sampler;
+  } else if (sampler->mode_ != mode || sampler->temperature_ != temperature ||
+             sampler->size_ != size) {
+    std::stringstream msg;
+    msg << "A level sampler for " << key
+        << " is already open with different settings." << std::endl;
+    throw std::runtime_error(msg.str());
+  }
+  return sampler;
+}
+
+std::shared_ptr<LevelSampler> LevelSampler::Find(
+    const std::filesystem::path& levels_dir, uint64_t seed,
+    const std::string& id) {
+  std::string key = Key(levels_dir, seed, id);
+  SamplerCache& cache = Cache();
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  auto it = cache.samplers.find(key);
+  return it == cache.samplers.end() ? nullptr : it->second.lock();
+}
+
+std::vector<double> LevelSampler::Priorities() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<double> priorities(size_);
+  for (std::size_t i = 0; i < size_; i++) {
+    priorities[i] = tree_.Get(i);
+  }
+  return priorities;
+}
+
+SamplerStream LevelSampler::Stream(int env_id) const {
+  SamplerStream stream;
+  stream.env_id = env_id;
+  std::lock_guard<std::mutex> lock(mutex_);
+  SeedStream(seed_, &stream);
+  stream.generation = generation_.load(std::memory_order_relaxed);
+  return stream;
+}
+
+std::size_t LevelSampler::Sample(SamplerStream* stream) {
+  if (stream->generation != generation_.load(std::memory_order_acquire)) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    SeedStream(seed_, stream);
+    stream->generation = generation_.load(std::memory_order_relaxed);
+  }
+  // Draw outside the lock, so the env's stream alone decides its levels.
+  const double u =
+      std::uniform_real_distribution<double>(0.0, 1.0)(stream->gen);
+  std::lock_guard<std::mutex> lock(mutex_);
+  return std::min(tree_.Find(u * tree_.Total()), size_ - 1);
+}
+
+void LevelSampler::Record(std::size_t i, bool solved, int steps,
+                          double episode_return) {
+  LevelStats& stats = stats_[i];
+  stats.episodes.fetch_add(1, std::memory_order_relaxed);
+  stats.solved.fetch_add(solved ? 1 : 0, std::memory_order_relaxed);
+  stats.steps.fetch_add(steps, std::memory_order_relaxed);
+  double sum = stats.return_sum.load(std::memory_order_relaxed);
+  while (!stats.return_sum.compare_exchange_weak(
+      sum, sum + episode_return, std::memory_order_relaxed)) {
+  }
+  // Recompute under the lock, so the last of two racing records of one level
+  // leaves the priority of both.
+  std::lock_guard<std::mutex> lock(mutex_);
+  tree_.Set(i, Priority(i));
+}
+
+void LevelSampler::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (std::size_t i = 0; i < size_; i++) {
+    LevelStats& stats = stats_[i];
+    stats.episodes.store(0, std::memory_order_relaxed);
+    stats.solved.store(0, std::memory_order_relaxed);
+    stats.steps.store(0, std::memory_order_relaxed);
+    stats.return_sum.store(0.0, std::memory_order_relaxed);
+    tree_.Set(i, Priority(i));
+  }
+}
+
+void LevelSampler::Reseed(uint64_t seed) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  seed_ = seed;
+  generation_.fetch_add(1, std::memory_order_release);
+}
+
+}  // namespace sokoban
@@ -0,0 +1,157 @@
+/*
+ * Copyright 2023-2024 FAR AI
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ENVPOOL_SOKOBAN_LEVEL_SAMPLER_H_
+#define ENVPOOL_SOKOBAN_LEVEL_SAMPLER_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace sokoban {
+
+/**
+ * Complete binary tree of non-negative weights whose inner nodes hold the sum
+ * of their children, so a weight can be changed and an index drawn with
+ * probability proportional to its weight in O(log n).
+ */
+class SumTree {
+ protected:
+  std::size_t capacity_{1};  // leaves, a power of two
+  std::vector<double> nodes_;  // nodes_[1] is the root, leaves at capacity_
+
+ public:
+  explicit SumTree(std::size_t size);
+
+  [[nodiscard]] double Total() const { return nodes_[1]; }
+  [[nodiscard]] double Get(std::size_t i) const {
+    return nodes_[capacity_ + i];
+  }
+  void Set(std::size_t i, double weight);
+  // Index of the leaf whose weight interval contains `u`, for `u` in
+  // [0, Total()).
+  [[nodiscard]] std::size_t Find(double u) const;
+};
+
+enum class SamplerMode {
+  kUniform,       // every level equally often
+  kUnsolved,      // 1 - solve rate
+  kLearnability,  // p * (1 - p), p the solve rate, as in PLR-style curricula
+};
+
+SamplerMode ParseSamplerMode(const std::string& mode);
+
+/**
+ * Outcomes of the finished episodes of one level. Every field is updated
+ * with relaxed atomics, so envs on different threads record without locking.
+ */
+struct LevelStats {
+  std::atomic<uint32_t> episodes{0};
+  std::atomic<uint32_t> solved{0};
+  std::atomic<uint64_t> steps{0};
+  std::atomic<double> return_sum{0.0};
+};
+
+/**
+ * The random stream one env draws its levels from, see
+ * `LevelSampler::Stream`.
+ */
+struct SamplerStream {
+  std::mt19937 gen;
+  int env_id{0};
+  uint64_t generation{0};  // the sampler's reseed count `gen` started from
+};
+
+/**
+ * Pool-wide level curriculum. Levels are numbered as in `ReadAllLevels`, and
+ * level `i` is drawn with probability proportional to its priority,
+ * `max(score_i ^ (1 / temperature), kMinPriority)`, where the score depends
+ * on the mode and is 1 for a level with no finished episode yet, so every
+ * level is tried before the curriculum narrows.
+ *
+ * One sampler is shared by all envs opened with the same levels, seed and
+ * sampler id in this process, which is how Python finds it again through
+ * `Find`. Each env draws from its own stream, seeded from the sampler's seed
+ * and the env id, so with uniform sampling a pool's level sequence depends
+ * only on its seed; the other modes also depend on the order in which
+ * episodes are recorded. `Reseed` restarts every env's stream from a new
+ * seed.
+ */
+class LevelSampler {
+ protected:
+  std::string key_;
+  SamplerMode mode_;
+  double temperature_;
+  std::size_t size_;
+  std::unique_ptr<LevelStats[]> stats_;
+
+  mutable std::mutex mutex_;  // guards tree_ and seed_
+  SumTree tree_;
+  uint64_t seed_;
+  std::atomic<uint64_t> generation_{0};  // number of `Reseed` calls
+
+  LevelSampler(std::string key, SamplerMode mode, double temperature,
+               std::size_t size, uint64_t seed);
+  [[nodiscard]] double Priority(std::size_t i) const;
+
+  static std::string Key(const std::filesystem::path& levels_dir,
+                         uint64_t seed, const std::string& id);
+
+ public:
+  static constexpr double kMinPriority = 1e-3;
+
+  // Returns the sampler of `levels_dir`, `seed` and `id`, creating it over
+  // the first `size` levels. Throws if it exists with different settings.
+  static std::shared_ptr<LevelSampler> Open(
+      const std::filesystem::path& levels_dir, uint64_t seed,
+      const std::string& id, SamplerMode mode, double temperature,
+      std::size_t size);
+  // The live sampler of `levels_dir`, `seed` and `id`, or null.
+  static std::shared_ptr<LevelSampler> Find(
+      const std::filesystem::path& levels_dir, uint64_t seed,
+      const std::string& id);
+
+  [[nodiscard]] std::size_t Size() const { return size_; }
+  [[nodiscard]] SamplerMode Mode() const { return mode_; }
+  [[nodiscard]] const LevelStats& Stats(std::size_t i) const {
+    return stats_[i];
+  }
+  // Current sampling weight of every level.
+  [[nodiscard]] std::vector<double> Priorities() const;
+
+  // A new stream for env `env_id`, starting from the current seed.
+  [[nodiscard]] SamplerStream Stream(int env_id) const;
+  // Draws a level with randomness from the calling env's `stream`, which
+  // first restarts from the current seed if `Reseed` was called since it
+  // last did.
+  std::size_t Sample(SamplerStream* stream);
+  void Record(std::size_t i, bool solved, int steps, double episode_return);
+  // Forgets all outcomes, so every level is unseen again.
+  void Clear();
+  // Restarts the stream of every env from `seed` at its next draw; outcomes
+  // are kept. Reseeding with the pool's seed replays its uniform levels.
+  void Reseed(uint64_t seed);
+};
+
+}  // namespace sokoban
+
+#endif  // ENVPOOL_SOKOBAN_LEVEL_SAMPLER_H_
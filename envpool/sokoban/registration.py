@@ -25,3 +25,15 @@ register(
   reward_step=-0.1,
   max_num_players=1,
 )
+
+register(
+  task_id="SokobanBatch-v0",
+  import_path="envpool.sokoban",
+  spec_cls="SokobanBatchEnvSpec",
+  dm_cls="SokobanBatchDMEnvPool",
+  gym_cls="SokobanBatchGymEnvPool",
+  gymnasium_cls="SokobanBatchGymnasiumEnvPool",
+  max_episode_steps=60,
+  reward_step=-0.1,
+  max_num_players=1,
+)
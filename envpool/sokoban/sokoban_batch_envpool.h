@@ -0,0 +1,495 @@
+/*
+ * Copyright 2023-2024 FAR AI
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ENVPOOL_SOKOBAN_SOKOBAN_BATCH_ENVPOOL_H_
+#define ENVPOOL_SOKOBAN_SOKOBAN_BATCH_ENVPOOL_H_
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "envpool/core/array.h"
+#include "envpool/core/envpool.h"
+#include "envpool/core/serialization.h"
+#include "envpool/sokoban/level_sampler.h"
+#include "envpool/sokoban/sokoban_envpool.h"
+#include "envpool/sokoban/sokoban_world.h"
+#include "envpool/sokoban/solution_index.h"
+#include "envpool/sokoban/utils.h"
+
+namespace sokoban {
+
+// Same config, state and action as `SokobanEnvFns`; a separate type so that
+// both pools can be registered with Python.
+class SokobanBatchEnvFns : public SokobanEnvFns {};
+
+using SokobanBatchEnvSpec = EnvSpec<SokobanBatchEnvFns>;
+
+/**
+ * Sokoban pool without per-env objects. All envs live in struct-of-arrays
+ * storage (one padded grid per env in a single buffer, plus counters), and
+ * each worker thread steps one contiguous chunk of the batch and writes its
+ * rows of the output arrays directly, with no action parsing, state dicts or
+ * virtual calls per env.
+ *
+ * Given the same config it produces exactly the states of `SokobanEnvPool` in
+ * synchronous mode, which is the only mode it supports: `batch_size` must be
+ * `num_envs`, and every `Send` or `Reset` must be followed by one `Recv`,
+ * which returns the states of the envs passed in, in that order.
+ */
+class SokobanBatchEnvPool : public EnvPool<SokobanBatchEnvSpec> {
+ protected:
+  int num_envs_;
+  int dim_room_, stride_, grid_size_;
+  double reward_finished_, reward_box_, reward_step_;
+  int min_episode_steps_, max_episode_steps_;
+  ObsMode obs_mode_;
+  std::size_t obs_size_;
+  std::shared_ptr<const SolutionIndex> solution_index_;
+  std::shared_ptr<LevelSampler> sampler_;
+
+  // Per-env state, indexed by env id.
+  std::vector<std::unique_ptr<LevelLoader>> level_loaders_;
+  std::vector<std::mt19937> gens_;
+  std::vector<uint8_t> cells_;  // num_envs x grid_size_
+  std::vector<int> player_, unmatched_boxes_;
+  std::vector<int> episode_step_, episode_max_steps_, elapsed_step_;
+  std::vector<int> level_file_idx_, level_idx_;
+  std::vector<SolutionIndex::Solution> solutions_;
+  std::vector<uint8_t> on_solution_;
+  std::vector<SamplerStream> sample_streams_;  // empty without a sampler
+  std::vector<int64_t> sample_idx_;
+  std::vector<double> episode_return_;
+
+  // The batch in flight: env ids, their actions (unused for a reset) and the
+  // output arrays the workers fill.
+  std::vector<int> batch_env_ids_, batch_actions_;
+  bool batch_reset_{false};
+  bool batch_pending_{false};
+  std::vector<Array> batch_state_;
+
+  std::size_t num_workers_{1};
+  std::vector<std::thread> workers_;
+  std::mutex mutex_;
+  std::condition_variable work_cv_, done_cv_;
+  uint64_t generation_{0};
+  std::size_t chunks_done_{0};
+  bool stop_{false};
+
+  [[nodiscard]] uint8_t* Grid(int env_id) {
+    return cells_.data() + static_cast<std::size_t>(env_id) * grid_size_;
+  }
+
+  [[nodiscard]] bool IsDone(int env_id) const {
+    return unmatched_boxes_[env_id] == 0 ||
+           episode_step_[env_id] >= episode_max_steps_[env_id];
+  }
+
+  void FindSolution(int env_id) {
+    solutions_[env_id] =
+        solution_index_ == nullptr
+            ? SolutionIndex::Solution{}
+            : solution_index_->Find(level_file_idx_[env_id],
+                                    level_idx_[env_id]);
+    on_solution_[env_id] = solutions_[env_id].actions != nullptr;
+  }
+
+  // Mirrors `SokobanEnv::ResetWithoutWrite`.
+  void LoadLevel(int env_id) {
+    std::mt19937& gen = gens_[env_id];
+    episode_max_steps_[env_id] =
+        SafeUniformInt(min_episode_steps_, max_episode_steps_, gen);
+    TaggedSokobanLevel level;
+    if (sampler_ != nullptr) {
+      sample_idx_[env_id] =
+          static_cast<int64_t>(sampler_->Sample(&sample_streams_[env_id]));
+      level = level_loaders_[env_id]->GetLevelAt(sample_idx_[env_id]);
+    } else {
+      level = level_loaders_[env_id]->GetLevel(gen);
+    }
+    LoadGrid(level.data, dim_room_, Grid(env_id), &player_[env_id],
+             &unmatched_boxes_[env_id]);
+    level_file_idx_[env_id] = level.file_idx;
+    level_idx_[env_id] = level.level_idx;
+    episode_step_[env_id] = 0;
+    episode_return_[env_id] = 0.0;
+    FindSolution(env_id);
+  }
+
+  // Mirrors `SokobanEnv::RecordEpisode`.
+  void RecordEpisode(int env_id) {
+    if (sampler_ != nullptr && sample_idx_[env_id] >= 0) {
+      sampler_->Record(sample_idx_[env_id], unmatched_boxes_[env_id] == 0,
+                       episode_step_[env_id], episode_return_[env_id]);
+    }
+  }
+
+  // Output columns of one chunk, in state spec order.
+  struct Columns {
+    int* env_id;
+    int* players_env_id;
+    int* elapsed_step;
+    bool* done;
+    float* reward;
+    float* discount;
+    int* step_type;
+    bool* trunc;
+    uint8_t* obs;
+    int* level_file_idx;
+    int* level_idx;
+    int* optimal_length;
+    int* next_optimal_action;
+  };
+
+  // Mirrors `SokobanEnv::WriteState`, with `Env::Allocate` for the common
+  // fields, into row `row` of the batch.
+  void WriteState(int env_id, std::size_t row, float reward,
+                  const Columns& out) {
+    const bool done = IsDone(env_id);
+    const int elapsed_step = elapsed_step_[env_id];
+    out.env_id[row] = env_id;
+    out.players_env_id[row] = env_id;
+    out.elapsed_step[row] = elapsed_step;
+    out.done[row] = done;
+    out.reward[row] = reward;
+    out.discount[row] = static_cast<float>(!done);
+    out.step_type[row] = elapsed_step == 0 ? 0 : done ? 2 : 1;
+    // A solved level is never truncated; an unsolved one only ends by time.
+    out.trunc[row] = done && unmatched_boxes_[env_id] != 0;
+    if (done) {
+      RecordEpisode(env_id);
+      LoadLevel(env_id);
+    }
+    RenderGrid(obs_mode_, Grid(env_id), dim_room_, out.obs + row * obs_size_);
+    out.level_file_idx[row] = level_file_idx_[env_id];
+    out.level_idx[row] = level_idx_[env_id];
+    const SolutionIndex::Solution& solution = solutions_[env_id];
+    const int step = episode_step_[env_id];
+    out.optimal_length[row] = solution.length;
+    out.next_optimal_action[row] =
+        on_solution_[env_id] != 0 && step < solution.length
+            ? static_cast<int>(solution.actions[step])
+            : -1;
+  }
+
+  // Mirrors `SokobanEnv::Step`.
+  void StepEnv(int env_id, int action, std::size_t row, const Columns& out) {
+    elapsed_step_[env_id]++;
+    if (action < 0) {
+      // Sneaky noop, see `SokobanEnv::Step`.
+      WriteState(env_id, row, std::numeric_limits<float>::signaling_NaN(),
+                 out);
+      return;
+    }
+    int& step = episode_step_[env_id];
+    if (on_solution_[env_id] != 0) {
+      const SolutionIndex::Solution& solution = solutions_[env_id];
+      on_solution_[env_id] =
+          step < solution.length && action == solution.actions[step];
+    }
+    step++;
+    const int prev_unmatched_boxes = unmatched_boxes_[env_id];
+    StepGrid(action, stride_, Grid(env_id), &player_[env_id],
+             &unmatched_boxes_[env_id]);
+    const int unmatched_boxes = unmatched_boxes_[env_id];
+    const double reward =
+        reward_step_ +
+        reward_box_ *
+            static_cast<double>(prev_unmatched_boxes - unmatched_boxes) +
+        ((unmatched_boxes == 0) ? reward_finished_ : 0.0f);
+    episode_return_[env_id] += reward;
+    WriteState(env_id, row, static_cast<float>(reward), out);
+  }
+
+  void RunChunk(std::size_t begin, std::size_t end) {
+    State state(&batch_state_);
+    const Columns out{
+        static_cast<int*>(state["info:env_id"_].Data()),
+        static_cast<int*>(state["info:players.env_id"_].Data()),
+        static_cast<int*>(state["elapsed_step"_].Data()),
+        static_cast<bool*>(state["done"_].Data()),
+        static_cast<float*>(state["reward"_].Data()),
+        static_cast<float*>(state["discount"_].Data()),
+        static_cast<int*>(state["step_type"_].Data()),
+        static_cast<bool*>(state["trunc"_].Data()),
+        static_cast<uint8_t*>(state["obs"_].Data()),
+        static_cast<int*>(state["info:level_file_idx"_].Data()),
+        static_cast<int*>(state["info:level_idx"_].Data()),
+        static_cast<int*>(state["info:optimal_length"_].Data()),
+        static_cast<int*>(state["info:next_optimal_action"_].Data()),
+    };
+    for (std::size_t row = begin; row < end; ++row) {
+      const int env_id = batch_env_ids_[row];
+      if (batch_reset_ || IsDone(env_id)) {
+        elapsed_step_[env_id] = 0;
+        LoadLevel(env_id);
+        WriteState(env_id, row, 0.0f, out);
+      } else {
+        StepEnv(env_id, batch_actions_[row], row, out);
+      }
+    }
+  }
+
+  void WorkerLoop(std::size_t worker) {
+    uint64_t seen = 0;
+    for (;;) {
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        work_cv_.wait(lock, [&] { return stop_ || generation_ != seen; });
+        if (stop_) {
+          return;
+        }
+        seen = generation_;
+      }
+      const std::size_t n = batch_env_ids_.size();
+      RunChunk(n * worker / num_workers_, n * (worker + 1) / num_workers_);
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (++chunks_done_ == num_workers_) {
+          done_cv_.notify_one();
+        }
+      }
+    }
+  }
+
+  void StartBatch(const Array& env_ids, const int* actions, bool reset) {
+    if (batch_pending_) {
+      throw std::runtime_error(
+          "SokobanBatchEnvPool: call recv before the next send or reset.");
+    }
+    TArray<int> tenv_ids(env_ids);
+    const std::size_t n = tenv_ids.Shape(0);
+    batch_env_ids_.resize(n);
+    batch_actions_.resize(n);
+    for (std::size_t i = 0; i < n; ++i) {
+      const int env_id = tenv_ids[i];
+      if (env_id < 0 || env_id >= num_envs_) {
+        std::stringstream msg;
+        msg << "env_id " << env_id << " out of range [0, " << num_envs_ << ")."
+            << std::endl;
+        throw std::runtime_error(msg.str());
+      }
+      batch_env_ids_[i] = env_id;
+      batch_actions_[i] = reset ? 0 : actions[i];
+    }
+    std::vector<ShapeSpec> specs =
+        spec.state_spec.template AllValues<ShapeSpec>();
+    for (auto& s : specs) {
+      if (!s.shape.empty() && s.shape[0] == -1) {
+        s.shape[0] = static_cast<int>(n);
+      } else {
+        s = s.Batch(static_cast<int>(n));
+      }
+    }
+    batch_state_ = MakeArray(specs);
+    batch_reset_ = reset;
+    batch_pending_ = true;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      chunks_done_ = 0;
+      generation_++;
+    }
+    work_cv_.notify_all();
+  }
+
+  void SendImpl(const std::vector<Array>& action) {
+    // Actions are env_id, players.env_id, then the spec's own "action".
+    StartBatch(action[0], static_cast<const int*>(action[2].Data()), false);
+  }
+
+ public:
+  explicit SokobanBatchEnvPool(const Spec& spec)
+      : EnvPool<SokobanBatchEnvSpec>(spec),
+        num_envs_(spec.config["num_envs"_]),
+        dim_room_(spec.config["dim_room"_]),
+        stride_(dim_room_ + 2),
+        grid_size_(stride_ * stride_),
+        reward_finished_(spec.config["reward_finished"_]),
+        reward_box_(spec.config["reward_box"_]),
+        reward_step_(spec.config["reward_step"_]),
+        min_episode_steps_(spec.config["min_episode_steps"_]),
+        max_episode_steps_(spec.config["max_episode_steps"_]),
+        obs_mode_(ParseObsMode(spec.config["obs_mode"_])),
+        cells_(static_cast<std::size_t>(num_envs_) * grid_size_, kWall),
+        player_(num_envs_),
+        unmatched_boxes_(num_envs_),
+        episode_step_(num_envs_),
+        episode_max_steps_(num_envs_),
+        elapsed_step_(num_envs_, -1),
+        level_file_idx_(num_envs_, -1),
+        level_idx_(num_envs_, -1),
+        solutions_(num_envs_),
+        on_solution_(num_envs_),
+        sample_idx_(num_envs_, -1),
+        episode_return_(num_envs_) {
+    if (spec.config["batch_size"_] != num_envs_ ||
+        spec.config["max_num_players"_] != 1) {
+      throw std::runtime_error(
+          "SokobanBatchEnvPool needs batch_size == num_envs and a single "
+          "player.");
+    }
+    obs_size_ = 1;
+    for (int dim : ObsShape(obs_mode_, dim_room_)) {
+      obs_size_ *= dim;
+    }
+    const std::string solutions_path = spec.config["solutions_path"_];
+    if (!solutions_path.empty()) {
+      solution_index_ = SolutionIndex::Open(solutions_path);
+    }
+    const std::string levels_dir = spec.config["levels_dir"_];
+    const int verbose = spec.config["verbose"_];
+    for (int i = 0; i < num_envs_; ++i) {
+      gens_.emplace_back(spec.config["seed"_] + i);
+      level_loaders_.emplace_back(std::make_unique<LevelLoader>(
+          levels_dir, spec.config["load_sequentially"_],
+          static_cast<int>(spec.config["n_levels_to_load"_]), i, num_envs_,
+          verbose));
+    }
+    sampler_ = OpenLevelSampler(spec.config, *level_loaders_[0]);
+    if (sampler_ != nullptr) {
+      for (int i = 0; i < num_envs_; ++i) {
+        sample_streams_.push_back(sampler_->Stream(i));
+      }
+    }
+
+    std::size_t num_threads = spec.config["num_threads"_];
+    if (num_threads == 0) {
+      num_threads = std::min<std::size_t>(num_envs_,
+                                          std::thread::hardware_concurrency());
+    }
+    num_workers_ = std::max<std::size_t>(num_threads, 1);
+    for (std::size_t i = 0; i < num_workers_; ++i) {
+      workers_.emplace_back([this, i] { WorkerLoop(i); });
+    }
+    if (spec.config["thread_affinity_offset"_] >= 0) {
+      std::size_t processor_count = std::thread::hardware_concurrency();
+      std::size_t thread_affinity_offset =
+          spec.config["thread_affinity_offset"_];
+      for (std::size_t tid = 0; tid < num_workers_; ++tid) {
+        cpu_set_t cpuset;
+        CPU_ZERO(&cpuset);
+        std::size_t cid = (thread_affinity_offset + tid) % processor_count;
+        CPU_SET(cid, &cpuset);
+        pthread_setaffinity_np(workers_[tid].native_handle(), sizeof(cpu_set_t),
+                               &cpuset);
+      }
+    }
+  }
+
+  ~SokobanBatchEnvPool() override {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    work_cv_.notify_all();
+    for (auto& worker : workers_) {
+      worker.join();
+    }
+  }
+
+  void Send(const std::vector<Array>& action) override { SendImpl(action); }
+  void Send(std::vector<Array>&& action) override { SendImpl(action); }
+
+  void Reset(const Array& env_ids) override {
+    StartBatch(env_ids, nullptr, true);
+  }
+
+  std::vector<Array> Recv() override {
+    if (!batch_pending_) {
+      throw std::runtime_error(
+          "SokobanBatchEnvPool: recv called without a send or reset.");
+    }
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      done_cv_.wait(lock, [&] { return chunks_done_ == num_workers_; });
+    }
+    batch_pending_ = false;
+    return std::move(batch_state_);
+  }
+
+  /**
+   * Snapshots use the `SokobanEnv` format, so they can be restored into
+   * either pool. Same caveats as `AsyncEnvPool::Snapshot`.
+   */
+  std::vector<std::vector<uint8_t>> Snapshot(const Array& env_ids) override {
+    TArray<int> tenv_ids(env_ids);
+    std::vector<std::vector<uint8_t>> snapshots(tenv_ids.Shape(0));
+    for (std::size_t i = 0; i < snapshots.size(); ++i) {
+      const int env_id = tenv_ids[i];
+      ByteWriter writer(&snapshots[i]);
+      writer.Write(elapsed_step_[env_id]);
+      writer.Write(level_file_idx_[env_id]);
+      writer.Write(level_idx_[env_id]);
+      writer.Write(episode_max_steps_[env_id]);
+      writer.Write(episode_step_[env_id]);
+      writer.Write(on_solution_[env_id] != 0);
+      writer.Write(player_[env_id] % stride_ - 1);
+      writer.Write(player_[env_id] / stride_ - 1);
+      writer.Write(unmatched_boxes_[env_id]);
+      for (int y = 0; y < dim_room_; ++y) {
+        writer.WriteArray(Grid(env_id) + (y + 1) * stride_ + 1, dim_room_);
+      }
+    }
+    return snapshots;
+  }
+
+  void Restore(const Array& env_ids,
+               const std::vector<std::vector<uint8_t>>& snapshots) override {
+    TArray<int> tenv_ids(env_ids);
+    if (static_cast<std::size_t>(tenv_ids.Shape(0)) != snapshots.size()) {
+      throw std::runtime_error("env_ids and snapshots have different sizes.");
+    }
+    for (std::size_t i = 0; i < snapshots.size(); ++i) {
+      const int env_id = tenv_ids[i];
+      ByteReader reader(snapshots[i].data(), snapshots[i].size());
+      reader.Read(&elapsed_step_[env_id]);
+      reader.Read(&level_file_idx_[env_id]);
+      reader.Read(&level_idx_[env_id]);
+      reader.Read(&episode_max_steps_[env_id]);
+      reader.Read(&episode_step_[env_id]);
+      const bool on_solution = reader.Read<bool>();
+      // Decode into a scratch world, which validates the grid.
+      SokobanWorld world(dim_room_);
+      world.Deserialize(&reader);
+      reader.CheckEnd();
+      for (int y = 0; y < dim_room_; ++y) {
+        for (int x = 0; x < dim_room_; ++x) {
+          Grid(env_id)[(y + 1) * stride_ + x + 1] = world.At(x, y);
+        }
+      }
+      player_[env_id] = (world.PlayerY() + 1) * stride_ + world.PlayerX() + 1;
+      unmatched_boxes_[env_id] = world.UnmatchedBoxes();
+      FindSolution(env_id);
+      on_solution_[env_id] = on_solution && on_solution_[env_id] != 0;
+      sample_idx_[env_id] = -1;
+      episode_return_[env_id] = 0.0;
+    }
+  }
+};
+
+}  // namespace sokoban
+
+#endif  // ENVPOOL_SOKOBAN_SOKOBAN_BATCH_ENVPOOL_H_
@@ -14,15 +14,16 @@
 
 #include "envpool/sokoban/sokoban_envpool.h"
 
-#include <array>
-#include <iostream>
+#include <atomic>
+#include <cstdint>
 #include <limits>
 #include <sstream>
 #include <stdexcept>
-#include <utility>
 #include <vector>
 
 #include "envpool/core/py_envpool.h"
+#include "envpool/sokoban/level_sampler.h"
+#include "envpool/sokoban/sokoban_batch_envpool.h"
 #include "envpool/sokoban/utils.h"
 
 namespace sokoban {
@@ -33,32 +34,33 @@ void SokobanEnv::ResetWithoutWrite() {
   current_max_episode_steps_ =
       SafeUniformInt(min_episode_steps, max_episode_steps, gen_);
 
-  TaggedSokobanLevel level = level_loader_.GetLevel(gen_);
-  world_ = level.data;
+  TaggedSokobanLevel level;
+  if (sampler_ != nullptr) {
+    sample_idx_ = static_cast<int64_t>(sampler_->Sample(&sample_stream_));
+    level = level_loader_.GetLevelAt(sample_idx_);
+  } else {
+    level = level_loader_.GetLevel(gen_);
+  }
+  world_.Load(level.data);
   level_idx_ = level.level_idx;
   level_file_idx_ = level.file_idx;
+  current_step_ = 0;
+  episode_return_ = 0.0;
+  FindSolution();
+}
 
-  if (world_.size() != dim_room_ * dim_room_) {
-    std::stringstream msg;
-    msg << "Loaded level is not dim_room x dim_room. world_.size()="
-        << world_.size() << ", dim_room_=" << dim_room_ << std::endl;
-    throw std::runtime_error(msg.str());
-  }
-  unmatched_boxes_ = 0;
-  for (int x = 0; x < dim_room_; x++) {
-    for (int y = 0; y < dim_room_; y++) {
-      switch (WorldAt(x, y)) {
-        case kPlayer:
-          player_x_ = x;
-          player_y_ = y;
-          break;
-        case kBox:
-          unmatched_boxes_++;
-          break;
-      }
-    }
+void SokobanEnv::RecordEpisode() {
+  if (sampler_ != nullptr && sample_idx_ >= 0) {
+    sampler_->Record(sample_idx_, world_.UnmatchedBoxes() == 0, current_step_,
+                     episode_return_);
   }
-  current_step_ = 0;
+}
+
+void SokobanEnv::FindSolution() {
+  solution_ = solutions_ == nullptr
+                  ? SolutionIndex::Solution{}
+                  : solutions_->Find(level_file_idx_, level_idx_);
+  on_solution_ = solution_.actions != nullptr;
 }
 
 void SokobanEnv::Reset() {
@@ -66,22 +68,6 @@ void SokobanEnv::Reset() {
   WriteState(0.0f);
 }
 
-[[nodiscard]] uint8_t SokobanEnv::WorldAt(int x, int y) const {
-  if ((x < 0) || (x >= dim_room_) || (y < 0) || (y >= dim_room_)) {
-    return kWall;
-  }
-  return world_.at(x + y * dim_room_);
-}
-void SokobanEnv::WorldAssignAt(int x, int y, uint8_t value) {
-  if ((x < 0) || (x >= dim_room_) || (y < 0) || (y >= dim_room_)) {
-    return;
-  }
-  world_.at(x + y * dim_room_) = value;
-}
-
-constexpr std::array<std::array<int, 2>, 4> kChangeCoordinates = {
-    {{0, -1}, {0, 1}, {-1, 0}, {1, 0}}};
-
 void SokobanEnv::Step(const Action& action_dict) {
   const int action = action_dict["action"_];
   // Sneaky Noop action
@@ -93,90 +79,52 @@ void SokobanEnv::Step(const Action& action_dict) {
     return;
   }
 
-  current_step_++;
-  const int change_coordinates_idx = action;
-  const int delta_x = kChangeCoordinates.at(change_coordinates_idx).at(0);
-  const int delta_y = kChangeCoordinates.at(change_coordinates_idx).at(1);
-
-  const int prev_unmatched_boxes = unmatched_boxes_;
-
-  // Arena: the things that will change if the agent moves
-  std::array<uint8_t, 3> arena;
-  for (size_t i = 0; i < arena.size(); i++) {
-    arena.at(i) = WorldAt(player_x_ + delta_x * i, player_y_ + delta_y * i);
-  }
-
-  // The box will move IFF action is a pushing action AND there's a box AND it
-  // has space to move
-  const bool box_moves =
-      ((action <= kActPushRight) &&
-       ((arena.at(1) == kBox) || (arena.at(1) == kBoxOnTarget)) &&
-       ((arena.at(2) == kEmpty) || (arena.at(2) == kTarget)));
-
-  // The agent will move if the next arena location is possible to move into, or
-  // if it's a box and the box moves
-  const bool is_a_box_and_the_box_moves = box_moves;
-  const bool agent_moves = (arena.at(1) == kEmpty) ||
-                           (arena.at(1) == kTarget) ||
-                           is_a_box_and_the_box_moves;
-
-  if (agent_moves) {
-    std::array<bool, arena.size()> is_target;
-    for (size_t i = 0; i < arena.size(); i++) {
-      uint8_t tile = arena.at(i);
-      is_target.at(i) =
-          (tile == kBoxOnTarget || tile == kTarget || tile == kPlayerOnTarget);
-    }
-    // only whatever was on the floor is now at position 0
-    arena.at(0) = is_target.at(0) ? kTarget : kEmpty;
-    // the player now occupies position 1
-    arena.at(1) = is_target.at(1) ? kPlayerOnTarget : kPlayer;
-
-    if (box_moves) {
-      // the box moves for sure. A target at 2 reduces the nubmer of unmatched
-      // boxes (because the box goes there), a target at 1 increases it (the box
-      // leaves from there). Both can be equal to 1 and in that case the number
-      // stays the same.
-      //
-      // Implicit conversion from bool to int is always 0/1.
-      // https://en.cppreference.com/w/cpp/language/implicit_conversion
-      unmatched_boxes_ +=
-          static_cast<int>(is_target.at(1)) - static_cast<int>(is_target.at(2));
-
-      // A box now occupies position 2
-      arena.at(2) = is_target.at(2) ? kBoxOnTarget : kBox;
-    }
-
-    for (size_t i = 0; i < arena.size(); i++) {
-      WorldAssignAt(player_x_ + delta_x * i, player_y_ + delta_y * i,
-                    arena.at(i));
-    }
-    // After assigning the arena, move player.
-    player_x_ += delta_x;
-    player_y_ += delta_y;
+  if (on_solution_) {
+    on_solution_ = current_step_ < solution_.length &&
+                   action == solution_.actions[current_step_];
   }
+  current_step_++;
+  const int prev_unmatched_boxes = world_.UnmatchedBoxes();
+  world_.Step(action);
+  const int unmatched_boxes = world_.UnmatchedBoxes();
 
   const double reward = reward_step_ +
                         reward_box_ * static_cast<double>(prev_unmatched_boxes -
-                                                          unmatched_boxes_) +
-                        ((unmatched_boxes_ == 0) ? reward_finished_ : 0.0f);
+                                                          unmatched_boxes) +
+                        ((unmatched_boxes == 0) ? reward_finished_ : 0.0f);
+  episode_return_ += reward;
 
   WriteState(static_cast<float>(reward));
 }
 
-constexpr std::array<std::array<uint8_t, 3>, kPlayerOnTarget + 1> kTinyColors{{
-    {0, 0, 0},        // WALL
-    {243, 248, 238},  // EMPTY
-    {254, 126, 125},  // TARGET
-    {254, 95, 56},    // BOX_ON_TARGET
-    {142, 121, 56},   // BOX
-    {160, 212, 56},   // PLAYER
-    {219, 212, 56}    // PLAYER_ON_TARGET
-}};
+void SokobanEnv::Serialize(ByteWriter* writer) {
+  writer->Write(level_file_idx_);
+  writer->Write(level_idx_);
+  writer->Write(current_max_episode_steps_);
+  writer->Write(current_step_);
+  writer->Write(on_solution_);
+  world_.Serialize(writer);
+}
+
+void SokobanEnv::Deserialize(ByteReader* reader) {
+  reader->Read(&level_file_idx_);
+  reader->Read(&level_idx_);
+  reader->Read(&current_max_episode_steps_);
+  reader->Read(&current_step_);
+  bool on_solution;
+  reader->Read(&on_solution);
+  world_.Deserialize(reader);
+  FindSolution();
+  on_solution_ = on_solution && solution_.actions != nullptr;
+  // Snapshots carry no curriculum state; the restored episode is not
+  // reported to the level sampler.
+  sample_idx_ = -1;
+  episode_return_ = 0.0;
+}
 
 void SokobanEnv::WriteState(float reward) {
   auto state = Allocate();
-  if (unmatched_boxes_ == 0) {
+  if (world_.UnmatchedBoxes() == 0) {
     // Never mark the episode as truncated if we're getting the big final
     // reward.
     state["trunc"_] = false;
@@ -188,10 +136,14 @@ void SokobanEnv::WriteState(float reward) {
 
   state["reward"_] = reward;
   Array& obs = state["obs"_];
-  if (obs.size != 3 * world_.size()) {
+  std::size_t obs_size = 1;
+  for (int dim : ObsShape(obs_mode_, dim_room_)) {
+    obs_size *= dim;
+  }
+  if (obs.size != obs_size) {
     std::stringstream msg;
     msg << "Obs size and level size are different: obs_size=" << obs.size
-        << "/3, level_size=" << world_.size() << ", dim_room=" << dim_room_
+        << ", expected=" << obs_size << ", dim_room=" << dim_room_
         << std::endl;
     throw std::runtime_error(msg.str());
   }
@@ -199,20 +151,19 @@ void SokobanEnv::WriteState(float reward) {
   if (IsDone()) {
     // If this episode truncates or terminates, the observation should be the
     // one for the next episode.
+    RecordEpisode();
     ResetWithoutWrite();
   }
 
-  std::vector<uint8_t> out(3 * world_.size());
-  for (int rgb = 0; rgb < 3; rgb++) {
-    for (size_t i = 0; i < world_.size(); i++) {
-      out.at(rgb * (dim_room_ * dim_room_) + i) =
-          kTinyColors.at(world_.at(i)).at(rgb);
-    }
-  }
-  obs.Assign(out.data(), out.size());
+  world_.Render(obs_mode_, static_cast<uint8_t*>(obs.Data()));
 
   state["info:level_file_idx"_] = level_file_idx_;
   state["info:level_idx"_] = level_idx_;
+  state["info:optimal_length"_] = solution_.length;
+  state["info:next_optimal_action"_] =
+      on_solution_ && current_step_ < solution_.length
+          ? static_cast<int>(solution_.actions[current_step_])
+          : -1;
 }
 
 }  // namespace sokoban
@@ -222,7 +173,50 @@ using SokobanEnvSpec = PyEnvSpec<sokoban::SokobanEnvSpec>;
 // generate python-side (raw) SokobanEnvPool
 using SokobanEnvPool = PyEnvPool<sokoban::SokobanEnvPool>;
 
+using SokobanBatchEnvSpec = PyEnvSpec<sokoban::SokobanBatchEnvSpec>;
+using SokobanBatchEnvPool = PyEnvPool<sokoban::SokobanBatchEnvPool>;
+
+// Per-level statistics and sampling weights of a `LevelSampler`, as numpy
+// arrays indexed by level number.
+py::dict LevelSamplerStats(const sokoban::LevelSampler& sampler) {
+  const std::size_t n = sampler.Size();
+  py::array_t<uint32_t> episodes(n), solved(n);
+  py::array_t<uint64_t> steps(n);
+  py::array_t<double> return_sum(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    const sokoban::LevelStats& stats = sampler.Stats(i);
+    episodes.mutable_at(i) = stats.episodes.load(std::memory_order_relaxed);
+    solved.mutable_at(i) = stats.solved.load(std::memory_order_relaxed);
+    steps.mutable_at(i) = stats.steps.load(std::memory_order_relaxed);
+    return_sum.mutable_at(i) =
+        stats.return_sum.load(std::memory_order_relaxed);
+  }
+  py::dict out;
+  out["episodes"] = episodes;
+  out["solved"] = solved;
+  out["steps"] = steps;
+  out["return_sum"] = return_sum;
+  const std::vector<double> priorities = sampler.Priorities();
+  out["priority"] = py::array_t<double>(n, priorities.data());
+  return out;
+}
+
 // generate sokoban_envpool.so
 PYBIND11_MODULE(sokoban_envpool, m) {
   REGISTER(m, SokobanEnvSpec, SokobanEnvPool)
+  REGISTER(m, SokobanBatchEnvSpec, SokobanBatchEnvPool)
+
+  py::class_<sokoban::LevelSampler, std::shared_ptr<sokoban::LevelSampler>>(
+      m, "_LevelSampler")
+      .def_static("find",
+                  [](const std::string& levels_dir, uint64_t seed,
+                     const std::string& id) {
+                    return sokoban::LevelSampler::Find(levels_dir, seed, id);
+                  })
+      .def("__len__", &sokoban::LevelSampler::Size)
+      .def("stats", &LevelSamplerStats)
+      .def("clear", &sokoban::LevelSampler::Clear,
+           py::call_guard<py::gil_scoped_release>())
+      .def("reseed", &sokoban::LevelSampler::Reseed, py::arg("seed"),
+           py::call_guard<py::gil_scoped_release>());
 }
@@ -17,7 +17,10 @@
 #ifndef ENVPOOL_SOKOBAN_SOKOBAN_ENVPOOL_H_
 #define ENVPOOL_SOKOBAN_SOKOBAN_ENVPOOL_H_
 
+#include <algorithm>
+#include <cstdint>
 #include <filesystem>
+#include <memory>
 #include <sstream>
 #include <stdexcept>
 #include <string>
@@ -25,16 +28,13 @@
 #include "envpool/core/array.h"
 #include "envpool/core/async_envpool.h"
 #include "envpool/core/env.h"
+#include "envpool/sokoban/level_sampler.h"
+#include "envpool/sokoban/sokoban_world.h"
+#include "envpool/sokoban/solution_index.h"
 #include "level_loader.h"
 
 namespace sokoban {
 
-constexpr int kActPushUp = 0;
-constexpr int kActPushDown = 1;
-constexpr int kActPushLeft = 2;
-constexpr int kActPushRight = 3;
-constexpr int kMaxAction = kActPushRight;
-
 class SokobanEnvFns {
  public:
   static decltype(auto) DefaultConfig() {
@@ -43,14 +43,24 @@ class SokobanEnvFns {
                     "levels_dir"_.Bind(std::string("")), "verbose"_.Bind(0),
                     "min_episode_steps"_.Bind(0),
                     "load_sequentially"_.Bind(false),
-                    "n_levels_to_load"_.Bind(-1));
+                    "n_levels_to_load"_.Bind(-1),
+                    "obs_mode"_.Bind(std::string("rgb")),
+                    "solutions_path"_.Bind(std::string("")),
+                    "level_sampler"_.Bind(std::string("")),
+                    "level_sampler_temperature"_.Bind(1.0),
+                    "level_sampler_id"_.Bind(std::string("")));
   }
   template <typename Config>
   static decltype(auto) StateSpec(const Config& conf) {
     int dim_room = conf["dim_room"_];
-    return MakeDict("obs"_.Bind(Spec<uint8_t>({3, dim_room, dim_room})),
+    ObsMode obs_mode = ParseObsMode(conf["obs_mode"_]);
+    uint8_t obs_max = obs_mode == ObsMode::kIndex ? kMaxLevelObject : 255;
+    return MakeDict("obs"_.Bind(Spec<uint8_t>(ObsShape(obs_mode, dim_room),
+                                              {0, obs_max})),
                     "info:level_file_idx"_.Bind(Spec<int>({-1})),
-                    "info:level_idx"_.Bind(Spec<int>({-1})));
+                    "info:level_idx"_.Bind(Spec<int>({-1})),
+                    "info:optimal_length"_.Bind(Spec<int>({-1})),
+                    "info:next_optimal_action"_.Bind(Spec<int>({-1})));
   }
   template <typename Config>
   static decltype(auto) ActionSpec(const Config& conf) {
@@ -61,6 +71,35 @@ class SokobanEnvFns {
 // this line will concat common config and common state/action spec
 using SokobanEnvSpec = EnvSpec<SokobanEnvFns>;
 
+/**
+ * The pool-wide sampler configured by "level_sampler", or null if it is
+ * empty, in which case `loader` picks levels itself. The sampler covers the
+ * first `n_levels_to_load` levels, or all of them. Pools with the same
+ * levels_dir and seed share it unless their "level_sampler_id"s differ.
+ */
+template <typename Config>
+std::shared_ptr<LevelSampler> OpenLevelSampler(const Config& config,
+                                               const LevelLoader& loader) {
+  const std::string mode = config["level_sampler"_];
+  if (mode.empty()) {
+    return nullptr;
+  }
+  if (config["load_sequentially"_]) {
+    throw std::runtime_error(
+        "level_sampler cannot be combined with load_sequentially.");
+  }
+  std::size_t size = loader.NumLevels();
+  const int n_levels_to_load = config["n_levels_to_load"_];
+  if (n_levels_to_load > 0) {
+    size = std::min(size, static_cast<std::size_t>(n_levels_to_load));
+  }
+  const std::string levels_dir = config["levels_dir"_];
+  return LevelSampler::Open(levels_dir, static_cast<uint64_t>(config["seed"_]),
+                            config["level_sampler_id"_],
+                            ParseSamplerMode(mode),
+                            config["level_sampler_temperature"_], size);
+}
+
 class SokobanEnv : public Env<SokobanEnvSpec> {
  public:
   SokobanEnv(const Spec& spec, int env_id)
@@ -70,14 +109,23 @@ class SokobanEnv : public Env<SokobanEnvSpec> {
         reward_box_{static_cast<double>(spec.config["reward_box"_])},
         reward_step_{static_cast<double>(spec.config["reward_step"_])},
         levels_dir_{static_cast<std::string>(spec.config["levels_dir"_])},
+        obs_mode_(ParseObsMode(spec.config["obs_mode"_])),
         level_loader_(levels_dir_, spec.config["load_sequentially"_],
                       static_cast<int>(spec.config["n_levels_to_load"_]),
                       env_id, static_cast<int>(spec.config["num_envs"_]),
                       static_cast<int>(spec.config["verbose"_])),
-        world_(kWall, static_cast<std::size_t>(dim_room_ * dim_room_)),
+        world_(dim_room_),
         verbose_(static_cast<int>(spec.config["verbose"_])),
         current_max_episode_steps_(
             static_cast<int>(spec.config["max_episode_steps"_])) {
+    const std::string solutions_path = spec.config["solutions_path"_];
+    if (!solutions_path.empty()) {
+      solutions_ = SolutionIndex::Open(solutions_path);
+    }
+    sampler_ = OpenLevelSampler(spec.config, level_loader_);
+    if (sampler_ != nullptr) {
+      sample_stream_ = sampler_->Stream(env_id);
+    }
     if (max_num_players_ != spec_.config["max_num_players"_]) {
       std::stringstream msg;
       msg << "max_num_players_ != spec_['max_num_players'] " << max_num_players_
@@ -94,11 +142,13 @@ class SokobanEnv : public Env<SokobanEnvSpec> {
   }
 
   bool IsDone() override {
-    return (unmatched_boxes_ == 0) ||
+    return (world_.UnmatchedBoxes() == 0) ||
            (current_step_ >= current_max_episode_steps_);
   }
   void Reset() override;
   void Step(const Action& action_dict) override;
+  void Serialize(ByteWriter* writer) override;
+  void Deserialize(ByteReader* reader) override;
 
   void WriteState(float reward);
 
@@ -106,20 +156,36 @@ class SokobanEnv : public Env<SokobanEnvSpec> {
   int dim_room_;
   double reward_finished_, reward_box_, reward_step_;
   std::filesystem::path levels_dir_;
+  ObsMode obs_mode_;
 
   LevelLoader level_loader_;
   int level_file_idx_{-1}, level_idx_{-1};
-  SokobanLevel world_;
+  SokobanWorld world_;
   int verbose_;
 
+  // Optimal solution of the current level from `solutions_path`, if any.
+  // `on_solution_` is whether every action this episode followed it, in which
+  // case its next action is reported in `info:next_optimal_action`.
+  std::shared_ptr<const SolutionIndex> solutions_;
+  SolutionIndex::Solution solution_;
+  bool on_solution_{false};
+
+  // Curriculum choosing the levels instead of `level_loader_`, if any, this
+  // env's stream of draws from it and the sampler's number for the current
+  // level, -1 if it is not to be recorded.
+  std::shared_ptr<LevelSampler> sampler_;
+  SamplerStream sample_stream_;
+  int64_t sample_idx_{-1};
+  double episode_return_{0.0};
+
   int current_max_episode_steps_;
   int current_step_{0};
-  int player_x_{0}, player_y_{0};
-  int unmatched_boxes_{0};
 
-  [[nodiscard]] uint8_t WorldAt(int x, int y) const;
-  void WorldAssignAt(int x, int y, uint8_t value);
   void ResetWithoutWrite();
+  // Reports the episode that just ended to `sampler_`.
+  void RecordEpisode();
+  // Looks up the solution of the current level and restarts following it.
+  void FindSolution();
 };
 
 using SokobanEnvPool = AsyncEnvPool<SokobanEnv>;
@@ -15,6 +15,7 @@
 #ifndef ENVPOOL_SOKOBAN_SOKOBAN_NODE_H_
 #define ENVPOOL_SOKOBAN_SOKOBAN_NODE_H_
 
+#include <array>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -52,6 +52,11 @@ def test_config() -> None:
     "verbose",
     "load_sequentially",
     "n_levels_to_load",
+    "obs_mode",
+    "solutions_path",
+    "level_sampler",
+    "level_sampler_temperature",
+    "level_sampler_id",
   ]
   default_conf = _SokobanEnvSpec._default_config_values
   assert isinstance(default_conf, tuple)
@@ -159,6 +164,38 @@ def test_envpool_load_sequentially(capfd) -> None:
       assert lev2 == levels_by_files[i][1][1]
 
 
+def test_obs_modes() -> None:
+  num_envs = 4
+  obs_by_mode = {}
+  for obs_mode in ["rgb", "index", "onehot"]:
+    env = envpool.make(
+      "Sokoban-v0",
+      env_type="gymnasium",
+      num_envs=num_envs,
+      batch_size=num_envs,
+      seed=3,
+      max_episode_steps=60,
+      levels_dir="/app/envpool/sokoban/sample_levels",
+      obs_mode=obs_mode,
+    )
+    assert env.observation_space.shape == env.reset()[0].shape[1:]
+    obs_by_mode[obs_mode] = [env.reset()[0]]
+    actions = np.random.RandomState(0).randint(0, 4, size=(20, num_envs))
+    for action in actions:
+      obs_by_mode[obs_mode].append(env.step(action)[0])
+
+  colors = np.array([color for color, _ in TINY_COLORS], dtype=np.uint8)
+  for rgb, index, onehot in zip(*obs_by_mode.values()):
+    assert index.shape == (num_envs, 10, 10)
+    assert onehot.shape == (num_envs, 7, 13)
+    np.testing.assert_array_equal(rgb, colors[index].transpose(0, 3, 1, 2))
+    planes = np.unpackbits(onehot, axis=-1, bitorder="little")[..., :100]
+    np.testing.assert_array_equal(
+      planes.reshape(num_envs, 7, 10, 10),
+      np.eye(7, dtype=np.uint8)[index].transpose(0, 3, 1, 2),
+    )
+
+
 def test_xla() -> None:
   num_envs = 10
   env = envpool.make(
@@ -353,6 +390,90 @@ def test_astar_log(tmp_path) -> None:
   assert f"0,{SOLVE_LEVEL_ZERO},21,1380" == log.split("\n")[1]
 
 
+def test_binary_levels(tmp_path) -> None:
+  levels_dir = "/app/envpool/sokoban/sample_levels"
+  bin_file = tmp_path / "levels.bin"
+  subprocess.run(
+    [
+      "/root/go/bin/bazel", f"--output_base={str(tmp_path)}", "run",
+      "//envpool/sokoban:convert_levels", "--", levels_dir,
+      str(bin_file)
+    ],
+    check=True,
+    cwd="/app/envpool",
+    env={
+      "HOME": "/root",
+      "PATH": "/opt/conda/bin:/usr/bin"
+    },
+  )
+  total_levels, num_envs = 8, 2
+  envs = [
+    envpool.make(
+      "Sokoban-v0",
+      env_type="gymnasium",
+      num_envs=num_envs,
+      batch_size=num_envs,
+      max_episode_steps=60,
+      min_episode_steps=60,
+      levels_dir=path,
+      load_sequentially=True,
+      n_levels_to_load=total_levels,
+    ) for path in [levels_dir, str(bin_file)]
+  ]
+  for _ in range(total_levels):
+    (obs0, info0), (obs1, info1) = [env.reset() for env in envs]
+    np.testing.assert_array_equal(obs0, obs1)
+    for key in ["level_file_idx", "level_idx"]:
+      np.testing.assert_array_equal(info0[key], info1[key])
+
+
+def test_solution_oracle(tmp_path) -> None:
+  levels_dir = "/app/envpool/sokoban/sample_levels"
+  log_file = tmp_path / "solutions.csv"
+  index_file = tmp_path / "solutions.bin"
+  for target, args in [
+    ("astar_batch", [levels_dir, str(log_file), "1", "8", "1000000", "push"]),
+    ("convert_solutions", [levels_dir, str(log_file), str(index_file)]),
+  ]:
+    subprocess.run(
+      [
+        "/root/go/bin/bazel", f"--output_base={str(tmp_path)}", "run",
+        f"//envpool/sokoban:{target}", "--", *args
+      ],
+      check=True,
+      cwd="/app/envpool",
+      env={
+        "HOME": "/root",
+        "PATH": "/opt/conda/bin:/usr/bin"
+      },
+    )
+  env = envpool.make(
+    "Sokoban-v0",
+    env_type="gymnasium",
+    num_envs=1,
+    batch_size=1,
+    max_episode_steps=100,
+    min_episode_steps=100,
+    levels_dir=levels_dir,
+    load_sequentially=True,
+    solutions_path=str(index_file),
+  )
+  _, info = env.reset()
+  for _ in range(8):
+    optimal_length = int(info["optimal_length"][0])
+    assert optimal_length > 0
+    for step in range(optimal_length):
+      action = int(info["next_optimal_action"][0])
+      assert 0 <= action <= 3
+      _, reward, term, trunc, info = env.step(make_1d_array(action))
+      assert term == (step == optimal_length - 1) and not trunc
+
+  # Leaving the optimal path turns the next action off.
+  action = int(info["next_optimal_action"][0])
+  _, _, _, _, info = env.step(make_1d_array((action + 1) % 4))
+  assert info["next_optimal_action"][0] == -1
+
+
 def test_sneaky_noop():
   """
   Even though an action < 0 is not part of the environment, we overload it to
@@ -391,6 +512,173 @@ def test_sneaky_noop():
   assert np.all(np.any(truncated, axis=0), axis=0)
 
 
+def test_snapshot_restore() -> None:
+  num_envs = 4
+  env = envpool.make(
+    "Sokoban-v0",
+    env_type="gymnasium",
+    num_envs=num_envs,
+    batch_size=num_envs,
+    min_episode_steps=60,
+    max_episode_steps=60,
+    levels_dir="/app/envpool/sokoban/sample_levels",
+  )
+  env.reset()
+  env.step(np.zeros([num_envs], dtype=np.int32))
+  snapshots = env.snapshot()
+  assert len(snapshots) == num_envs
+  assert all(isinstance(s, bytes) for s in snapshots)
+
+  actions = np.random.randint(low=0, high=4, size=(10, num_envs))
+  first = [env.step(a) for a in actions]
+  # restore in reverse env order: snapshots are portable across envs
+  env.restore(snapshots[::-1], env_id=env.all_env_ids[::-1].copy())
+  second = [env.step(a) for a in actions]
+  for (obs0, rew0, *_), (obs1, rew1, *_) in zip(first, second):
+    np.testing.assert_array_equal(obs0, obs1)
+    np.testing.assert_array_equal(rew0, rew1)
+
+  # the env id pairs with its snapshot
+  env.restore(snapshots)
+  env.restore([snapshots[1]], env_id=np.array([0]))
+  obs_a, *_ = env.step(np.array([2, 2, 2, 2], dtype=np.int32))
+  env.restore(snapshots)
+  obs_b, *_ = env.step(np.array([2, 2, 2, 2], dtype=np.int32))
+  np.testing.assert_array_equal(obs_a[1:], obs_b[1:])
+  np.testing.assert_array_equal(obs_a[0], obs_b[1])
+
+
+def test_batch_matches_async() -> None:
+  num_envs = 16
+  kwargs = dict(
+    env_type="gymnasium",
+    num_envs=num_envs,
+    batch_size=num_envs,
+    seed=5,
+    min_episode_steps=20,
+    max_episode_steps=30,
+    levels_dir="/app/envpool/sokoban/sample_levels",
+  )
+  envs = [
+    envpool.make(task, **kwargs)
+    for task in ["Sokoban-v0", "SokobanBatch-v0"]
+  ]
+  first, second = [env.reset() for env in envs]
+  order = np.argsort(first[1]["env_id"])
+  np.testing.assert_array_equal(first[0][order], second[0])
+  for _ in range(200):
+    action = np.random.randint(low=0, high=4, size=(num_envs,))
+    first, second = [env.step(action) for env in envs]
+    # the async pool may return envs in completion order
+    order = np.argsort(first[4]["env_id"])
+    for a, b in zip(first[:4], second[:4]):
+      np.testing.assert_array_equal(a[order], b)
+    for key in ["env_id", "level_file_idx", "level_idx", "elapsed_step"]:
+      np.testing.assert_array_equal(first[4][key][order], second[4][key])
+
+
+@pytest.mark.parametrize("task", ["Sokoban-v0", "SokobanBatch-v0"])
+def test_level_sampler(task: str) -> None:
+  num_envs = 8
+  env = envpool.make(
+    task,
+    env_type="gymnasium",
+    num_envs=num_envs,
+    batch_size=num_envs,
+    seed=7,
+    min_episode_steps=10,
+    max_episode_steps=10,
+    levels_dir="/app/envpool/sokoban/sample_levels",
+    level_sampler="unsolved",
+  )
+  sampler = envpool.sokoban.level_sampler(env)
+  assert sampler is not None
+  n_levels = len(sampler)
+  files = glob.glob("/app/envpool/sokoban/sample_levels/*.txt")
+  assert n_levels == sum(len(read_levels_file(Path(f))) for f in files)
+  env.reset()
+  for _ in range(100):
+    env.step(np.random.randint(low=0, high=4, size=(num_envs,)))
+  stats = sampler.stats()
+  assert stats["episodes"].shape == (n_levels,)
+  # episodes last at most 10 steps, and every step but the unfinished
+  # episodes' is recorded
+  assert stats["episodes"].sum() >= num_envs * 10
+  assert stats["steps"].sum() <= num_envs * 100
+  assert np.all(stats["solved"] <= stats["episodes"])
+  assert np.all(stats["priority"] > 0)
+  sampler.clear()
+  assert sampler.stats()["episodes"].sum() == 0
+  assert np.all(sampler.stats()["priority"] == 1.0)
+
+  with pytest.raises(RuntimeError):
+    envpool.make(
+      task,
+      env_type="gymnasium",
+      num_envs=1,
+      levels_dir="/app/envpool/sokoban/sample_levels",
+      level_sampler="hardest",
+    )
+
+
+@pytest.mark.parametrize("task", ["Sokoban-v0", "SokobanBatch-v0"])
+@pytest.mark.parametrize("mode", ["uniform", "unsolved"])
+def test_level_sampler_reproducible(task: str, mode: str) -> None:
+  num_envs = 8
+  envs = [
+    envpool.make(
+      task,
+      env_type="gymnasium",
+      num_envs=num_envs,
+      batch_size=num_envs,
+      # the non-uniform modes also depend on the order episodes end in
+      num_threads=0 if mode == "uniform" else 1,
+      seed=11,
+      min_episode_steps=5,
+      max_episode_steps=5,
+      levels_dir="/app/envpool/sokoban/sample_levels",
+      level_sampler=mode,
+      level_sampler_id=sampler_id,
+    ) for sampler_id in ["a", "b"]
+  ]
+  samplers = [envpool.sokoban.level_sampler(env) for env in envs]
+  assert samplers[0] is not samplers[1]
+  infos = [env.reset()[1] for env in envs]
+  order = np.argsort(infos[0]["env_id"])
+  first_levels = infos[0]["level_idx"][order]
+  for i in range(50):
+    if i == 25:
+      for sampler in samplers:
+        sampler.reseed(3)
+    order = [np.argsort(info["env_id"]) for info in infos]
+    for key in ["level_file_idx", "level_idx"]:
+      np.testing.assert_array_equal(
+        infos[0][key][order[0]], infos[1][key][order[1]]
+      )
+    action = np.random.randint(low=0, high=4, size=(num_envs,))
+    infos = [env.step(action)[4] for env in envs]
+  for key in ["episodes", "solved", "steps"]:
+    np.testing.assert_array_equal(
+      samplers[0].stats()[key], samplers[1].stats()[key]
+    )
+
+  if mode == "uniform":
+    # restarting the streams from the pool's seed replays its first levels
+    samplers[0].reseed(11)
+    replayed = {}
+    while len(replayed) < num_envs:
+      _, _, term, trunc, info = envs[0].step(np.zeros(num_envs, np.int32))
+      # the last step of an episode already shows the next level
+      for env_id, done, level in zip(
+        info["env_id"], term | trunc, info["level_idx"]
+      ):
+        if done:
+          replayed.setdefault(env_id, level)
+    np.testing.assert_array_equal(
+      [replayed[i] for i in range(num_envs)], first_levels
+    )
+
+
 if __name__ == "__main__":
   retcode = pytest.main(["-v", __file__])
   sys.exit(retcode)
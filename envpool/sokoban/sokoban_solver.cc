@@ -0,0 +1,445 @@
+// Copyright 2023-2024 FAR AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "envpool/sokoban/sokoban_solver.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+
+namespace sokoban {
+
+std::size_t SolverStateHash::operator()(const SolverState& state) const {
+  uint64_t hash = static_cast<uint64_t>(state.player) * 0x9E3779B97F4A7C15ULL;
+  for (uint64_t word : state.boxes) {
+    hash ^= word + 0x9E3779B97F4A7C15ULL + (hash << 6) + (hash >> 2);
+  }
+  return static_cast<std::size_t>(hash);
+}
+
+SokobanSolver::SokobanSolver(int dim_room, const SokobanLevel& level)
+    : dim_room_(dim_room),
+      neighbor_(dim_room * dim_room),
+      dead_(dim_room * dim_room, true) {
+  const int n_cells = dim_room * dim_room;
+  if (n_cells > kSolverMaxCells ||
+      level.size() != static_cast<std::size_t>(n_cells)) {
+    std::stringstream msg;
+    msg << "SokobanSolver needs a dim_room x dim_room level with at most "
+        << kSolverMaxCells << " cells, got dim_room=" << dim_room
+        << " and level.size()=" << level.size() << std::endl;
+    throw std::runtime_error(msg.str());
+  }
+
+  std::vector<bool> walls(n_cells);
+  for (int cell = 0; cell < n_cells; cell++) {
+    switch (level[cell]) {
+      case kWall:
+        walls[cell] = true;
+        break;
+      case kTarget:
+        target_cells_.push_back(cell);
+        targets_.SetBox(cell);
+        break;
+      case kBoxOnTarget:
+        target_cells_.push_back(cell);
+        targets_.SetBox(cell);
+        start_.SetBox(cell);
+        break;
+      case kBox:
+        start_.SetBox(cell);
+        break;
+      case kPlayer:
+        start_.player = cell;
+        break;
+      case kPlayerOnTarget:
+        target_cells_.push_back(cell);
+        targets_.SetBox(cell);
+        start_.player = cell;
+        break;
+    }
+  }
+
+  auto is_wall = [&](int x, int y) {
+    return x < 0 || x >= dim_room || y < 0 || y >= dim_room ||
+           walls[x + y * dim_room];
+  };
+  for (int y = 0; y < dim_room; y++) {
+    for (int x = 0; x < dim_room; x++) {
+      const int cell = x + y * dim_room;
+      for (int a = 0; a < 4; a++) {
+        const int nx = x + kDelta[a][0];
+        const int ny = y + kDelta[a][1];
+        neighbor_[cell][a] =
+            is_wall(nx, ny) ? -1 : static_cast<int16_t>(nx + ny * dim_room);
+      }
+    }
+  }
+
+  // Pull boxes backwards from each target: a box reaches `cell` from `prev`
+  // by a push in direction `a` if the player fits on the far side of `prev`.
+  push_distance_.assign(target_cells_.size() * n_cells, kNoPush);
+  std::vector<int> queue(n_cells);
+  for (std::size_t t = 0; t < target_cells_.size(); t++) {
+    int32_t* distance = &push_distance_[t * n_cells];
+    std::size_t head = 0;
+    std::size_t tail = 0;
+    distance[target_cells_[t]] = 0;
+    queue[tail++] = target_cells_[t];
+    while (head < tail) {
+      const int cell = queue[head++];
+      dead_[cell] = false;
+      for (int a = 0; a < 4; a++) {
+        const int prev = neighbor_[cell][(a + 2) % 4];
+        if (prev < 0 || neighbor_[prev][(a + 2) % 4] < 0 ||
+            distance[prev] != kNoPush) {
+          continue;
+        }
+        distance[prev] = distance[cell] + 1;
+        queue[tail++] = prev;
+      }
+    }
+  }
+}
+
+bool SokobanSolver::IsSolved(const SolverState& state) const {
+  for (std::size_t i = 0; i < state.boxes.size(); i++) {
+    if ((state.boxes[i] & ~targets_.boxes[i]) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+int32_t SokobanSolver::Heuristic(const SolverState& state,
+                                 Arena* arena) const {
+  std::vector<int>& boxes = arena->box_cells;
+  boxes.clear();
+  for (std::size_t i = 0; i < state.boxes.size(); i++) {
+    uint64_t word = state.boxes[i];
+    while (word != 0) {
+      boxes.push_back(static_cast<int>(i * 64 + __builtin_ctzll(word)));
+      word &= word - 1;
+    }
+  }
+  if (boxes.size() > target_cells_.size()) {
+    return kNoPush;
+  }
+  if (IsSolved(state)) {
+    return 0;
+  }
+  // Every push costs a step, and before the next one the player has to walk
+  // next to some box.
+  const std::size_t n_cells = neighbor_.size();
+  const int32_t pushes = arena->assignment.Solve(
+      static_cast<int>(boxes.size()), static_cast<int>(target_cells_.size()),
+      [&](int box, int target) {
+        return push_distance_[target * n_cells + boxes[box]];
+      });
+  return pushes + WalkBound(state);
+}
+
+int32_t SokobanSolver::WalkBound(const SolverState& state) const {
+  const int px = state.player % dim_room_;
+  const int py = state.player / dim_room_;
+  int walk = std::numeric_limits<int>::max();
+  for (std::size_t i = 0; i < state.boxes.size(); i++) {
+    uint64_t word = state.boxes[i];
+    while (word != 0) {
+      const int box = static_cast<int>(i * 64 + __builtin_ctzll(word));
+      walk = std::min(walk, std::abs(box % dim_room_ - px) +
+                                std::abs(box / dim_room_ - py) - 1);
+      word &= word - 1;
+    }
+  }
+  return walk;
+}
+
+bool SokobanSolver::IsFrozen(const SolverState& state, int cell) const {
+  SolverState walls;
+  bool off_target = false;
+  return Frozen(state, cell, &walls, &off_target) && off_target;
+}
+
+bool SokobanSolver::Frozen(const SolverState& state, int cell,
+                           SolverState* walls, bool* off_target) const {
+  // While its neighbours are examined, this box counts as a wall, which both
+  // ends cycles and is the worst case for them.
+  walls->SetBox(cell);
+  const bool frozen = AxisBlocked(state, cell, 0, walls, off_target) &&
+                      AxisBlocked(state, cell, 1, walls, off_target);
+  walls->ClearBox(cell);
+  if (frozen && !targets_.HasBox(cell)) {
+    *off_target = true;
+  }
+  return frozen;
+}
+
+bool SokobanSolver::AxisBlocked(const SolverState& state, int cell, int axis,
+                                SolverState* walls, bool* off_target) const {
+  // Axis 0 is vertical (up, down), axis 1 horizontal (right, left).
+  const int a = neighbor_[cell][axis];
+  const int b = neighbor_[cell][axis + 2];
+  if (a < 0 || b < 0 || walls->HasBox(a) || walls->HasBox(b)) {
+    return true;
+  }
+  if (dead_[a] && dead_[b]) {
+    return true;
+  }
+  return (state.HasBox(a) && Frozen(state, a, walls, off_target)) ||
+         (state.HasBox(b) && Frozen(state, b, walls, off_target));
+}
+
+bool SokobanSolver::NodeLess::operator()(int32_t a, int32_t b) const {
+  const Node& na = (*nodes)[a];
+  const Node& nb = (*nodes)[b];
+  const int32_t fa = na.g + na.h;
+  const int32_t fb = nb.g + nb.h;
+  // Among equal f, prefer deeper nodes: they are closer to a goal.
+  return fa < fb || (fa == fb && na.g > nb.g);
+}
+
+void SokobanSolver::Arena::Clear() {
+  nodes.clear();
+  index.clear();
+  closed.clear();
+  open.Clear();
+}
+
+void SokobanSolver::StartSearch(Arena* arena) const {
+  arena->Clear();
+  const int32_t h = Heuristic(start_, arena);
+  arena->nodes.push_back(Node{start_, -1, 0, h, -1});
+  arena->closed.push_back(false);
+  arena->index.emplace(start_, 0);
+  if (h < kNoPush) {
+    arena->open.Push(0);
+  }
+}
+
+bool SokobanSolver::AddChild(int32_t parent, const SolverState& child,
+                             int32_t g, int32_t h, int action,
+                             std::size_t max_nodes, Arena* arena) const {
+  std::vector<Node>& nodes = arena->nodes;
+  auto [it, inserted] =
+      arena->index.try_emplace(child, static_cast<int32_t>(nodes.size()));
+  if (inserted) {
+    if (nodes.size() >= max_nodes) {
+      return false;
+    }
+    nodes.push_back(Node{child, parent, g, h, static_cast<int8_t>(action)});
+    arena->closed.push_back(false);
+    arena->open.Push(it->second);
+    return true;
+  }
+  Node& old = nodes[it->second];
+  if (old.g <= g) {
+    return true;
+  }
+  old.g = g;
+  old.parent = parent;
+  old.action = static_cast<int8_t>(action);
+  if (arena->closed[it->second]) {
+    arena->closed[it->second] = false;
+    arena->open.Push(it->second);
+  } else {
+    arena->open.DecreaseKey(it->second);
+  }
+  return true;
+}
+
+SolveResult SokobanSolver::Solve(std::size_t max_nodes, Arena* arena) {
+  std::unique_ptr<Arena> own_arena;
+  if (arena == nullptr) {
+    own_arena = std::make_unique<Arena>();
+    arena = own_arena.get();
+  }
+  StartSearch(arena);
+  std::vector<Node>& nodes = arena->nodes;
+  std::vector<bool>& closed = arena->closed;
+  auto& open = arena->open;
+
+  SolveResult result;
+  while (!open.Empty()) {
+    const int32_t id = open.Pop();
+    closed[id] = true;
+    result.search_steps++;
+    if (IsSolved(nodes[id].state)) {
+      result.status = SolveStatus::kSolved;
+      for (int32_t n = id; nodes[n].parent >= 0; n = nodes[n].parent) {
+        result.actions.push_back(nodes[n].action);
+      }
+      std::reverse(result.actions.begin(), result.actions.end());
+      result.num_nodes = nodes.size();
+      return result;
+    }
+
+    for (int a = 0; a < 4; a++) {
+      // `nodes` may reallocate below, so re-read the parent every time.
+      const SolverState& state = nodes[id].state;
+      const int next = neighbor_[state.player][a];
+      if (next < 0) {
+        continue;
+      }
+      SolverState child = state;
+      child.player = next;
+      int32_t h = 0;
+      if (state.HasBox(next)) {
+        const int behind = neighbor_[next][a];
+        if (behind < 0 || state.HasBox(behind) || dead_[behind]) {
+          continue;
+        }
+        child.ClearBox(next);
+        child.SetBox(behind);
+        if (IsFrozen(child, behind)) {
+          continue;
+        }
+        h = Heuristic(child, arena);
+        if (h >= kNoPush) {
+          continue;
+        }
+      } else {
+        // The boxes did not move, so only the walk term changes.
+        h = nodes[id].h - WalkBound(state) + WalkBound(child);
+      }
+      const int32_t g = nodes[id].g + 1;
+
+      if (!AddChild(id, child, g, h, a, max_nodes, arena)) {
+        result.status = SolveStatus::kOutOfNodes;
+        result.num_nodes = nodes.size();
+        return result;
+      }
+    }
+  }
+  result.status = SolveStatus::kUnsolvable;
+  result.num_nodes = nodes.size();
+  return result;
+}
+
+void SokobanSolver::ReachPlayer(const SolverState& state, Arena* arena) const {
+  const std::size_t n_cells = neighbor_.size();
+  std::vector<int32_t>& distance = arena->distance;
+  std::vector<int16_t>& queue = arena->queue;
+  distance.assign(n_cells, -1);
+  arena->entered_by.resize(n_cells);
+  queue.resize(n_cells);
+  std::size_t head = 0;
+  std::size_t tail = 0;
+  distance[state.player] = 0;
+  queue[tail++] = static_cast<int16_t>(state.player);
+  while (head < tail) {
+    const int cell = queue[head++];
+    for (int a = 0; a < 4; a++) {
+      const int next = neighbor_[cell][a];
+      if (next < 0 || distance[next] >= 0 || state.HasBox(next)) {
+        continue;
+      }
+      distance[next] = distance[cell] + 1;
+      arena->entered_by[next] = static_cast<int8_t>(a);
+      queue[tail++] = static_cast<int16_t>(next);
+    }
+  }
+}
+
+void SokobanSolver::AppendWalk(const SolverState& from, int to, Arena* arena,
+                               std::vector<int>* actions) const {
+  ReachPlayer(from, arena);
+  const std::size_t start = actions->size();
+  for (int cell = to; cell != from.player;) {
+    const int a = arena->entered_by[cell];
+    actions->push_back(a);
+    cell = neighbor_[cell][(a + 2) % 4];
+  }
+  std::reverse(actions->begin() + static_cast<std::ptrdiff_t>(start),
+               actions->end());
+}
+
+SolveResult SokobanSolver::SolvePushes(std::size_t max_nodes, Arena* arena) {
+  std::unique_ptr<Arena> own_arena;
+  if (arena == nullptr) {
+    own_arena = std::make_unique<Arena>();
+    arena = own_arena.get();
+  }
+  StartSearch(arena);
+  std::vector<Node>& nodes = arena->nodes;
+  std::vector<bool>& closed = arena->closed;
+  auto& open = arena->open;
+
+  SolveResult result;
+  while (!open.Empty()) {
+    const int32_t id = open.Pop();
+    closed[id] = true;
+    result.search_steps++;
+    if (IsSolved(nodes[id].state)) {
+      result.status = SolveStatus::kSolved;
+      std::vector<int32_t> chain;
+      for (int32_t n = id; nodes[n].parent >= 0; n = nodes[n].parent) {
+        chain.push_back(n);
+      }
+      for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+        const Node& node = nodes[*it];
+        const int push_from =
+            neighbor_[node.state.player][(node.action + 2) % 4];
+        AppendWalk(nodes[node.parent].state, push_from, arena, &result.actions);
+        result.actions.push_back(node.action);
+      }
+      result.num_nodes = nodes.size();
+      return result;
+    }
+
+    ReachPlayer(nodes[id].state, arena);
+    for (int cell = 0; cell < static_cast<int>(neighbor_.size()); cell++) {
+      if (arena->distance[cell] < 0) {
+        continue;
+      }
+      for (int a = 0; a < 4; a++) {
+        // `nodes` may reallocate below, so re-read the parent every time.
+        const SolverState& state = nodes[id].state;
+        const int box = neighbor_[cell][a];
+        if (box < 0 || !state.HasBox(box)) {
+          continue;
+        }
+        const int behind = neighbor_[box][a];
+        if (behind < 0 || state.HasBox(behind) || dead_[behind]) {
+          continue;
+        }
+        SolverState child = state;
+        child.ClearBox(box);
+        child.SetBox(behind);
+        child.player = box;
+        if (IsFrozen(child, behind)) {
+          continue;
+        }
+        const int32_t h = Heuristic(child, arena);
+        if (h >= kNoPush) {
+          continue;
+        }
+        const int32_t g = nodes[id].g + arena->distance[cell] + 1;
+        if (!AddChild(id, child, g, h, a, max_nodes, arena)) {
+          result.status = SolveStatus::kOutOfNodes;
+          result.num_nodes = nodes.size();
+          return result;
+        }
+      }
+    }
+  }
+  result.status = SolveStatus::kUnsolvable;
+  result.num_nodes = nodes.size();
+  return result;
+}
+
+}  // namespace sokoban
@@ -0,0 +1,343 @@
+/*
+ * Copyright 2023-2024 FAR AI
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ENVPOOL_SOKOBAN_SOKOBAN_SOLVER_H_
+#define ENVPOOL_SOKOBAN_SOKOBAN_SOLVER_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "envpool/sokoban/level_loader.h"
+
+namespace sokoban {
+
+// Largest level the solver handles is 16x16, one bit per cell.
+constexpr int kSolverMaxCells = 256;
+
+/**
+ * A search state: the player cell and a bitboard of box cells, both indexed by
+ * `x + y * dim_room`.
+ */
+struct SolverState {
+  std::array<uint64_t, kSolverMaxCells / 64> boxes{};
+  int32_t player{0};
+
+  [[nodiscard]] bool HasBox(int cell) const {
+    return ((boxes[cell / 64] >> (cell % 64)) & 1) != 0;
+  }
+  void SetBox(int cell) { boxes[cell / 64] |= uint64_t{1} << (cell % 64); }
+  void ClearBox(int cell) { boxes[cell / 64] &= ~(uint64_t{1} << (cell % 64)); }
+
+  bool operator==(const SolverState& rhs) const {
+    return player == rhs.player && boxes == rhs.boxes;
+  }
+};
+
+struct SolverStateHash {
+  std::size_t operator()(const SolverState& state) const;
+};
+
+/**
+ * Binary min-heap over node ids with a position index, so a node already on
+ * the heap can have its key decreased in O(log n) instead of re-heapifying.
+ * Keys are compared with `Less`, which reads them from the caller's nodes.
+ */
+template <typename Less>
+class IndexedHeap {
+ protected:
+  std::vector<int32_t> heap_;
+  std::vector<int32_t> pos_;  // node id -> index in heap_, -1 if absent
+  Less less_;
+
+  void Place(std::size_t i, int32_t id) {
+    heap_[i] = id;
+    pos_[id] = static_cast<int32_t>(i);
+  }
+
+  void SiftUp(std::size_t i) {
+    const int32_t id = heap_[i];
+    while (i > 0) {
+      const std::size_t parent = (i - 1) / 2;
+      if (!less_(id, heap_[parent])) {
+        break;
+      }
+      Place(i, heap_[parent]);
+      i = parent;
+    }
+    Place(i, id);
+  }
+
+  void SiftDown(std::size_t i) {
+    const int32_t id = heap_[i];
+    const std::size_t n = heap_.size();
+    while (true) {
+      std::size_t child = 2 * i + 1;
+      if (child >= n) {
+        break;
+      }
+      if (child + 1 < n && less_(heap_[child + 1], heap_[child])) {
+        child++;
+      }
+      if (!less_(heap_[child], id)) {
+        break;
+      }
+      Place(i, heap_[child]);
+      i = child;
+    }
+    Place(i, id);
+  }
+
+ public:
+  explicit IndexedHeap(Less less) : less_(std::move(less)) {}
+
+  [[nodiscard]] bool Empty() const { return heap_.empty(); }
+  [[nodiscard]] std::size_t Size() const { return heap_.size(); }
+  [[nodiscard]] bool Contains(int32_t id) const {
+    return id < static_cast<int32_t>(pos_.size()) && pos_[id] >= 0;
+  }
+
+  void Push(int32_t id) {
+    if (id >= static_cast<int32_t>(pos_.size())) {
+      pos_.resize(id + 1, -1);
+    }
+    heap_.push_back(id);
+    SiftUp(heap_.size() - 1);
+  }
+
+  int32_t Pop() {
+    const int32_t top = heap_.front();
+    pos_[top] = -1;
+    const int32_t last = heap_.back();
+    heap_.pop_back();
+    if (!heap_.empty()) {
+      heap_[0] = last;
+      SiftDown(0);
+    }
+    return top;
+  }
+
+  // Restores the heap after the key of `id` decreased.
+  void DecreaseKey(int32_t id) { SiftUp(pos_[id]); }
+
+  void Clear() {
+    for (int32_t id : heap_) {
+      pos_[id] = -1;
+    }
+    heap_.clear();
+  }
+};
+
+/**
+ * Minimum-cost assignment of rows to distinct columns by the Hungarian method,
+ * O(rows^2 * cols). Buffers are kept between calls.
+ */
+class Assignment {
+ protected:
+  std::vector<int32_t> u_, v_, min_;
+  std::vector<int> match_, way_;
+  std::vector<bool> used_;
+
+ public:
+  // Returns the least total `cost(row, col)`, for rows <= cols.
+  template <typename Cost>
+  int32_t Solve(int rows, int cols, const Cost& cost) {
+    constexpr int32_t kInf = std::numeric_limits<int32_t>::max() / 2;
+    u_.assign(rows + 1, 0);
+    v_.assign(cols + 1, 0);
+    match_.assign(cols + 1, 0);  // column -> row, 1-based, 0 if free
+    way_.assign(cols + 1, 0);
+    for (int i = 1; i <= rows; i++) {
+      match_[0] = i;
+      int j0 = 0;
+      min_.assign(cols + 1, kInf);
+      used_.assign(cols + 1, false);
+      do {
+        used_[j0] = true;
+        const int i0 = match_[j0];
+        int32_t delta = kInf;
+        int j1 = 0;
+        for (int j = 1; j <= cols; j++) {
+          if (used_[j]) {
+            continue;
+          }
+          const int32_t reduced = cost(i0 - 1, j - 1) - u_[i0] - v_[j];
+          if (reduced < min_[j]) {
+            min_[j] = reduced;
+            way_[j] = j0;
+          }
+          if (min_[j] < delta) {
+            delta = min_[j];
+            j1 = j;
+          }
+        }
+        for (int j = 0; j <= cols; j++) {
+          if (used_[j]) {
+            u_[match_[j]] += delta;
+            v_[j] -= delta;
+          } else {
+            min_[j] -= delta;
+          }
+        }
+        j0 = j1;
+      } while (match_[j0] != 0);
+      do {
+        const int j1 = way_[j0];
+        match_[j0] = match_[j1];
+        j0 = j1;
+      } while (j0 != 0);
+    }
+    return -v_[0];
+  }
+};
+
+enum class SolveStatus { kSolved, kUnsolvable, kOutOfNodes };
+
+struct SolveResult {
+  SolveStatus status{SolveStatus::kUnsolvable};
+  // Actions in `SokobanNode::kDelta` order (up, right, down, left), the
+  // numbering used by `astar_log`.
+  std::vector<int> actions;
+  // Number of nodes expanded, comparable to `AStarSearch::GetStepCount`.
+  int64_t search_steps{0};
+  // Number of distinct states generated.
+  std::size_t num_nodes{0};
+};
+
+/**
+ * Step-optimal A* solver specialised for Sokoban. Unlike
+ * `AStarSearch<SokobanNode>`, duplicate detection is a hash lookup rather than
+ * a scan of the open list, improved nodes are re-prioritised with
+ * decrease-key, and states are fixed-size bitboards instead of heap-allocated
+ * box vectors. The heuristic is an admissible and consistent matching bound
+ * on push distances, so solutions are step-optimal, and states with a box on
+ * a dead square or frozen off target are pruned.
+ */
+class SokobanSolver {
+ public:
+  static constexpr std::array<std::array<int, 2>, 4> kDelta = {
+      {{0, -1}, {1, 0}, {0, 1}, {-1, 0}}  // Up, Right, Down, Left
+  };
+
+  struct Node {
+    SolverState state;
+    int32_t parent;
+    int32_t g;
+    int32_t h;
+    int8_t action;
+  };
+
+  // Orders open nodes by f, breaking ties towards deeper nodes.
+  struct NodeLess {
+    const std::vector<Node>* nodes;
+    bool operator()(int32_t a, int32_t b) const;
+  };
+
+  /**
+   * Search memory for `Solve`. Clearing keeps the capacity, so a worker that
+   * solves many levels with one arena stops allocating once it has seen its
+   * largest search.
+   */
+  struct Arena {
+    std::vector<Node> nodes;
+    std::unordered_map<SolverState, int32_t, SolverStateHash> index;
+    std::vector<bool> closed;
+    IndexedHeap<NodeLess> open{NodeLess{&nodes}};
+    // Player BFS scratch for `SolvePushes`, one entry per cell.
+    std::vector<int32_t> distance;
+    std::vector<int8_t> entered_by;
+    std::vector<int16_t> queue;
+    // Heuristic scratch.
+    std::vector<int> box_cells;
+    Assignment assignment;
+
+    Arena() = default;
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+    void Clear();
+  };
+
+  SokobanSolver(int dim_room, const SokobanLevel& level);
+
+  // Runs A* until solved, proven unsolvable or `max_nodes` states were
+  // generated. Uses a temporary arena if `arena` is null.
+  SolveResult Solve(std::size_t max_nodes = 1000000, Arena* arena = nullptr);
+  // Same result as `Solve`, searching over box pushes instead of single
+  // steps. A node is the box configuration and the cell the player stands on
+  // after its last push; the player walk between pushes is a BFS over the
+  // free cells, costed at its length so solutions stay step-optimal, and is
+  // expanded into single steps only for the returned path. `max_nodes` and
+  // `search_steps` count push states.
+  SolveResult SolvePushes(std::size_t max_nodes = 1000000,
+                          Arena* arena = nullptr);
+
+  [[nodiscard]] const SolverState& Start() const { return start_; }
+  // Lower bound on the steps left: the cheapest matching of boxes to
+  // distinct targets, costed by push distance, plus the walk to the nearest
+  // box. At least `kNoPush` if some box cannot reach any free target.
+  int32_t Heuristic(const SolverState& state, Arena* arena) const;
+  // The walk term of `Heuristic`: steps before the player stands next to a
+  // box, by Manhattan distance.
+  [[nodiscard]] int32_t WalkBound(const SolverState& state) const;
+  // True if `cell` is a floor from which a box can never reach a target.
+  [[nodiscard]] bool IsDeadSquare(int cell) const { return dead_[cell]; }
+  // True if the box on `cell` can move along neither axis, and it or a box
+  // blocking it is off target.
+  [[nodiscard]] bool IsFrozen(const SolverState& state, int cell) const;
+
+  static constexpr int32_t kNoPush = 1 << 16;
+
+ protected:
+  int dim_room_;
+  SolverState start_;
+  SolverState targets_;
+  // neighbor_[cell][action] is the adjacent non-wall cell, or -1.
+  std::vector<std::array<int16_t, 4>> neighbor_;
+  std::vector<int> target_cells_;
+  // push_distance_[t * n_cells + cell] is the least number of pushes moving a
+  // box from `cell` to target `t` with no other boxes around, or `kNoPush`.
+  std::vector<int32_t> push_distance_;
+  std::vector<bool> dead_;
+
+  [[nodiscard]] bool IsSolved(const SolverState& state) const;
+  // Resets `arena` to a search holding only the start state, which is left
+  // closed if it is already dead.
+  void StartSearch(Arena* arena) const;
+  // Records `child` reached from node `parent` at cost `g`, opening it or
+  // lowering its cost. Returns false if that needs more than `max_nodes`.
+  bool AddChild(int32_t parent, const SolverState& child, int32_t g, int32_t h,
+                int action, std::size_t max_nodes, Arena* arena) const;
+  // Breadth-first search of the cells the player reaches without pushing,
+  // filling `arena->distance` (-1 if unreachable) and `arena->entered_by`.
+  void ReachPlayer(const SolverState& state, Arena* arena) const;
+  // Whether the box on `cell` is blocked along both axes. Boxes in `walls`
+  // count as walls; `off_target` is set if a frozen box is not on a target.
+  bool Frozen(const SolverState& state, int cell, SolverState* walls,
+              bool* off_target) const;
+  bool AxisBlocked(const SolverState& state, int cell, int axis,
+                   SolverState* walls, bool* off_target) const;
+  // Appends the walk from `from.player` to `to` found by `ReachPlayer`.
+  void AppendWalk(const SolverState& from, int to, Arena* arena,
+                  std::vector<int>* actions) const;
+};
+
+}  // namespace sokoban
+
+#endif  // ENVPOOL_SOKOBAN_SOKOBAN_SOLVER_H_
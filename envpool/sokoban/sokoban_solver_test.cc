@@ -0,0 +1,123 @@
+// Copyright 2023-2024 FAR AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "envpool/sokoban/sokoban_solver.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+namespace sokoban {
+namespace {
+
+constexpr int kDim = 9;
+
+// A walled room with random inner walls, boxes and targets.
+SokobanLevel RandomLevel(std::mt19937* gen, int num_boxes) {
+  SokobanLevel level(kDim * kDim, kWall);
+  std::vector<int> floor;
+  for (int y = 1; y < kDim - 1; y++) {
+    for (int x = 1; x < kDim - 1; x++) {
+      if ((*gen)() % 6 != 0) {
+        level[x + y * kDim] = kEmpty;
+        floor.push_back(x + y * kDim);
+      }
+    }
+  }
+  std::shuffle(floor.begin(), floor.end(), *gen);
+  for (int i = 0; i < num_boxes; i++) {
+    level[floor[i]] = kTarget;
+    level[floor[num_boxes + i]] = kBox;
+  }
+  level[floor[2 * num_boxes]] = kPlayer;
+  return level;
+}
+
+// Least number of steps solving `level` by breadth-first search over all
+// states, or -1 if it is unsolvable.
+int BfsSolutionLength(const SokobanLevel& level) {
+  SokobanSolver solver(kDim, level);
+  SolverState targets;
+  for (int cell = 0; cell < kDim * kDim; cell++) {
+    if (level[cell] == kTarget || level[cell] == kBoxOnTarget ||
+        level[cell] == kPlayerOnTarget) {
+      targets.SetBox(cell);
+    }
+  }
+  std::unordered_map<SolverState, int, SolverStateHash> distance;
+  std::vector<SolverState> queue{solver.Start()};
+  distance[solver.Start()] = 0;
+  for (std::size_t head = 0; head < queue.size(); head++) {
+    const SolverState state = queue[head];
+    if (state.boxes == targets.boxes) {
+      return distance[state];
+    }
+    for (const auto& delta : SokobanSolver::kDelta) {
+      auto step = [&](int cell) {
+        const int x = cell % kDim + delta[0];
+        const int y = cell / kDim + delta[1];
+        const int next = x + y * kDim;
+        return level[next] == kWall ? -1 : next;
+      };
+      const int next = step(state.player);
+      if (next < 0) {
+        continue;
+      }
+      SolverState child = state;
+      child.player = next;
+      if (state.HasBox(next)) {
+        const int behind = step(next);
+        if (behind < 0 || state.HasBox(behind)) {
+          continue;
+        }
+        child.ClearBox(next);
+        child.SetBox(behind);
+      }
+      if (distance.emplace(child, distance[state] + 1).second) {
+        queue.push_back(child);
+      }
+    }
+  }
+  return -1;
+}
+
+TEST(SokobanSolverTest, OptimalAgainstBfs) {
+  std::mt19937 gen(0);
+  int num_solved = 0;
+  for (int i = 0; i < 1000; i++) {
+    const SokobanLevel level = RandomLevel(&gen, 1 + i % 2);
+    const int expected = BfsSolutionLength(level);
+    SokobanSolver solver(kDim, level);
+    const SolveResult steps = solver.Solve();
+    const SolveResult pushes = solver.SolvePushes();
+    if (expected < 0) {
+      EXPECT_EQ(steps.status, SolveStatus::kUnsolvable) << i;
+      EXPECT_EQ(pushes.status, SolveStatus::kUnsolvable) << i;
+      continue;
+    }
+    num_solved++;
+    ASSERT_EQ(steps.status, SolveStatus::kSolved) << i;
+    ASSERT_EQ(pushes.status, SolveStatus::kSolved) << i;
+    EXPECT_EQ(static_cast<int>(steps.actions.size()), expected) << i;
+    EXPECT_EQ(static_cast<int>(pushes.actions.size()), expected) << i;
+  }
+  // Enough of the random levels are solvable for the check to mean anything.
+  EXPECT_GT(num_solved, 200);
+}
+
+}  // namespace
+}  // namespace sokoban
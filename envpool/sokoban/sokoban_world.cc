@@ -0,0 +1,222 @@
+// Copyright 2023-2024 FAR AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "envpool/sokoban/sokoban_world.h"
+
+#include <array>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+namespace sokoban {
+
+namespace {
+
+// Per-cell-code properties, indexed by kWall..kPlayerOnTarget.
+constexpr std::array<bool, kMaxLevelObject + 1> kIsTarget{
+    false, false, true, true, false, false, true};
+constexpr std::array<bool, kMaxLevelObject + 1> kIsFloor{
+    false, true, true, false, false, false, false};
+constexpr std::array<bool, kMaxLevelObject + 1> kIsBox{
+    false, false, false, true, true, false, false};
+
+// kTinyColors with the three channels packed as 0x00BBGGRR, so rendering a
+// cell is one table load.
+constexpr std::array<uint32_t, kMaxLevelObject + 1> kTinyColors{
+    0x000000,  // WALL
+    0xEEF8F3,  // EMPTY
+    0x7D7EFE,  // TARGET
+    0x385FFE,  // BOX_ON_TARGET
+    0x38798E,  // BOX
+    0x38D4A0,  // PLAYER
+    0x38D4DB,  // PLAYER_ON_TARGET
+};
+
+}  // namespace
+
+ObsMode ParseObsMode(const std::string& obs_mode) {
+  if (obs_mode == "rgb") {
+    return ObsMode::kRgb;
+  }
+  if (obs_mode == "index") {
+    return ObsMode::kIndex;
+  }
+  if (obs_mode == "onehot") {
+    return ObsMode::kOneHot;
+  }
+  std::stringstream msg;
+  msg << "Unknown obs_mode '" << obs_mode
+      << "', expected 'rgb', 'index' or 'onehot'." << std::endl;
+  throw std::runtime_error(msg.str());
+}
+
+std::vector<int> ObsShape(ObsMode obs_mode, int dim_room) {
+  switch (obs_mode) {
+    case ObsMode::kIndex:
+      return {dim_room, dim_room};
+    case ObsMode::kOneHot:
+      return {kMaxLevelObject + 1, (dim_room * dim_room + 7) / 8};
+    case ObsMode::kRgb:
+    default:
+      return {3, dim_room, dim_room};
+  }
+}
+
+void LoadGrid(const SokobanLevel& level, int dim_room, uint8_t* cells,
+              int* player, int* unmatched_boxes) {
+  if (level.size() != static_cast<std::size_t>(dim_room * dim_room)) {
+    std::stringstream msg;
+    msg << "Loaded level is not dim_room x dim_room. level.size()="
+        << level.size() << ", dim_room=" << dim_room << std::endl;
+    throw std::runtime_error(msg.str());
+  }
+  const int stride = dim_room + 2;
+  *unmatched_boxes = 0;
+  for (int y = 0; y < dim_room; y++) {
+    for (int x = 0; x < dim_room; x++) {
+      const uint8_t cell = level[x + y * dim_room];
+      if (cell > kMaxLevelObject) {
+        throw std::runtime_error("Level has an invalid cell code.");
+      }
+      const int index = (x + 1) + (y + 1) * stride;
+      cells[index] = cell;
+      if (cell == kPlayer) {
+        *player = index;
+      } else if (cell == kBox) {
+        ++*unmatched_boxes;
+      }
+    }
+  }
+}
+
+void StepGrid(int action, int stride, uint8_t* cells, int* player,
+              int* unmatched_boxes) {
+  if (action < 0 || action > kMaxAction) {
+    std::stringstream msg;
+    msg << "Sokoban action " << action << " is out of range [0, "
+        << kMaxAction << "]." << std::endl;
+    throw std::out_of_range(msg.str());
+  }
+  const std::array<int, kMaxAction + 1> deltas{-stride, stride, -1, 1};
+  const int delta = deltas[action];
+  const int from = *player;
+  const int next = from + delta;
+  const uint8_t next_cell = cells[next];
+  if (kIsBox[next_cell]) {
+    // Boxes are never on the border, so the cell behind one is in bounds.
+    const int behind = next + delta;
+    const uint8_t behind_cell = cells[behind];
+    if (!kIsFloor[behind_cell]) {
+      return;
+    }
+    cells[behind] = kIsTarget[behind_cell] ? kBoxOnTarget : kBox;
+    *unmatched_boxes += static_cast<int>(kIsTarget[next_cell]) -
+                        static_cast<int>(kIsTarget[behind_cell]);
+  } else if (!kIsFloor[next_cell]) {
+    return;
+  }
+  cells[from] = kIsTarget[cells[from]] ? kTarget : kEmpty;
+  cells[next] = kIsTarget[next_cell] ? kPlayerOnTarget : kPlayer;
+  *player = next;
+}
+
+void RenderGrid(ObsMode obs_mode, const uint8_t* cells, int dim_room,
+                uint8_t* out) {
+  const int stride = dim_room + 2;
+  const uint8_t* row = cells + stride + 1;
+  switch (obs_mode) {
+    case ObsMode::kIndex:
+      for (int y = 0; y < dim_room; y++) {
+        std::memcpy(out + y * dim_room, row, dim_room);
+        row += stride;
+      }
+      break;
+    case ObsMode::kOneHot: {
+      const int plane = (dim_room * dim_room + 7) / 8;
+      std::memset(out, 0, plane * (kMaxLevelObject + 1));
+      int i = 0;
+      for (int y = 0; y < dim_room; y++) {
+        for (int x = 0; x < dim_room; x++, i++) {
+          out[row[x] * plane + i / 8] |= static_cast<uint8_t>(1 << (i % 8));
+        }
+        row += stride;
+      }
+      break;
+    }
+    case ObsMode::kRgb:
+    default: {
+      const int plane = dim_room * dim_room;
+      for (int y = 0; y < dim_room; y++) {
+        for (int x = 0; x < dim_room; x++) {
+          const uint32_t color = kTinyColors[row[x]];
+          out[x] = static_cast<uint8_t>(color);
+          out[plane + x] = static_cast<uint8_t>(color >> 8);
+          out[2 * plane + x] = static_cast<uint8_t>(color >> 16);
+        }
+        row += stride;
+        out += dim_room;
+      }
+      break;
+    }
+  }
+}
+
+SokobanWorld::SokobanWorld(int dim_room)
+    : dim_room_(dim_room),
+      stride_(dim_room + 2),
+      cells_(static_cast<std::size_t>(stride_ * stride_), kWall) {}
+
+void SokobanWorld::Load(const SokobanLevel& level) {
+  LoadGrid(level, dim_room_, cells_.data(), &player_, &unmatched_boxes_);
+}
+
+void SokobanWorld::Step(int action) {
+  StepGrid(action, stride_, cells_.data(), &player_, &unmatched_boxes_);
+}
+
+void SokobanWorld::Render(ObsMode obs_mode, uint8_t* out) const {
+  RenderGrid(obs_mode, cells_.data(), dim_room_, out);
+}
+
+void SokobanWorld::Serialize(ByteWriter* writer) const {
+  writer->Write(PlayerX());
+  writer->Write(PlayerY());
+  writer->Write(unmatched_boxes_);
+  for (int y = 0; y < dim_room_; y++) {
+    writer->WriteArray(&cells_[Index(0, y)], dim_room_);
+  }
+}
+
+void SokobanWorld::Deserialize(ByteReader* reader) {
+  const int player_x = reader->Read<int>();
+  const int player_y = reader->Read<int>();
+  reader->Read(&unmatched_boxes_);
+  for (int y = 0; y < dim_room_; y++) {
+    reader->ReadArray(&cells_[Index(0, y)], dim_room_);
+  }
+  if (player_x < 0 || player_x >= dim_room_ || player_y < 0 ||
+      player_y >= dim_room_) {
+    throw std::runtime_error("Snapshot has the player out of the room.");
+  }
+  for (int y = 0; y < dim_room_; y++) {
+    for (int x = 0; x < dim_room_; x++) {
+      if (At(x, y) > kMaxLevelObject) {
+        throw std::runtime_error("Snapshot has an invalid cell code.");
+      }
+    }
+  }
+  player_ = Index(player_x, player_y);
+}
+
+}  // namespace sokoban
@@ -0,0 +1,103 @@
+/*
+ * Copyright 2023-2024 FAR AI
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ENVPOOL_SOKOBAN_SOKOBAN_WORLD_H_
+#define ENVPOOL_SOKOBAN_SOKOBAN_WORLD_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "envpool/core/serialization.h"
+#include "envpool/sokoban/level_loader.h"
+
+namespace sokoban {
+
+constexpr int kActPushUp = 0;
+constexpr int kActPushDown = 1;
+constexpr int kActPushLeft = 2;
+constexpr int kActPushRight = 3;
+constexpr int kMaxAction = kActPushRight;
+
+/**
+ * Observation layouts, selected with the `obs_mode` config:
+ *   "rgb":    3 x dim_room x dim_room colors (default).
+ *   "index":  dim_room x dim_room cell codes, kWall..kPlayerOnTarget.
+ *   "onehot": one bit plane per cell code, 7 x ceil(dim_room^2 / 8) bytes.
+ *             Cell `i = x + y * dim_room` is bit `i % 8` of byte `i / 8` of
+ *             its plane, as read by `np.unpackbits(..., bitorder="little")`.
+ */
+enum class ObsMode { kRgb, kIndex, kOneHot };
+
+ObsMode ParseObsMode(const std::string& obs_mode);
+std::vector<int> ObsShape(ObsMode obs_mode, int dim_room);
+
+/**
+ * Kernels on one padded grid: row-major cells with row stride `dim_room + 2`
+ * and a one-cell wall border, the player and boxes given as cell indices.
+ * `SokobanWorld` owns one such grid; `SokobanBatchEnvPool` packs one per env
+ * into a single buffer.
+ */
+// Copies `level` into the grid interior and locates the player and the
+// unmatched boxes. The border is left untouched.
+void LoadGrid(const SokobanLevel& level, int dim_room, uint8_t* cells,
+              int* player, int* unmatched_boxes);
+// Moves the player in direction `action`, pushing a box if the cell behind it
+// is free. Throws std::out_of_range if `action` is not in [0, kMaxAction].
+void StepGrid(int action, int stride, uint8_t* cells, int* player,
+              int* unmatched_boxes);
+// Writes the observation in `ObsShape(obs_mode, dim_room)` layout to `out`.
+void RenderGrid(ObsMode obs_mode, const uint8_t* cells, int dim_room,
+                uint8_t* out);
+
+/**
+ * Game state of one Sokoban level. Cells are stored row-major with a one-cell
+ * wall border, so the neighbours of the player and the cell behind a box are
+ * always in bounds and `Step` needs no range checks. Nothing here allocates
+ * after `Load`.
+ */
+class SokobanWorld {
+ protected:
+  int dim_room_, stride_;
+  std::vector<uint8_t> cells_;
+  int player_{0};
+  int unmatched_boxes_{0};
+
+  [[nodiscard]] int Index(int x, int y) const {
+    return (x + 1) + (y + 1) * stride_;
+  }
+
+ public:
+  explicit SokobanWorld(int dim_room);
+
+  // See `LoadGrid`, `StepGrid` and `RenderGrid`.
+  void Load(const SokobanLevel& level);
+  void Step(int action);
+  void Render(ObsMode obs_mode, uint8_t* out) const;
+
+  [[nodiscard]] uint8_t At(int x, int y) const { return cells_[Index(x, y)]; }
+  [[nodiscard]] int DimRoom() const { return dim_room_; }
+  [[nodiscard]] int PlayerX() const { return player_ % stride_ - 1; }
+  [[nodiscard]] int PlayerY() const { return player_ / stride_ - 1; }
+  [[nodiscard]] int UnmatchedBoxes() const { return unmatched_boxes_; }
+
+  void Serialize(ByteWriter* writer) const;
+  void Deserialize(ByteReader* reader);
+};
+
+}  // namespace sokoban
+
+#endif  // ENVPOOL_SOKOBAN_SOKOBAN_WORLD_H_
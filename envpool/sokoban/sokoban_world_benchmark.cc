@@ -0,0 +1,61 @@
+// Copyright 2023-2024 FAR AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures the per-step cost of `SokobanWorld::Step` plus RGB rendering,
+// i.e. the game logic of `SokobanEnv::Step` without the envpool machinery.
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "envpool/sokoban/level_loader.h"
+#include "envpool/sokoban/sokoban_world.h"
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    std::cout << "Usage: " << argv[0] << " levels_dir [num_steps]" << std::endl;
+    return 1;
+  }
+  const int dim_room = 10;
+  const int episode_steps = 120;
+  const int64_t num_steps = argc > 2 ? std::stoll(argv[2]) : 10000000;
+
+  sokoban::LevelLoader loader(argv[1], false, -1);
+  std::mt19937 gen(0);
+  sokoban::SokobanWorld world(dim_room);
+  std::vector<uint8_t> obs(3 * dim_room * dim_room);
+  std::vector<int> actions(4096);
+  for (auto& action : actions) {
+    action = static_cast<int>(gen() % (sokoban::kMaxAction + 1));
+  }
+
+  int64_t checksum = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int64_t i = 0; i < num_steps; i++) {
+    if (i % episode_steps == 0) {
+      world.Load(loader.GetLevel(gen).data);
+    }
+    world.Step(actions[i % actions.size()]);
+    world.Render(sokoban::ObsMode::kRgb, obs.data());
+    checksum += world.UnmatchedBoxes() + obs[i % obs.size()];
+  }
+  std::chrono::duration<double, std::nano> elapsed =
+      std::chrono::steady_clock::now() - start;
+  std::cout << "ns/step: " << elapsed.count() / static_cast<double>(num_steps)
+            << " (checksum " << checksum << ")" << std::endl;
+  return 0;
+}
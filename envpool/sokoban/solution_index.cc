@@ -0,0 +1,172 @@
+// Copyright 2023-2024 FAR AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "envpool/sokoban/solution_index.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+
+namespace sokoban {
+
+static_assert(sizeof(SolutionIndexHeader) == 32,
+              "SolutionIndexHeader must not have padding");
+static_assert(sizeof(SolutionIndexEntry) == 16,
+              "SolutionIndexEntry must not have padding");
+
+SolutionIndex::SolutionIndex(const std::filesystem::path& path) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    std::stringstream msg;
+    msg << "Could not open solution index " << path << std::endl;
+    throw std::runtime_error(msg.str());
+  }
+  struct stat st {};
+  if (fstat(fd, &st) != 0 ||
+      static_cast<std::size_t>(st.st_size) < sizeof(SolutionIndexHeader)) {
+    close(fd);
+    std::stringstream msg;
+    msg << "Solution index " << path << " is too small." << std::endl;
+    throw std::runtime_error(msg.str());
+  }
+  map_size_ = static_cast<std::size_t>(st.st_size);
+  map_ = mmap(nullptr, map_size_, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (map_ == MAP_FAILED) {
+    map_ = nullptr;
+    std::stringstream msg;
+    msg << "Could not mmap solution index " << path << std::endl;
+    throw std::runtime_error(msg.str());
+  }
+
+  const auto* base = static_cast<const uint8_t*>(map_);
+  header_ = reinterpret_cast<const SolutionIndexHeader*>(base);
+  std::stringstream msg;
+  if (std::memcmp(header_->magic, kSolutionIndexMagic,
+                  sizeof(kSolutionIndexMagic)) != 0) {
+    msg << "File " << path << " is not a solution index.";
+  } else if (header_->version != kSolutionIndexVersion) {
+    msg << "Solution index " << path << " has version " << header_->version
+        << ", expected " << kSolutionIndexVersion << ".";
+  } else if (map_size_ != sizeof(SolutionIndexHeader) +
+                              header_->num_levels * sizeof(SolutionIndexEntry) +
+                              header_->num_actions) {
+    msg << "Solution index " << path << " is truncated.";
+  }
+  if (!msg.str().empty()) {
+    munmap(map_, map_size_);
+    map_ = nullptr;
+    throw std::runtime_error(msg.str());
+  }
+  entries_ = reinterpret_cast<const SolutionIndexEntry*>(
+      base + sizeof(SolutionIndexHeader));
+  actions_ = reinterpret_cast<const uint8_t*>(entries_ + header_->num_levels);
+}
+
+SolutionIndex::~SolutionIndex() {
+  if (map_ != nullptr) {
+    munmap(map_, map_size_);
+  }
+}
+
+std::shared_ptr<const SolutionIndex> SolutionIndex::Open(
+    const std::filesystem::path& path) {
+  static std::mutex mutex;
+  static std::map<std::string, std::weak_ptr<const SolutionIndex>> cache;
+
+  std::string key = std::filesystem::canonical(path).string();
+  std::lock_guard<std::mutex> lock(mutex);
+  auto index = cache[key].lock();
+  if (index == nullptr) {
+    index = std::shared_ptr<const SolutionIndex>(new SolutionIndex(key));
+    cache[key] = index;
+  }
+  return index;
+}
+
+SolutionIndex::Solution SolutionIndex::Find(int file_idx,
+                                            int level_idx) const {
+  const SolutionIndexEntry* end = entries_ + Size();
+  const SolutionIndexEntry* it = std::lower_bound(
+      entries_, end, std::make_pair(file_idx, level_idx),
+      [](const SolutionIndexEntry& entry, const std::pair<int, int>& key) {
+        return std::tie(entry.file_idx, entry.level_idx) <
+               std::tie(key.first, key.second);
+      });
+  Solution solution;
+  if (it != end && it->file_idx == file_idx && it->level_idx == level_idx &&
+      it->length >= 0) {
+    solution.actions = actions_ + it->offset;
+    solution.length = it->length;
+  }
+  return solution;
+}
+
+void WriteSolutionIndex(const std::filesystem::path& path,
+                        std::vector<TaggedSolution> solutions) {
+  std::sort(solutions.begin(), solutions.end(),
+            [](const TaggedSolution& a, const TaggedSolution& b) {
+              return std::tie(a.file_idx, a.level_idx) <
+                     std::tie(b.file_idx, b.level_idx);
+            });
+  SolutionIndexHeader header{};
+  std::memcpy(header.magic, kSolutionIndexMagic, sizeof(kSolutionIndexMagic));
+  header.version = kSolutionIndexVersion;
+  header.num_levels = solutions.size();
+
+  std::vector<SolutionIndexEntry> entries;
+  entries.reserve(solutions.size());
+  std::vector<uint8_t> actions;
+  for (const auto& solution : solutions) {
+    if (actions.size() + solution.actions.size() >
+        std::numeric_limits<uint32_t>::max()) {
+      throw std::runtime_error("Solution index exceeds 4GiB of actions.");
+    }
+    entries.push_back(SolutionIndexEntry{
+        solution.file_idx, solution.level_idx,
+        static_cast<uint32_t>(actions.size()),
+        solution.solved ? static_cast<int32_t>(solution.actions.size())
+                        : -1});
+    actions.insert(actions.end(), solution.actions.begin(),
+                   solution.actions.end());
+  }
+  header.num_actions = actions.size();
+
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  out.write(reinterpret_cast<const char*>(entries.data()),
+            static_cast<std::streamsize>(entries.size() *
+                                         sizeof(SolutionIndexEntry)));
+  out.write(reinterpret_cast<const char*>(actions.data()),
+            static_cast<std::streamsize>(actions.size()));
+  if (!out) {
+    std::stringstream msg;
+    msg << "Could not write solution index " << path << std::endl;
+    throw std::runtime_error(msg.str());
+  }
+}
+
+}  // namespace sokoban
@@ -0,0 +1,102 @@
+/*
+ * Copyright 2023-2024 FAR AI
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ENVPOOL_SOKOBAN_SOLUTION_INDEX_H_
+#define ENVPOOL_SOKOBAN_SOLUTION_INDEX_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+namespace sokoban {
+
+/**
+ * Optimal solutions keyed by level, written by `convert_solutions`. Layout
+ * (little endian):
+ *
+ *   SolutionIndexHeader
+ *   SolutionIndexEntry               x num_levels, sorted by (file, level)
+ *   uint8_t actions[num_actions]     env actions (`kActPushUp`...)
+ */
+struct SolutionIndexHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t reserved;
+  uint64_t num_levels;
+  uint64_t num_actions;
+};
+
+struct SolutionIndexEntry {
+  int32_t file_idx;
+  int32_t level_idx;
+  // Offset of the first action in the action block, and the solution length,
+  // which is -1 if the level was not solved.
+  uint32_t offset;
+  int32_t length;
+};
+
+constexpr char kSolutionIndexMagic[8] = {'S', 'O', 'K', 'O',
+                                         'S', 'O', 'L', '\0'};
+constexpr uint32_t kSolutionIndexVersion = 1;
+
+struct TaggedSolution {
+  int file_idx, level_idx;
+  bool solved;
+  std::vector<uint8_t> actions;
+};
+
+/**
+ * Read-only view of a solution index. Like `BinaryLevelFile`, the file is
+ * mmap'ed once per process and shared by every env opened on the same path;
+ * `Find` is a binary search over the entries.
+ */
+class SolutionIndex {
+ protected:
+  void* map_{nullptr};
+  std::size_t map_size_{0};
+  const SolutionIndexHeader* header_{nullptr};
+  const SolutionIndexEntry* entries_{nullptr};
+  const uint8_t* actions_{nullptr};
+
+  explicit SolutionIndex(const std::filesystem::path& path);
+
+ public:
+  struct Solution {
+    // Null if the level is not in the index.
+    const uint8_t* actions{nullptr};
+    int length{-1};
+  };
+
+  ~SolutionIndex();
+  SolutionIndex(const SolutionIndex&) = delete;
+  SolutionIndex& operator=(const SolutionIndex&) = delete;
+
+  static std::shared_ptr<const SolutionIndex> Open(
+      const std::filesystem::path& path);
+
+  [[nodiscard]] std::size_t Size() const { return header_->num_levels; }
+  [[nodiscard]] Solution Find(int file_idx, int level_idx) const;
+};
+
+// Writes `solutions` in the index format; their order does not matter.
+void WriteSolutionIndex(const std::filesystem::path& path,
+                        std::vector<TaggedSolution> solutions);
+
+}  // namespace sokoban
+
+#endif  // ENVPOOL_SOKOBAN_SOLUTION_INDEX_H_
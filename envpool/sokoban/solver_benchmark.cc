@@ -0,0 +1,122 @@
+// Copyright 2023-2024 FAR AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Compares `AStarSearch<SokobanNode>` (as used by `astar_log`) with
+// `SokobanSolver`, in step and push mode, on every level of a level file or
+// directory.
+
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "envpool/sokoban/level_loader.h"
+#include "envpool/sokoban/sokoban_node.h"
+#include "envpool/sokoban/sokoban_solver.h"
+
+namespace sokoban {
+
+struct Timed {
+  int solution_length{-1};
+  int64_t search_steps{0};
+  double ms{0};
+};
+
+Timed RunAStarStl(int dim_room, const SokobanLevel& level, int fsa_limit) {
+  auto start = std::chrono::steady_clock::now();
+  std::AStarSearch<SokobanNode> astarsearch(fsa_limit);
+  SokobanNode node_start(dim_room, level, false);
+  SokobanNode node_end(dim_room, level, true);
+  astarsearch.SetStartAndGoalStates(node_start, node_end);
+  unsigned int search_state;
+  do {
+    search_state = astarsearch.SearchStep();
+  } while (search_state ==
+           std::AStarSearch<SokobanNode>::SEARCH_STATE_SEARCHING);
+  Timed out;
+  out.search_steps = astarsearch.GetStepCount();
+  if (search_state == std::AStarSearch<SokobanNode>::SEARCH_STATE_SUCCEEDED) {
+    out.solution_length = 0;
+    astarsearch.GetSolutionStart();
+    while (astarsearch.GetSolutionNext() != nullptr) {
+      out.solution_length++;
+    }
+    astarsearch.FreeSolutionNodes();
+  }
+  astarsearch.EnsureMemoryFreed();
+  out.ms = std::chrono::duration<double, std::milli>(
+               std::chrono::steady_clock::now() - start)
+               .count();
+  return out;
+}
+
+Timed RunSolver(int dim_room, const SokobanLevel& level, int max_nodes,
+                bool pushes) {
+  auto start = std::chrono::steady_clock::now();
+  SokobanSolver solver(dim_room, level);
+  SolveResult result =
+      pushes ? solver.SolvePushes(max_nodes) : solver.Solve(max_nodes);
+  Timed out;
+  out.search_steps = result.search_steps;
+  if (result.status == SolveStatus::kSolved) {
+    out.solution_length = static_cast<int>(result.actions.size());
+  }
+  out.ms = std::chrono::duration<double, std::milli>(
+               std::chrono::steady_clock::now() - start)
+               .count();
+  return out;
+}
+
+}  // namespace sokoban
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    std::cout << "Usage: " << argv[0] << " levels_dir_or_file [node_limit]"
+              << std::endl;
+    return 1;
+  }
+  const int dim_room = 10;
+  const int node_limit = argc > 2 ? std::stoi(argv[2]) : 1000000;
+  double total_stl_ms = 0;
+  double total_solver_ms = 0;
+  double total_push_ms = 0;
+  bool all_match = true;
+  std::cout << "file,level,length,stl_steps,stl_ms,solver_steps,solver_ms,"
+               "push_steps,push_ms"
+            << std::endl;
+  for (const auto& path : sokoban::ListLevelFiles(argv[1])) {
+    std::vector<sokoban::SokobanLevel> levels = sokoban::ReadLevelFile(path);
+    for (std::size_t i = 0; i < levels.size(); i++) {
+      auto stl = sokoban::RunAStarStl(dim_room, levels[i], node_limit);
+      auto solver =
+          sokoban::RunSolver(dim_room, levels[i], node_limit, false);
+      auto push = sokoban::RunSolver(dim_room, levels[i], node_limit, true);
+      all_match = all_match && stl.solution_length == solver.solution_length &&
+                  stl.solution_length == push.solution_length;
+      total_stl_ms += stl.ms;
+      total_solver_ms += solver.ms;
+      total_push_ms += push.ms;
+      std::cout << path.filename().string() << "," << i << ","
+                << solver.solution_length << "," << stl.search_steps << ","
+                << stl.ms << "," << solver.search_steps << "," << solver.ms
+                << "," << push.search_steps << "," << push.ms << std::endl;
+    }
+  }
+  std::cout << "total_ms: astar_stl=" << total_stl_ms
+            << " solver=" << total_solver_ms << " push=" << total_push_ms
+            << " solution lengths match: " << (all_match ? "yes" : "no")
+            << std::endl;
+  return all_match ? 0 : 1;
+}